@@ -14,6 +14,18 @@ real::Texture2D* real::ContentManager::LoadTexture(const GameContext& context, c
 	return m_Images.at(path).get();
 }
 
+real::Texture2DArray* real::ContentManager::LoadTextureArray(const GameContext& context, const std::string& path, uint32_t tileWidth,
+	uint32_t tileHeight)
+{
+	if (m_ImageArrays.contains(path))
+	{
+		return m_ImageArrays.at(path).get();
+	}
+
+	m_ImageArrays.emplace(path, std::make_unique<Texture2DArray>(path, context, tileWidth, tileHeight));
+	return m_ImageArrays.at(path).get();
+}
+
 real::Model* real::ContentManager::LoadModel(const std::string& path, const glm::vec3& pos)
 {
 	if (m_Models.contains(path))
@@ -32,6 +44,12 @@ void real::ContentManager::CleanUp(const GameContext& context)
 		texture->CleanUp(context);
 	}
 
+	for (const auto& texture : m_ImageArrays | std::views::values)
+	{
+		texture->CleanUp(context);
+	}
+
 	m_Images.clear();
+	m_ImageArrays.clear();
 	m_Models.clear();
 }
@@ -8,6 +8,7 @@
 
 #include "Model.h"
 #include "Texture2D.h"
+#include "Texture2DArray.h"
 #include "Util/Structs.h"
 
 namespace real
@@ -19,6 +20,7 @@ namespace real
 
 		Model* LoadModel(const std::string& path, const glm::vec3& pos);
 		Texture2D* LoadTexture(const GameContext& context, const std::string& path);
+		Texture2DArray* LoadTextureArray(const GameContext& context, const std::string& path, uint32_t tileWidth, uint32_t tileHeight);
 
 		void CleanUp(const GameContext& context);
 
@@ -27,6 +29,7 @@ namespace real
 		ContentManager() = default;
 
 		std::map<std::string, std::unique_ptr<Texture2D>> m_Images;
+		std::map<std::string, std::unique_ptr<Texture2DArray>> m_ImageArrays;
 		std::map<std::string, std::unique_ptr<Model>> m_Models;
 
 		//template<typename T, typename... Args>
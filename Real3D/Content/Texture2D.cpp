@@ -4,7 +4,7 @@
 
 #include <SDL_image.h>
 
-#include "Core/CommandBuffers/CommandBuffer.h"
+#include "Core/UploadManager.h"
 #include "Util/VulkanUtil.h"
 
 real::Texture2D::Texture2D(const std::string& path, const GameContext& context)
@@ -19,7 +19,7 @@ void real::Texture2D::CleanUp(const GameContext& context) const
     vkDestroySampler(context.vulkanContext.device, m_TextureSampler, nullptr);
     vkDestroyImageView(context.vulkanContext.device, m_TextureImageView, nullptr);
 
-    vmaDestroyImage(context.vulkanContext.allocator, m_TextureImage, m_TextureAllocation);
+    DestroyImage(context.vulkanContext.allocator, m_TextureImage, m_TextureAllocation);
 
     //vkDestroyImage(context.vulkanContext.device, m_TextureImage, nullptr);
     //vkFreeMemory(context.vulkanContext.device, m_TextureImageMemory, nullptr);
@@ -45,37 +45,14 @@ void real::Texture2D::CreateTextureImage(const GameContext& context, const std::
     const int texChannels = convertedSurface->format->BytesPerPixel;
     const VkDeviceSize imageSize = m_TextureWidth * m_TextureHeight * texChannels;
 
-    VkBuffer stagingBuffer;
-    VmaAllocation stagingBufferAllocation;
-    //VkDeviceMemory stagingBufferMemory;
-
-    CreateBuffer(context, imageSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer,
-        stagingBufferAllocation);
-
-    void* data;
-    vmaMapMemory(context.vulkanContext.allocator, stagingBufferAllocation, &data);
-    memcpy(data, convertedSurface->pixels, imageSize);
-    vmaUnmapMemory(context.vulkanContext.allocator, stagingBufferAllocation);
-
-    //void* data;
-    //vkMapMemory(context.vulkanContext.device, stagingBufferMemory, 0, imageSize, 0, &data);
-    //memcpy(data, convertedSurface->pixels, imageSize);
-    //vkUnmapMemory(context.vulkanContext.device, stagingBufferMemory);
-
-    SDL_FreeSurface(convertedSurface);
-
     CreateImage(context, m_TextureWidth, m_TextureHeight, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_TILING_OPTIMAL,
         VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-        m_TextureImage, m_TextureAllocation);
+        m_TextureImage, m_TextureAllocation, 1, 1, EMemoryCategory::texture);
 
-    TransitionImageLayout(context, m_TextureImage, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-    CopyBufferToImage(context, stagingBuffer, m_TextureImage, static_cast<uint32_t>(m_TextureWidth), static_cast<uint32_t>(m_TextureHeight));
-    TransitionImageLayout(context, m_TextureImage, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    UploadManager::GetInstance().UploadImage(m_TextureImage, convertedSurface->pixels, imageSize,
+        static_cast<uint32_t>(m_TextureWidth), static_cast<uint32_t>(m_TextureHeight));
 
-    vmaDestroyBuffer(context.vulkanContext.allocator, stagingBuffer, stagingBufferAllocation);
-    //vkDestroyBuffer(context.vulkanContext.device, stagingBuffer, nullptr);
-    //vkFreeMemory(context.vulkanContext.device, stagingBufferMemory, nullptr);
+    SDL_FreeSurface(convertedSurface);
 }
 
 void real::Texture2D::CreateTextureImageView(const GameContext& context)
@@ -110,88 +87,3 @@ void real::Texture2D::CreateTextureSampler(const GameContext& context)
         throw std::runtime_error("failed to create texture sampler!");
     }
 }
-
-void real::Texture2D::TransitionImageLayout(const GameContext& context, VkImage image, VkFormat format,
-	VkImageLayout oldLayout, VkImageLayout newLayout)
-{
-    const VkCommandBuffer commandBuffer = CommandBuffer::StartSingleTimeCommands(context);
-
-    VkImageMemoryBarrier barrier{};
-    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-    barrier.oldLayout = oldLayout;
-    barrier.newLayout = newLayout;
-    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier.image = image;
-    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    barrier.subresourceRange.baseMipLevel = 0;
-    barrier.subresourceRange.levelCount = 1;
-    barrier.subresourceRange.baseArrayLayer = 0;
-    barrier.subresourceRange.layerCount = 1;
-
-    VkPipelineStageFlags sourceStage;
-    VkPipelineStageFlags destinationStage;
-
-    if (oldLayout == VK_IMAGE_LAYOUT_UNDEFINED && newLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL) {
-        barrier.srcAccessMask = 0;
-        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-
-        sourceStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-        destinationStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-    }
-    else if (oldLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL && newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL) {
-        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-
-        sourceStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-        destinationStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-    }
-    else {
-        throw std::invalid_argument("unsupported layout transition!");
-    }
-
-    vkCmdPipelineBarrier(
-        commandBuffer,
-        sourceStage, destinationStage,
-        0,
-        0, nullptr,
-        0, nullptr,
-        1, &barrier
-    );
-
-    CommandBuffer::StopSingleTimeCommands(context, commandBuffer);
-}
-
-void real::Texture2D::CopyBufferToImage(const GameContext& context, VkBuffer buffer, VkImage image, uint32_t width,
-	uint32_t height)
-{
-    const VkCommandBuffer commandBuffer = CommandBuffer::StartSingleTimeCommands(context);
-
-    VkBufferImageCopy region{};
-    region.bufferOffset = 0;
-    region.bufferRowLength = 0;
-    region.bufferImageHeight = 0;
-
-    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    region.imageSubresource.mipLevel = 0;
-    region.imageSubresource.baseArrayLayer = 0;
-    region.imageSubresource.layerCount = 1;
-
-    region.imageOffset = { 0, 0, 0 };
-    region.imageExtent = {
-        width,
-        height,
-        1
-    };
-
-    vkCmdCopyBufferToImage(
-        commandBuffer,
-        buffer,
-        image,
-        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-        1,
-        &region
-    );
-
-    CommandBuffer::StopSingleTimeCommands(context, commandBuffer);
-}
@@ -42,9 +42,6 @@ namespace real
 		void CreateTextureImage(const GameContext& context, const std::string& path);
 		void CreateTextureImageView(const GameContext& context);
 		void CreateTextureSampler(const GameContext& context);
-
-		static void TransitionImageLayout(const GameContext& context, VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout);
-		static void CopyBufferToImage(const GameContext& context, VkBuffer buffer, VkImage image, uint32_t width, uint32_t height);
 	};
 }
 
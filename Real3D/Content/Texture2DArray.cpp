@@ -0,0 +1,125 @@
+#include "Texture2DArray.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include <SDL_image.h>
+
+#include "Core/UploadManager.h"
+#include "Util/VulkanUtil.h"
+
+real::Texture2DArray::Texture2DArray(const std::string& path, const GameContext& context, uint32_t tileWidth, uint32_t tileHeight)
+    : m_TileWidth(tileWidth)
+    , m_TileHeight(tileHeight)
+{
+    CreateTextureImage(context, path);
+    CreateTextureImageView(context);
+    CreateTextureSampler(context);
+}
+
+void real::Texture2DArray::CleanUp(const GameContext& context) const
+{
+    vkDestroySampler(context.vulkanContext.device, m_TextureSampler, nullptr);
+    vkDestroyImageView(context.vulkanContext.device, m_TextureImageView, nullptr);
+
+    DestroyImage(context.vulkanContext.allocator, m_TextureImage, m_TextureAllocation);
+}
+
+void real::Texture2DArray::CreateTextureImage(const GameContext& context, const std::string& path)
+{
+    // The mips are blitted with linear filtering
+    VkFormatProperties formatProperties;
+    vkGetPhysicalDeviceFormatProperties(context.vulkanContext.physicalDevice, format, &formatProperties);
+    if ((formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT) == 0)
+    {
+        throw std::runtime_error("texture image format does not support linear blitting!");
+    }
+
+    SDL_Surface* surface = IMG_Load(path.c_str());
+    if (!surface) {
+        throw std::runtime_error("failed to load texture image!");
+    }
+
+    SDL_Surface* convertedSurface = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_RGBA32, 0);
+    SDL_FreeSurface(surface);
+
+    if (!convertedSurface) {
+        throw std::runtime_error("failed to convert surface to RGBA format!");
+    }
+
+    const auto tilesX = static_cast<uint32_t>(convertedSurface->w) / m_TileWidth;
+    const auto tilesY = static_cast<uint32_t>(convertedSurface->h) / m_TileHeight;
+    m_LayerCount = tilesX * tilesY;
+    m_MipLevels = static_cast<uint32_t>(std::bit_width(std::max(m_TileWidth, m_TileHeight)));
+
+    if (m_LayerCount == 0)
+    {
+        SDL_FreeSurface(convertedSurface);
+        throw std::runtime_error("texture image is smaller than a single tile!");
+    }
+
+    // Copy every tile into its own tightly packed layer
+    constexpr uint32_t texelSize = 4;
+    const uint32_t tileRowSize = m_TileWidth * texelSize;
+    const auto pPixels = static_cast<const uint8_t*>(convertedSurface->pixels);
+
+    std::vector<uint8_t> layers(static_cast<size_t>(m_LayerCount) * m_TileHeight * tileRowSize);
+    for (uint32_t layer = 0; layer < m_LayerCount; ++layer)
+    {
+        const uint32_t tileX = layer % tilesX;
+        const uint32_t tileY = layer / tilesX;
+
+        for (uint32_t row = 0; row < m_TileHeight; ++row)
+        {
+            const uint8_t* pSrc = pPixels + static_cast<size_t>(tileY * m_TileHeight + row) * convertedSurface->pitch + tileX * tileRowSize;
+            uint8_t* pDst = layers.data() + (static_cast<size_t>(layer) * m_TileHeight + row) * tileRowSize;
+            std::memcpy(pDst, pSrc, tileRowSize);
+        }
+    }
+
+    SDL_FreeSurface(convertedSurface);
+
+    CreateImage(context, m_TileWidth, m_TileHeight, format, VK_IMAGE_TILING_OPTIMAL,
+        VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        m_TextureImage, m_TextureAllocation, m_MipLevels, m_LayerCount, EMemoryCategory::texture);
+
+    UploadManager::GetInstance().UploadImageArray(m_TextureImage, layers.data(), layers.size(),
+        m_TileWidth, m_TileHeight, m_LayerCount, m_MipLevels);
+}
+
+void real::Texture2DArray::CreateTextureImageView(const GameContext& context)
+{
+    m_TextureImageView = CreateImageArrayView(context, m_TextureImage, format, m_MipLevels, m_LayerCount);
+}
+
+void real::Texture2DArray::CreateTextureSampler(const GameContext& context)
+{
+    // Magnified tiles keep their pixels, minified ones blend between the mips
+    VkSamplerCreateInfo samplerInfo{};
+    samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerInfo.magFilter = VK_FILTER_NEAREST;
+    samplerInfo.minFilter = VK_FILTER_LINEAR;
+    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+
+    VkPhysicalDeviceProperties properties{};
+    vkGetPhysicalDeviceProperties(context.vulkanContext.physicalDevice, &properties);
+    samplerInfo.anisotropyEnable = context.anisotropicFiltering ? VK_TRUE : VK_FALSE;
+    samplerInfo.maxAnisotropy = context.anisotropicFiltering ? properties.limits.maxSamplerAnisotropy : 1.0f;
+    samplerInfo.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
+    samplerInfo.unnormalizedCoordinates = VK_FALSE;
+    samplerInfo.compareEnable = VK_FALSE;
+    samplerInfo.compareOp = VK_COMPARE_OP_ALWAYS;
+    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+    samplerInfo.mipLodBias = 0.0f;
+    samplerInfo.minLod = 0.0f;
+    samplerInfo.maxLod = static_cast<float>(m_MipLevels);
+
+    if (vkCreateSampler(context.vulkanContext.device, &samplerInfo, nullptr, &m_TextureSampler) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create texture sampler!");
+    }
+}
@@ -0,0 +1,49 @@
+#ifndef TEXTURE2DARRAY_H
+#define TEXTURE2DARRAY_H
+
+#include <string>
+
+#include <vulkan/vulkan_core.h>
+
+#include "Util/structs.h"
+
+namespace real
+{
+	// Slices an atlas into one layer per tile, row by row, so every tile gets a mip chain of its own without bleeding into its neighbours
+	class Texture2DArray final
+	{
+	public:
+		explicit Texture2DArray(const std::string& path, const GameContext& context, uint32_t tileWidth, uint32_t tileHeight);
+		~Texture2DArray() = default;
+
+		Texture2DArray(const Texture2DArray&) = delete;
+		Texture2DArray& operator=(const Texture2DArray&) = delete;
+		Texture2DArray(Texture2DArray&&) = delete;
+		Texture2DArray& operator=(Texture2DArray&&) = delete;
+
+		void CleanUp(const GameContext& context) const;
+
+		VkImage GetTextureImage() const { return m_TextureImage; }
+		VkImageView GetTextureImageView() const { return m_TextureImageView; }
+		VkSampler GetTextureSampler() const { return m_TextureSampler; }
+
+		uint32_t GetLayerCount() const { return m_LayerCount; }
+		uint32_t GetMipLevels() const { return m_MipLevels; }
+
+	private:
+		uint32_t m_TileWidth{}, m_TileHeight{};
+		uint32_t m_LayerCount{}, m_MipLevels{};
+		VkImage m_TextureImage{};
+		VmaAllocation m_TextureAllocation{};
+		VkImageView m_TextureImageView{};
+		VkSampler m_TextureSampler{};
+
+		static constexpr VkFormat format = VK_FORMAT_R8G8B8A8_SRGB;
+
+		void CreateTextureImage(const GameContext& context, const std::string& path);
+		void CreateTextureImageView(const GameContext& context);
+		void CreateTextureSampler(const GameContext& context);
+	};
+}
+
+#endif // TEXTURE2DARRAY_H
@@ -0,0 +1,64 @@
+#include "CachedCommandBuffer.h"
+
+#include <stdexcept>
+
+#include "Core/CommandPool.h"
+
+real::CachedCommandBuffer::CachedCommandBuffer(const GameContext& context)
+{
+	// Only recorded on the main thread, so they can share the pool of the primary command buffers
+	VkCommandBufferAllocateInfo allocInfo{};
+	allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+	allocInfo.commandPool = CommandPool::GetInstance().GetCommandPool();
+	allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+	allocInfo.commandBufferCount = static_cast<uint32_t>(m_CommandBuffers.size());
+
+	if (vkAllocateCommandBuffers(context.vulkanContext.device, &allocInfo, m_CommandBuffers.data()) != VK_SUCCESS)
+	{
+		throw std::runtime_error("failed to allocate cached command buffers!");
+	}
+}
+
+void real::CachedCommandBuffer::CleanUp(const GameContext& context) const
+{
+	vkFreeCommandBuffers(context.vulkanContext.device, CommandPool::GetInstance().GetCommandPool(),
+		static_cast<uint32_t>(m_CommandBuffers.size()), m_CommandBuffers.data());
+}
+
+void real::CachedCommandBuffer::Invalidate()
+{
+	m_IsValid.fill(false);
+}
+
+VkCommandBuffer real::CachedCommandBuffer::Record(uint32_t frame, VkCommandBufferInheritanceInfo inheritance,
+	const std::function<void(VkCommandBuffer)>& record)
+{
+	const auto commandBuffer = m_CommandBuffers[frame];
+
+	// Every swap chain image has its own frame buffer, the cached commands have to work with all of them
+	inheritance.framebuffer = VK_NULL_HANDLE;
+
+	VkCommandBufferBeginInfo beginInfo{};
+	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+	beginInfo.pInheritanceInfo = &inheritance;
+
+	if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS)
+	{
+		throw std::runtime_error("failed to begin recording cached command buffer!");
+	}
+
+	CommandPool::SetThreadCommandBuffer(commandBuffer);
+	record(commandBuffer);
+	CommandPool::SetThreadCommandBuffer(nullptr);
+
+	if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+	{
+		throw std::runtime_error("failed to record cached command buffer!");
+	}
+
+	m_Subpasses[frame] = inheritance.subpass;
+	m_IsValid[frame] = true;
+
+	return commandBuffer;
+}
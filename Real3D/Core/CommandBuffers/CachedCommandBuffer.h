@@ -0,0 +1,42 @@
+#ifndef CACHEDCOMMANDBUFFER_H
+#define CACHEDCOMMANDBUFFER_H
+
+#include <array>
+#include <functional>
+#include <vulkan/vulkan_core.h>
+
+#include "Util/Structs.h"
+
+namespace real
+{
+	// A secondary command buffer per frame in flight that is kept until its owner invalidates it.
+	// Only the commands are cached, anything that changes every frame has to be read from buffers.
+	class CachedCommandBuffer final
+	{
+	public:
+		explicit CachedCommandBuffer(const GameContext& context);
+		~CachedCommandBuffer() = default;
+
+		CachedCommandBuffer(const CachedCommandBuffer&) = delete;
+		CachedCommandBuffer& operator=(const CachedCommandBuffer&) = delete;
+		CachedCommandBuffer(CachedCommandBuffer&&) = delete;
+		CachedCommandBuffer& operator=(CachedCommandBuffer&&) = delete;
+
+		void CleanUp(const GameContext& context) const;
+
+		void Invalidate();
+		void Invalidate(uint32_t frame) { m_IsValid[frame] = false; }
+		bool IsValid(uint32_t frame, uint32_t subpass) const { return m_IsValid[frame] && m_Subpasses[frame] == subpass; }
+
+		// Must be called on the main thread, after the fence of the frame has been waited on
+		VkCommandBuffer Record(uint32_t frame, VkCommandBufferInheritanceInfo inheritance, const std::function<void(VkCommandBuffer)>& record);
+		VkCommandBuffer GetCommandBuffer(uint32_t frame) const { return m_CommandBuffers[frame]; }
+
+	private:
+		std::array<VkCommandBuffer, MAX_FRAMES_IN_FLIGHT> m_CommandBuffers{};
+		std::array<uint32_t, MAX_FRAMES_IN_FLIGHT> m_Subpasses{};
+		std::array<bool, MAX_FRAMES_IN_FLIGHT> m_IsValid{};
+	};
+}
+
+#endif // CACHEDCOMMANDBUFFER_H
@@ -39,5 +39,8 @@ VkCommandBuffer real::CommandPool::GetCommandBuffer(uint32_t frame) const
 
 VkCommandBuffer real::CommandPool::GetActiveCommandBuffer() const
 {
+	if (m_ThreadCommandBuffer != nullptr)
+		return m_ThreadCommandBuffer;
+
 	return m_pCommandBuffer->GetActiveCommandBuffer();
 }
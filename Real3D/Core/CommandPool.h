@@ -25,6 +25,8 @@ namespace real
 
 		VkCommandBuffer GetCommandBuffer(uint32_t frame) const;
 		VkCommandBuffer GetActiveCommandBuffer() const;
+		// Set while a worker thread records a secondary command buffer, it is the active one on that thread
+		static void SetThreadCommandBuffer(VkCommandBuffer buffer) { m_ThreadCommandBuffer = buffer; }
 
 	private:
 		friend class Singleton<CommandPool>;
@@ -32,6 +34,7 @@ namespace real
 
 		VkCommandPool m_CommandPool{ nullptr };
 		std::unique_ptr<CommandBuffer> m_pCommandBuffer{ nullptr };
+		inline static thread_local VkCommandBuffer m_ThreadCommandBuffer{ nullptr };
 	};
 }
 
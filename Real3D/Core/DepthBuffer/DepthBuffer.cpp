@@ -19,7 +19,13 @@ void real::DepthBuffer::Create(const GameContext& context)
 
 	const auto [width, height] = Renderer::GetInstance().GetSwapChain()->GetExtent();
 
-	CreateImage(context, width, height, depthFormat, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_DepthImage, m_DepthImageAllocation);
+	// With occlusion culling the depth is reduced into the DepthPyramid after the frame
+	VkImageUsageFlags usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+	if (context.occlusionCulling)
+		usage |= VK_IMAGE_USAGE_SAMPLED_BIT;
+
+	CreateImage(context, width, height, depthFormat, VK_IMAGE_TILING_OPTIMAL, usage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_DepthImage, m_DepthImageAllocation,
+		1, 1, EMemoryCategory::renderTarget);
 	m_DepthImageView = CreateImageView(context, m_DepthImage, depthFormat, VK_IMAGE_ASPECT_DEPTH_BIT);
 }
 
@@ -27,7 +33,7 @@ void real::DepthBuffer::CleanUp(const GameContext& context)
 {
 	vkDestroyImageView(context.vulkanContext.device, m_DepthImageView, nullptr);
 
-	vmaDestroyImage(context.vulkanContext.allocator, m_DepthImage, m_DepthImageAllocation);
+	DestroyImage(context.vulkanContext.allocator, m_DepthImage, m_DepthImageAllocation);
 	//vkDestroyImage(context.vulkanContext.device, m_DepthImage, nullptr);
 	//vkFreeMemory(context.vulkanContext.device, m_DepthImageMemory, nullptr);
 }
@@ -56,7 +62,9 @@ VkFormat real::DepthBuffer::FindDepthFormat(const GameContext& context)
 		context,
 		{ VK_FORMAT_D32_SFLOAT, VK_FORMAT_D32_SFLOAT_S8_UINT, VK_FORMAT_D24_UNORM_S8_UINT },
 		VK_IMAGE_TILING_OPTIMAL,
-		VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT
+		context.occlusionCulling
+			? VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT
+			: VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT
 	);
 }
 
@@ -27,14 +27,13 @@ namespace real
 		static VkFormat FindSupportedFormat(const GameContext& context, const std::vector<VkFormat>& candidates,
 											VkImageTiling tiling, VkFormatFeatureFlags features);
 		static VkFormat FindDepthFormat(const GameContext& context);
+		static bool HasStencilComponent(VkFormat format);
 
 	private:
 		VkImage m_DepthImage{};
 		VmaAllocation m_DepthImageAllocation{};
 		//VkDeviceMemory m_DepthImageMemory{};
 		VkImageView m_DepthImageView{};
-
-		static bool HasStencilComponent(VkFormat format);
 	};
 }
 
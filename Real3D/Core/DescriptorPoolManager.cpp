@@ -1,9 +1,73 @@
 #include "DescriptorPoolManager.h"
 
+#include <cstring>
+#include <ranges>
 #include <stdexcept>
 
 #include "RealEngine.h"
 
+namespace
+{
+    // FNV-1a
+    template <typename T>
+    void HashValue(size_t& hash, const T& value)
+    {
+        const auto pBytes = reinterpret_cast<const unsigned char*>(&value);
+        for (size_t i = 0; i < sizeof(T); ++i)
+        {
+            hash ^= pBytes[i];
+            hash *= 1099511628211ull;
+        }
+    }
+}
+
+bool real::DescriptorResource::operator==(const DescriptorResource& other) const
+{
+    // Compared member by member, the image info has padding at its end
+    return binding == other.binding
+        && type == other.type
+        && bufferInfo.buffer == other.bufferInfo.buffer
+        && bufferInfo.offset == other.bufferInfo.offset
+        && bufferInfo.range == other.bufferInfo.range
+        && imageInfo.sampler == other.imageInfo.sampler
+        && imageInfo.imageView == other.imageInfo.imageView
+        && imageInfo.imageLayout == other.imageInfo.imageLayout;
+}
+
+bool real::DescriptorPoolManager::LayoutKey::operator==(const LayoutKey& other) const
+{
+    // The binding struct has no padding, its bytes can be compared
+    return bindings.size() == other.bindings.size()
+        && (bindings.empty() || std::memcmp(bindings.data(), other.bindings.data(), bindings.size() * sizeof(VkDescriptorSetLayoutBinding)) == 0);
+}
+
+size_t real::DescriptorPoolManager::KeyHash::operator()(const LayoutKey& key) const
+{
+    size_t hash = 14695981039346656037ull;
+    for (const auto& binding : key.bindings)
+        HashValue(hash, binding);
+
+    return hash;
+}
+
+size_t real::DescriptorPoolManager::KeyHash::operator()(const SetKey& key) const
+{
+    size_t hash = 14695981039346656037ull;
+    HashValue(hash, key.layout);
+
+    for (const auto& resource : key.resources)
+    {
+        HashValue(hash, resource.binding);
+        HashValue(hash, resource.type);
+        HashValue(hash, resource.bufferInfo);
+        HashValue(hash, resource.imageInfo.sampler);
+        HashValue(hash, resource.imageInfo.imageView);
+        HashValue(hash, resource.imageInfo.imageLayout);
+    }
+
+    return hash;
+}
+
 VkDescriptorSet real::DescriptorPoolManager::AllocateDescriptorSet(VkDescriptorSetLayout layout)
 {
     const auto context = RealEngine::GetGameContext();
@@ -14,6 +78,8 @@ VkDescriptorSet real::DescriptorPoolManager::AllocateDescriptorSet(VkDescriptorS
     allocInfo.descriptorSetCount = 1;
     allocInfo.pSetLayouts = &layout;
 
+    ++m_AllocationCount;
+
     VkDescriptorSet descriptorSet;
     if (vkAllocateDescriptorSets(context.vulkanContext.device, &allocInfo, &descriptorSet) == VK_SUCCESS) 
     {
@@ -40,6 +106,157 @@ void real::DescriptorPoolManager::CleanUp()
         vkDestroyDescriptorPool(context.vulkanContext.device, pool, nullptr);
     }
     m_DescriptorPools.clear();
+
+    for (auto& [pools, current] : m_TransientPools)
+    {
+        for (const auto pool : pools)
+            vkDestroyDescriptorPool(context.vulkanContext.device, pool, nullptr);
+
+        pools.clear();
+        current = 0;
+    }
+
+    for (const auto layout : m_Layouts | std::views::values)
+    {
+        vkDestroyDescriptorSetLayout(context.vulkanContext.device, layout, nullptr);
+    }
+    m_Layouts.clear();
+    m_Sets.clear();
+}
+
+VkDescriptorSetLayout real::DescriptorPoolManager::GetDescriptorSetLayout(std::span<const VkDescriptorSetLayoutBinding> bindings)
+{
+    LayoutKey key{ { bindings.begin(), bindings.end() } };
+    if (const auto it = m_Layouts.find(key); it != m_Layouts.end())
+    {
+        return it->second;
+    }
+
+    const auto context = RealEngine::GetGameContext();
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+    layoutInfo.pBindings = bindings.data();
+
+    VkDescriptorSetLayout layout;
+    if (vkCreateDescriptorSetLayout(context.vulkanContext.device, &layoutInfo, nullptr, &layout) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create descriptor set layout!");
+    }
+
+    m_Layouts.emplace(std::move(key), layout);
+    return layout;
+}
+
+VkDescriptorSet real::DescriptorPoolManager::GetDescriptorSet(VkDescriptorSetLayout layout, std::span<const DescriptorResource> resources)
+{
+    SetKey key{ layout, { resources.begin(), resources.end() } };
+    if (const auto it = m_Sets.find(key); it != m_Sets.end())
+    {
+        ++m_CacheHits;
+        return it->second;
+    }
+
+    ++m_CacheMisses;
+
+    const auto context = RealEngine::GetGameContext();
+    const auto descriptorSet = AllocateDescriptorSet(layout);
+
+    std::vector<VkWriteDescriptorSet> descriptorWrites(resources.size());
+    for (size_t i = 0; i < resources.size(); ++i)
+    {
+        const auto& resource = key.resources[i];
+
+        descriptorWrites[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptorWrites[i].dstSet = descriptorSet;
+        descriptorWrites[i].dstBinding = resource.binding;
+        descriptorWrites[i].dstArrayElement = 0;
+        descriptorWrites[i].descriptorType = resource.type;
+        descriptorWrites[i].descriptorCount = 1;
+
+        switch (resource.type)
+        {
+        case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+        case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+            descriptorWrites[i].pBufferInfo = &resource.bufferInfo;
+            break;
+        default:
+            descriptorWrites[i].pImageInfo = &resource.imageInfo;
+            break;
+        }
+    }
+
+    vkUpdateDescriptorSets(context.vulkanContext.device, static_cast<uint32_t>(descriptorWrites.size()),
+        descriptorWrites.data(), 0, nullptr);
+
+    m_Sets.emplace(std::move(key), descriptorSet);
+    return descriptorSet;
+}
+
+void real::DescriptorPoolManager::BeginFrame(uint32_t frame)
+{
+    const auto context = RealEngine::GetGameContext();
+
+    m_CurrentFrame = frame;
+    m_TransientAllocationCount = 0;
+
+    // Resetting a pool frees every set allocated from it at once
+    auto& [pools, current] = m_TransientPools[frame];
+    for (uint32_t i = 0; i <= current && i < pools.size(); ++i)
+    {
+        vkResetDescriptorPool(context.vulkanContext.device, pools[i], 0);
+    }
+    current = 0;
+}
+
+VkDescriptorSet real::DescriptorPoolManager::AllocateTransientSet(VkDescriptorSetLayout layout)
+{
+    const auto context = RealEngine::GetGameContext();
+    auto& [pools, current] = m_TransientPools[m_CurrentFrame];
+
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &layout;
+
+    ++m_TransientAllocationCount;
+
+    // Full pools are skipped, they are reused once the frame comes around again
+    VkDescriptorSet descriptorSet;
+    for (; current < pools.size(); ++current)
+    {
+        allocInfo.descriptorPool = pools[current];
+        if (vkAllocateDescriptorSets(context.vulkanContext.device, &allocInfo, &descriptorSet) == VK_SUCCESS)
+        {
+            return descriptorSet;
+        }
+    }
+
+    pools.push_back(CreateDescriptorPool(transient_pool_size));
+    allocInfo.descriptorPool = pools.back();
+    if (vkAllocateDescriptorSets(context.vulkanContext.device, &allocInfo, &descriptorSet) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to allocate transient descriptor set");
+    }
+
+    return descriptorSet;
+}
+
+real::DescriptorStats real::DescriptorPoolManager::GetStats() const
+{
+    DescriptorStats stats{};
+    stats.layouts = static_cast<uint32_t>(m_Layouts.size());
+    stats.pools = static_cast<uint32_t>(m_DescriptorPools.size());
+    for (const auto& transientPools : m_TransientPools)
+        stats.transientPools += static_cast<uint32_t>(transientPools.pools.size());
+
+    stats.allocations = m_AllocationCount;
+    stats.transientAllocations = m_TransientAllocationCount;
+    stats.cacheHits = m_CacheHits;
+    stats.cacheMisses = m_CacheMisses;
+
+    return stats;
 }
 
 real::DescriptorPoolManager::DescriptorPoolManager()
@@ -56,6 +273,9 @@ VkDescriptorPool real::DescriptorPoolManager::CreateDescriptorPool(uint32_t size
     const std::vector<VkDescriptorPoolSize> poolSizes = {
          { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, size },
          { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, size },
+         { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, size },
+         { VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, size },
+         { VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, size },
     };
 
     VkDescriptorPoolCreateInfo poolInfo = {};
@@ -1,15 +1,47 @@
 #ifndef DESCRIPTORPOOLMANAGER_H
 #define DESCRIPTORPOOLMANAGER_H
 
+#include <array>
 #include <cstdint>
+#include <span>
+#include <unordered_map>
 #include <vector>
 
 #include <vulkan/vulkan.h>
 
 #include <real_core/Singleton.h>
 
+#include "Util/VulkanUtil.h"
+
 namespace real
 {
+	// A resource written to a cached set, only the info matching the type is used
+	struct DescriptorResource
+	{
+		uint32_t binding{ 0 };
+		VkDescriptorType type{ VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER };
+		VkDescriptorBufferInfo bufferInfo{};
+		VkDescriptorImageInfo imageInfo{};
+
+		bool operator==(const DescriptorResource& other) const;
+	};
+
+	struct DescriptorStats
+	{
+		uint32_t layouts{ 0 };
+		uint32_t pools{ 0 };
+		uint32_t transientPools{ 0 };
+		uint32_t allocations{ 0 };
+		// Allocated from the transient pools of the current frame
+		uint32_t transientAllocations{ 0 };
+		uint32_t cacheHits{ 0 };
+		uint32_t cacheMisses{ 0 };
+
+		float GetHitRate() const { return cacheHits + cacheMisses > 0 ? static_cast<float>(cacheHits) / static_cast<float>(cacheHits + cacheMisses) : 0.f; }
+	};
+
+	// Persistent sets come from a growing chain of pools that lives until CleanUp.
+	// Transient sets come from a chain of pools per frame in flight, which is reset as a whole in BeginFrame.
 	class DescriptorPoolManager final : public Singleton<DescriptorPoolManager>
 	{
 	public:
@@ -22,22 +54,74 @@ namespace real
 
 		void CleanUp();
 
+		// Persistent set owned by the caller, which is free to update it
 		VkDescriptorSet AllocateDescriptorSet(VkDescriptorSetLayout layout);
 		VkDescriptorPool GetCurrentPool() const { return m_CurrentPool; }
 
+		// Layouts are owned by the manager, equal bindings return the same layout
+		VkDescriptorSetLayout GetDescriptorSetLayout(std::span<const VkDescriptorSetLayoutBinding> bindings);
+		// Persistent set shared by everyone that binds the same resources to the same layout, it must never be updated
+		VkDescriptorSet GetDescriptorSet(VkDescriptorSetLayout layout, std::span<const DescriptorResource> resources);
+
+		// The fence of the frame has to be waited on, every transient set allocated for it becomes invalid
+		void BeginFrame(uint32_t frame);
+		// Valid until the next BeginFrame of the current frame
+		VkDescriptorSet AllocateTransientSet(VkDescriptorSetLayout layout);
+
+		DescriptorStats GetStats() const;
+
 	private:
 		friend class Singleton<DescriptorPoolManager>;
 		explicit DescriptorPoolManager();
 
+		struct LayoutKey
+		{
+			std::vector<VkDescriptorSetLayoutBinding> bindings{};
+
+			bool operator==(const LayoutKey& other) const;
+		};
+
+		struct SetKey
+		{
+			VkDescriptorSetLayout layout{ nullptr };
+			std::vector<DescriptorResource> resources{};
+
+			bool operator==(const SetKey&) const = default;
+		};
+
+		struct KeyHash
+		{
+			size_t operator()(const LayoutKey& key) const;
+			size_t operator()(const SetKey& key) const;
+		};
+
+		struct TransientPools
+		{
+			std::vector<VkDescriptorPool> pools{};
+			uint32_t current{ 0 };
+		};
+
 		std::vector<VkDescriptorPool> m_DescriptorPools;
 		VkDescriptorPool m_CurrentPool;
 		uint32_t m_CurrentPoolSize;
 		const uint32_t m_InitialPoolSize = 100;
 		const float m_GrowthFactor = 1.5f;
 
+		static constexpr uint32_t transient_pool_size = 64;
+		std::array<TransientPools, MAX_FRAMES_IN_FLIGHT> m_TransientPools{};
+		uint32_t m_CurrentFrame{ 0 };
+
+		std::unordered_map<LayoutKey, VkDescriptorSetLayout, KeyHash> m_Layouts{};
+		std::unordered_map<SetKey, VkDescriptorSet, KeyHash> m_Sets{};
+
+		uint32_t m_AllocationCount{ 0 };
+		uint32_t m_TransientAllocationCount{ 0 };
+		uint32_t m_CacheHits{ 0 };
+		uint32_t m_CacheMisses{ 0 };
+
 		static VkDescriptorPool CreateDescriptorPool(uint32_t size);
 		void AllocateNewPool();
 	};
 }
 
-#endif // DESCRIPTORPOOLMANAGER_H
\ No newline at end of file
+#endif // DESCRIPTORPOOLMANAGER_H
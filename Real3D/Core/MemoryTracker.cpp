@@ -0,0 +1,164 @@
+#include "MemoryTracker.h"
+
+#include <iostream>
+
+#include <real_core/imgui.h>
+
+namespace
+{
+	// 0 is left for allocations that were never tracked
+	void* ToUserData(real::EMemoryCategory category)
+	{
+		return reinterpret_cast<void*>(static_cast<uintptr_t>(category) + 1);
+	}
+
+	float ToMegabytes(VkDeviceSize bytes)
+	{
+		return static_cast<float>(bytes) / (1024.f * 1024.f);
+	}
+}
+
+void real::MemoryTracker::Init(const GameContext& context, bool isBudgetSupported)
+{
+	m_IsBudgetSupported = isBudgetSupported;
+
+	const VkPhysicalDeviceMemoryProperties* pProperties;
+	vmaGetMemoryProperties(context.vulkanContext.allocator, &pProperties);
+
+	m_DeviceLocalHeaps.clear();
+	for (uint32_t i = 0; i < pProperties->memoryHeapCount; ++i)
+	{
+		if (pProperties->memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT)
+			m_DeviceLocalHeaps.push_back(i);
+	}
+
+	if (m_IsBudgetSupported == false)
+		std::cout << "\033[1;90mMemory: VK_EXT_memory_budget is not supported, the budget is estimated from the heap sizes\033[0m\n";
+}
+
+void real::MemoryTracker::Update(const GameContext& context)
+{
+	const auto allocator = context.vulkanContext.allocator;
+
+	// The budget is fetched from the driver at most once per frame index
+	vmaSetCurrentFrameIndex(allocator, ++m_FrameIndex);
+
+	std::array<VmaBudget, VK_MAX_MEMORY_HEAPS> budgets{};
+	vmaGetHeapBudgets(allocator, budgets.data());
+
+	m_Budget = {};
+	for (const auto heap : m_DeviceLocalHeaps)
+	{
+		m_Budget.usage += budgets[heap].usage;
+		m_Budget.budget += budgets[heap].budget;
+	}
+
+	const float ratio = m_Budget.GetUsageRatio();
+	if (ratio >= soft_budget)
+	{
+		// Freed memory only returns a few frames later, so the observers get some time before they are asked again
+		if (m_IsOverBudget == false || m_FrameIndex - m_LastNotifiedFrame >= over_budget_interval)
+		{
+			m_IsOverBudget = true;
+			m_LastNotifiedFrame = m_FrameIndex;
+
+			std::cout << "\033[1;90mMemory: " << static_cast<int>(ratio * 100) << "% of the device local budget is used\033[0m\n";
+			budgetChanged.Notify(Events::overBudget, m_Budget);
+		}
+	}
+	else if (m_IsOverBudget && ratio < resume_budget)
+	{
+		m_IsOverBudget = false;
+		budgetChanged.Notify(Events::underBudget, m_Budget);
+	}
+}
+
+void real::MemoryTracker::OnGui() const
+{
+	ImGui::SetNextWindowSize(ImVec2(360, 300), ImGuiCond_FirstUseEver);
+	ImGui::Begin("GPU memory");
+
+	ImGui::Text("Device local: %.1f / %.1f MB%s", ToMegabytes(m_Budget.usage), ToMegabytes(m_Budget.budget),
+		m_IsBudgetSupported ? "" : " (estimated)");
+	ImGui::ProgressBar(m_Budget.GetUsageRatio(), ImVec2(-1, 0));
+	if (m_IsOverBudget)
+		ImGui::TextColored(ImVec4(1.f, 0.4f, 0.3f, 1.f), "Over the soft budget of %d%%", static_cast<int>(soft_budget * 100));
+
+	if (ImGui::BeginTable("##MemoryCategories", 3, ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders))
+	{
+		ImGui::TableSetupColumn("Category");
+		ImGui::TableSetupColumn("MB");
+		ImGui::TableSetupColumn("Allocations");
+		ImGui::TableHeadersRow();
+
+		for (uint8_t i = 0; i < static_cast<uint8_t>(EMemoryCategory::count); ++i)
+		{
+			const auto category = static_cast<EMemoryCategory>(i);
+			const auto stats = GetStats(category);
+
+			ImGui::TableNextRow();
+			ImGui::TableNextColumn();
+			ImGui::TextUnformatted(GetCategoryName(category));
+			ImGui::TableNextColumn();
+			ImGui::Text("%.2f", ToMegabytes(stats.bytes));
+			ImGui::TableNextColumn();
+			ImGui::Text("%u", stats.allocations);
+		}
+
+		ImGui::EndTable();
+	}
+
+	ImGui::End();
+}
+
+void real::MemoryTracker::Track(VmaAllocator allocator, VmaAllocation allocation, EMemoryCategory category)
+{
+	vmaSetAllocationUserData(allocator, allocation, ToUserData(category));
+
+	VmaAllocationInfo info;
+	vmaGetAllocationInfo(allocator, allocation, &info);
+
+	std::lock_guard lock(m_Mutex);
+	auto& stats = m_Categories[static_cast<size_t>(category)];
+	stats.bytes += info.size;
+	++stats.allocations;
+}
+
+void real::MemoryTracker::Untrack(VmaAllocator allocator, VmaAllocation allocation)
+{
+	if (allocation == nullptr)
+		return;
+
+	VmaAllocationInfo info;
+	vmaGetAllocationInfo(allocator, allocation, &info);
+
+	const auto userData = reinterpret_cast<uintptr_t>(info.pUserData);
+	if (userData == 0)
+		return;
+
+	std::lock_guard lock(m_Mutex);
+	auto& stats = m_Categories[userData - 1];
+	stats.bytes -= info.size;
+	--stats.allocations;
+}
+
+real::MemoryCategoryStats real::MemoryTracker::GetStats(EMemoryCategory category) const
+{
+	std::lock_guard lock(m_Mutex);
+	return m_Categories[static_cast<size_t>(category)];
+}
+
+const char* real::MemoryTracker::GetCategoryName(EMemoryCategory category)
+{
+	switch (category)
+	{
+	case EMemoryCategory::mesh:			return "Meshes";
+	case EMemoryCategory::transparent:	return "Transparent";
+	case EMemoryCategory::uniform:		return "Uniforms";
+	case EMemoryCategory::texture:		return "Textures";
+	case EMemoryCategory::indirect:		return "Indirect";
+	case EMemoryCategory::renderTarget:	return "Render targets";
+	case EMemoryCategory::staging:		return "Staging";
+	default:							return "Other";
+	}
+}
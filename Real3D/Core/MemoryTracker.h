@@ -0,0 +1,103 @@
+#ifndef MEMORYTRACKER_H
+#define MEMORYTRACKER_H
+
+#include <array>
+#include <mutex>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+
+#include <real_core/Singleton.h>
+#include <real_core/Subject.h>
+
+#include "Util/Structs.h"
+
+namespace real
+{
+	enum class EMemoryCategory : uint8_t
+	{
+		other = 0,
+		// The blocks of the mesh arenas, holding every chunk mesh
+		mesh = 1,
+		transparent = 2,
+		uniform = 3,
+		texture = 4,
+		indirect = 5,
+		renderTarget = 6,
+		staging = 7,
+		count
+	};
+
+	// Summed over the device local heaps
+	struct MemoryBudget
+	{
+		VkDeviceSize usage{ 0 };
+		VkDeviceSize budget{ 0 };
+
+		float GetUsageRatio() const { return budget > 0 ? static_cast<float>(usage) / static_cast<float>(budget) : 0.f; }
+	};
+
+	struct MemoryCategoryStats
+	{
+		VkDeviceSize bytes{ 0 };
+		uint32_t allocations{ 0 };
+	};
+
+	// Accounts every allocation to a category, stored as the user data of the VMA allocation, and queries the heap budgets every frame.
+	// Once the device local usage crosses soft_budget of the budget, budgetChanged is notified with overBudget,
+	// so the memory can be cut back before allocations start to fail.
+	class MemoryTracker final : public Singleton<MemoryTracker>
+	{
+	public:
+		enum class Events
+		{
+			overBudget,
+			underBudget
+		};
+
+		virtual ~MemoryTracker() override = default;
+
+		MemoryTracker(const MemoryTracker&) = delete;
+		MemoryTracker& operator=(const MemoryTracker&) = delete;
+		MemoryTracker(MemoryTracker&&) = delete;
+		MemoryTracker& operator=(MemoryTracker&&) = delete;
+
+		// Without VK_EXT_memory_budget VMA estimates the budget from the heap sizes
+		void Init(const GameContext& context, bool isBudgetSupported);
+		void Update(const GameContext& context);
+		void OnGui() const;
+
+		// Thread safe
+		void Track(VmaAllocator allocator, VmaAllocation allocation, EMemoryCategory category);
+		void Untrack(VmaAllocator allocator, VmaAllocation allocation);
+
+		MemoryCategoryStats GetStats(EMemoryCategory category) const;
+		const MemoryBudget& GetBudget() const { return m_Budget; }
+		bool IsOverBudget() const { return m_IsOverBudget; }
+
+		static const char* GetCategoryName(EMemoryCategory category);
+
+		Subject<Events, const MemoryBudget&> budgetChanged;
+
+	private:
+		friend class Singleton<MemoryTracker>;
+		MemoryTracker() = default;
+
+		static constexpr float soft_budget = 0.85f;
+		// Lower than the soft budget, so a usage hovering around it does not flip every frame
+		static constexpr float resume_budget = 0.75f;
+		// Frames between two notifications while the usage stays over the soft budget
+		static constexpr uint32_t over_budget_interval = 120;
+
+		mutable std::mutex m_Mutex{};
+		std::array<MemoryCategoryStats, static_cast<size_t>(EMemoryCategory::count)> m_Categories{};
+
+		std::vector<uint32_t> m_DeviceLocalHeaps{};
+		bool m_IsBudgetSupported{ false };
+		MemoryBudget m_Budget{};
+		bool m_IsOverBudget{ false };
+		uint32_t m_FrameIndex{ 0 };
+		uint32_t m_LastNotifiedFrame{ 0 };
+	};
+}
+
+#endif // MEMORYTRACKER_H
@@ -62,6 +62,22 @@ void real::SwapChain::CreateSwapChain(const GameContext& context)
 	m_SwapChainExtent = extent;
 }
 
+void real::SwapChain::CreateOffscreenImages(const GameContext& context)
+{
+	m_IsOffscreen = true;
+	m_SwapChainImageFormat = offscreen_format;
+	m_SwapChainExtent = { context.windowWidth, context.windowHeight };
+
+	m_SwapChainImages.resize(MAX_FRAMES_IN_FLIGHT);
+	m_OffscreenAllocations.resize(MAX_FRAMES_IN_FLIGHT);
+	for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
+	{
+		CreateImage(context, m_SwapChainExtent.width, m_SwapChainExtent.height, m_SwapChainImageFormat, VK_IMAGE_TILING_OPTIMAL,
+			VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+			m_SwapChainImages[i], m_OffscreenAllocations[i], 1, 1, EMemoryCategory::renderTarget);
+	}
+}
+
 void real::SwapChain::CreateSwapChainImages(const GameContext& context)
 {
 	m_SwapChainImageViews.resize(m_SwapChainImages.size());
@@ -77,6 +93,13 @@ void real::SwapChain::CleanUp(const GameContext& context) const
 	for (auto imageView : m_SwapChainImageViews)
 		vkDestroyImageView(context.vulkanContext.device, imageView, nullptr);
 
+	if (m_IsOffscreen)
+	{
+		for (size_t i = 0; i < m_SwapChainImages.size(); ++i)
+			DestroyImage(context.vulkanContext.allocator, m_SwapChainImages[i], m_OffscreenAllocations[i]);
+		return;
+	}
+
 	vkDestroySwapchainKHR(context.vulkanContext.device, m_SwapChain, nullptr);
 }
 
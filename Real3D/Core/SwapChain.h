@@ -18,19 +18,26 @@ namespace real
 		SwapChain operator=(SwapChain&&) = delete;
 
 		void CreateSwapChain(const GameContext& context);
+		// Headless mode, one image of the window size per frame in flight takes the place of the swap chain images
+		void CreateOffscreenImages(const GameContext& context);
 		void CreateSwapChainImages(const GameContext& context);
 
 		void CleanUp(const GameContext& context) const;
 
 		VkSwapchainKHR GetSwapChain() const { return m_SwapChain; }
+		bool IsOffscreen() const { return m_IsOffscreen; }
 		const std::vector<VkImage>& GetImages() const { return m_SwapChainImages; }
 		VkFormat GetFormat() const { return m_SwapChainImageFormat; }
 		VkExtent2D GetExtent() const { return m_SwapChainExtent; }
 		const std::vector<VkImageView>& GetImageViews() const { return m_SwapChainImageViews; }
 
 	private:
-		VkSwapchainKHR m_SwapChain;
+		static constexpr VkFormat offscreen_format = VK_FORMAT_B8G8R8A8_SRGB;
+
+		VkSwapchainKHR m_SwapChain{ nullptr };
+		bool m_IsOffscreen{ false };
 		std::vector<VkImage> m_SwapChainImages;
+		std::vector<VmaAllocation> m_OffscreenAllocations;
 		VkFormat m_SwapChainImageFormat;
 		VkExtent2D m_SwapChainExtent;
 		std::vector<VkImageView> m_SwapChainImageViews;
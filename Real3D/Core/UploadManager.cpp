@@ -0,0 +1,571 @@
+#include "UploadManager.h"
+
+#include <stdexcept>
+
+#include <real_core/CpuProfiler.h>
+
+#include "RealEngine.h"
+#include "Graphics/Renderer.h"
+
+void real::UploadManager::Init(const GameContext& context)
+{
+	const QueueFamilyIndices queueFamilyIndices = FindQueueFamilies(context.vulkanContext.physicalDevice, context.vulkanContext.surface);
+
+	m_GraphicsFamily = queueFamilyIndices.graphicsFamily.value();
+	m_TransferFamily = queueFamilyIndices.transferFamily.value();
+	m_HasDedicatedTransfer = queueFamilyIndices.hasDedicatedTransfer();
+
+	vkGetDeviceQueue(context.vulkanContext.device, m_TransferFamily, 0, &m_TransferQueue);
+
+	VkCommandPoolCreateInfo poolInfo{};
+	poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+	poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT | VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+	poolInfo.queueFamilyIndex = m_TransferFamily;
+
+	if (vkCreateCommandPool(context.vulkanContext.device, &poolInfo, nullptr, &m_CommandPool) != VK_SUCCESS)
+	{
+		throw std::runtime_error("failed to create upload command pool!");
+	}
+
+	if (m_HasDedicatedTransfer)
+	{
+		poolInfo.queueFamilyIndex = m_GraphicsFamily;
+
+		if (vkCreateCommandPool(context.vulkanContext.device, &poolInfo, nullptr, &m_AcquireCommandPool) != VK_SUCCESS)
+		{
+			throw std::runtime_error("failed to create acquire command pool!");
+		}
+	}
+
+	for (auto& frame : m_Frames)
+	{
+		VkCommandBufferAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		allocInfo.commandPool = m_CommandPool;
+		allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+		allocInfo.commandBufferCount = 1;
+
+		if (vkAllocateCommandBuffers(context.vulkanContext.device, &allocInfo, &frame.commandBuffer) != VK_SUCCESS)
+		{
+			throw std::runtime_error("failed to allocate upload command buffers!");
+		}
+
+		if (m_HasDedicatedTransfer)
+		{
+			allocInfo.commandPool = m_AcquireCommandPool;
+
+			if (vkAllocateCommandBuffers(context.vulkanContext.device, &allocInfo, &frame.acquireCommandBuffer) != VK_SUCCESS)
+			{
+				throw std::runtime_error("failed to allocate acquire command buffers!");
+			}
+		}
+	}
+
+	VkSemaphoreTypeCreateInfo timelineInfo{};
+	timelineInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+	timelineInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+	timelineInfo.initialValue = 0;
+
+	VkSemaphoreCreateInfo semaphoreInfo{};
+	semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+	semaphoreInfo.pNext = &timelineInfo;
+
+	if (vkCreateSemaphore(context.vulkanContext.device, &semaphoreInfo, nullptr, &m_TimelineSemaphore) != VK_SUCCESS)
+	{
+		throw std::runtime_error("failed to create upload timeline semaphore!");
+	}
+
+	CreateBuffer(context, staging_size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+		VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+		m_StagingBuffer, m_StagingAllocation, EMemoryCategory::staging);
+
+	void* data;
+	vmaMapMemory(context.vulkanContext.allocator, m_StagingAllocation, &data);
+	m_pStagingData = static_cast<uint8_t*>(data);
+}
+
+void real::UploadManager::CleanUp(const GameContext& context)
+{
+	VkSemaphoreWaitInfo waitInfo{};
+	waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+	waitInfo.semaphoreCount = 1;
+	waitInfo.pSemaphores = &m_TimelineSemaphore;
+	waitInfo.pValues = &m_TimelineValue;
+	vkWaitSemaphores(context.vulkanContext.device, &waitInfo, UINT64_MAX);
+
+	vkDestroySemaphore(context.vulkanContext.device, m_TimelineSemaphore, nullptr);
+
+	for (const auto& [frame, release] : m_ReleasedResources)
+	{
+		release(context);
+	}
+	m_ReleasedResources.clear();
+
+	vkDestroyCommandPool(context.vulkanContext.device, m_CommandPool, nullptr);
+	if (m_AcquireCommandPool != nullptr)
+		vkDestroyCommandPool(context.vulkanContext.device, m_AcquireCommandPool, nullptr);
+
+	vmaUnmapMemory(context.vulkanContext.allocator, m_StagingAllocation);
+	DestroyBuffer(context.vulkanContext.allocator, m_StagingBuffer, m_StagingAllocation);
+	m_pStagingData = nullptr;
+}
+
+void real::UploadManager::UploadBuffer(VkBuffer dstBuffer, const void* data, VkDeviceSize size, VkDeviceSize dstOffset)
+{
+	REAL_PROFILE_ZONE("UploadManager::UploadBuffer");
+
+	if (size == 0)
+		return;
+
+	RecordCopy(dstBuffer, data, size, dstOffset);
+
+	if (m_HasDedicatedTransfer == false)
+		return;
+
+	const auto commandBuffer = m_Frames[m_CurrentFrame].commandBuffer;
+
+	// Hand the written range over to the graphics queue
+	VkBufferMemoryBarrier barrier{};
+	barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+	barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	barrier.dstAccessMask = 0;
+	barrier.srcQueueFamilyIndex = m_TransferFamily;
+	barrier.dstQueueFamilyIndex = m_GraphicsFamily;
+	barrier.buffer = dstBuffer;
+	barrier.offset = dstOffset;
+	barrier.size = size;
+
+	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+		0, 0, nullptr, 1, &barrier, 0, nullptr);
+
+	barrier.srcAccessMask = 0;
+	barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT | VK_ACCESS_UNIFORM_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+	m_BufferAcquires.push_back(barrier);
+}
+
+void real::UploadManager::UploadSharedBuffer(VkBuffer dstBuffer, const void* data, VkDeviceSize size, VkDeviceSize dstOffset)
+{
+	if (size == 0)
+		return;
+
+	// The timeline semaphore the graphics queue waits on makes the copy visible
+	RecordCopy(dstBuffer, data, size, dstOffset);
+}
+
+void real::UploadManager::UploadImage(VkImage dstImage, const void* data, VkDeviceSize size, uint32_t width, uint32_t height)
+{
+	const VkDeviceSize srcOffset = Stage(data, size);
+	const auto commandBuffer = m_Frames[m_CurrentFrame].commandBuffer;
+
+	VkImageMemoryBarrier barrier{};
+	barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+	barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.image = dstImage;
+	barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	barrier.subresourceRange.baseMipLevel = 0;
+	barrier.subresourceRange.levelCount = 1;
+	barrier.subresourceRange.baseArrayLayer = 0;
+	barrier.subresourceRange.layerCount = 1;
+	barrier.srcAccessMask = 0;
+	barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+		0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+	VkBufferImageCopy region{};
+	region.bufferOffset = srcOffset;
+	region.bufferRowLength = 0;
+	region.bufferImageHeight = 0;
+	region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	region.imageSubresource.mipLevel = 0;
+	region.imageSubresource.baseArrayLayer = 0;
+	region.imageSubresource.layerCount = 1;
+	region.imageOffset = { 0, 0, 0 };
+	region.imageExtent = { width, height, 1 };
+
+	vkCmdCopyBufferToImage(commandBuffer, m_StagingBuffer, dstImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+	barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+	if (m_HasDedicatedTransfer == false)
+	{
+		barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+		vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+			0, 0, nullptr, 0, nullptr, 1, &barrier);
+		return;
+	}
+
+	// The release and acquire both perform the same layout transition
+	barrier.dstAccessMask = 0;
+	barrier.srcQueueFamilyIndex = m_TransferFamily;
+	barrier.dstQueueFamilyIndex = m_GraphicsFamily;
+
+	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+		0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+	barrier.srcAccessMask = 0;
+	barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+	m_ImageAcquires.push_back(barrier);
+}
+
+void real::UploadManager::UploadImageArray(VkImage dstImage, const void* data, VkDeviceSize size, uint32_t width, uint32_t height,
+	uint32_t layerCount, uint32_t mipLevels)
+{
+	const VkDeviceSize srcOffset = Stage(data, size);
+	const auto commandBuffer = m_Frames[m_CurrentFrame].commandBuffer;
+
+	VkImageMemoryBarrier barrier{};
+	barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+	barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.image = dstImage;
+	barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	barrier.subresourceRange.baseMipLevel = 0;
+	barrier.subresourceRange.levelCount = mipLevels;
+	barrier.subresourceRange.baseArrayLayer = 0;
+	barrier.subresourceRange.layerCount = layerCount;
+	barrier.srcAccessMask = 0;
+	barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+		0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+	// Tightly packed, so every layer starts right after the previous one
+	VkBufferImageCopy region{};
+	region.bufferOffset = srcOffset;
+	region.bufferRowLength = 0;
+	region.bufferImageHeight = 0;
+	region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	region.imageSubresource.mipLevel = 0;
+	region.imageSubresource.baseArrayLayer = 0;
+	region.imageSubresource.layerCount = layerCount;
+	region.imageOffset = { 0, 0, 0 };
+	region.imageExtent = { width, height, 1 };
+
+	vkCmdCopyBufferToImage(commandBuffer, m_StagingBuffer, dstImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+	const MipChain chain{ dstImage, width, height, layerCount, mipLevels };
+
+	if (m_HasDedicatedTransfer == false)
+	{
+		RecordMipChain(commandBuffer, chain);
+		return;
+	}
+
+	// Handed over in the layout it was copied in, the graphics queue generates the mips
+	barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	barrier.dstAccessMask = 0;
+	barrier.srcQueueFamilyIndex = m_TransferFamily;
+	barrier.dstQueueFamilyIndex = m_GraphicsFamily;
+
+	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+		0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+	barrier.srcAccessMask = 0;
+	barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+	m_ImageAcquires.push_back(barrier);
+	m_MipChains.push_back(chain);
+}
+
+void real::UploadManager::Release(std::function<void(const GameContext&)> release)
+{
+	m_ReleasedResources.push_back({ m_FrameCount, std::move(release) });
+}
+
+void real::UploadManager::ReleaseBuffer(VkBuffer buffer, VmaAllocation allocation)
+{
+	if (buffer == nullptr)
+		return;
+
+	Release([buffer, allocation](const GameContext& context)
+		{
+			DestroyBuffer(context.vulkanContext.allocator, buffer, allocation);
+		});
+}
+
+std::vector<uint32_t> real::UploadManager::GetSharedQueueFamilies() const
+{
+	if (m_HasDedicatedTransfer == false)
+		return {};
+
+	return { m_GraphicsFamily, m_TransferFamily };
+}
+
+void real::UploadManager::Flush(const GameContext& context)
+{
+	REAL_PROFILE_ZONE("UploadManager::Flush");
+
+	Submit();
+
+	// The renderer waited on the fence of this frame, everything released MAX_FRAMES_IN_FLIGHT frames ago is no longer in use
+	while (m_ReleasedResources.empty() == false && m_ReleasedResources.front().frame + MAX_FRAMES_IN_FLIGHT <= m_FrameCount)
+	{
+		m_ReleasedResources.front().release(context);
+		m_ReleasedResources.pop_front();
+	}
+
+	++m_FrameCount;
+}
+
+VkDeviceSize real::UploadManager::Stage(const void* data, VkDeviceSize size)
+{
+	// Satisfies the offset alignment of both buffer and image copies
+	constexpr VkDeviceSize alignment = 16;
+
+	if (size > slice_size)
+	{
+		throw std::runtime_error("upload exceeds the size of the staging buffer!");
+	}
+
+	const auto context = RealEngine::GetGameContext();
+
+	auto alignOffset = [](VkDeviceSize offset) { return (offset + alignment - 1) & ~(alignment - 1); };
+
+	// The slice of this frame is full, hand it to the GPU and continue in the next one
+	if (m_IsRecording && alignOffset(m_SliceOffset) + size > slice_size)
+		Submit();
+
+	if (m_IsRecording == false)
+		BeginBatch(context);
+
+	const VkDeviceSize offset = alignOffset(m_SliceOffset);
+	const VkDeviceSize stagingOffset = m_CurrentFrame * slice_size + offset;
+	memcpy(m_pStagingData + stagingOffset, data, size);
+
+	m_SliceOffset = offset + size;
+	m_UploadedBytes += size;
+
+	return stagingOffset;
+}
+
+void real::UploadManager::RecordCopy(VkBuffer dstBuffer, const void* data, VkDeviceSize size, VkDeviceSize dstOffset)
+{
+	const VkDeviceSize srcOffset = Stage(data, size);
+
+	VkBufferCopy copyRegion{};
+	copyRegion.srcOffset = srcOffset;
+	copyRegion.dstOffset = dstOffset;
+	copyRegion.size = size;
+	vkCmdCopyBuffer(m_Frames[m_CurrentFrame].commandBuffer, m_StagingBuffer, dstBuffer, 1, &copyRegion);
+}
+
+void real::UploadManager::BeginBatch(const GameContext& context)
+{
+	const auto& frame = m_Frames[m_CurrentFrame];
+
+	// The staging slice and command buffers are free again once the previous batch of this slice finished
+	VkSemaphoreWaitInfo waitInfo{};
+	waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+	waitInfo.semaphoreCount = 1;
+	waitInfo.pSemaphores = &m_TimelineSemaphore;
+	waitInfo.pValues = &frame.timelineValue;
+	vkWaitSemaphores(context.vulkanContext.device, &waitInfo, UINT64_MAX);
+
+	vkResetCommandBuffer(frame.commandBuffer, 0);
+
+	VkCommandBufferBeginInfo beginInfo{};
+	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+	if (vkBeginCommandBuffer(frame.commandBuffer, &beginInfo) != VK_SUCCESS)
+	{
+		throw std::runtime_error("failed to begin recording upload command buffer!");
+	}
+
+	m_SliceOffset = 0;
+	m_IsRecording = true;
+}
+
+void real::UploadManager::Submit()
+{
+	if (m_IsRecording == false)
+		return;
+
+	auto& frame = m_Frames[m_CurrentFrame];
+
+	if (m_HasDedicatedTransfer == false)
+	{
+		// Make the copies visible to every draw submitted after this batch
+		VkMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT | VK_ACCESS_UNIFORM_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+
+		vkCmdPipelineBarrier(frame.commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+			VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+			0, 1, &barrier, 0, nullptr, 0, nullptr);
+	}
+
+	if (vkEndCommandBuffer(frame.commandBuffer) != VK_SUCCESS)
+	{
+		throw std::runtime_error("failed to record upload command buffer!");
+	}
+
+	frame.timelineValue = ++m_TimelineValue;
+
+	VkTimelineSemaphoreSubmitInfo timelineInfo{};
+	timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+	timelineInfo.signalSemaphoreValueCount = 1;
+	timelineInfo.pSignalSemaphoreValues = &frame.timelineValue;
+
+	VkSubmitInfo submitInfo{};
+	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submitInfo.pNext = &timelineInfo;
+	submitInfo.commandBufferCount = 1;
+	submitInfo.pCommandBuffers = &frame.commandBuffer;
+	submitInfo.signalSemaphoreCount = 1;
+	submitInfo.pSignalSemaphores = &m_TimelineSemaphore;
+
+	if (vkQueueSubmit(m_TransferQueue, 1, &submitInfo, nullptr) != VK_SUCCESS)
+	{
+		throw std::runtime_error("failed to submit upload command buffer!");
+	}
+
+	if (m_HasDedicatedTransfer)
+		SubmitAcquire(frame);
+
+	m_IsRecording = false;
+	m_CurrentFrame = (m_CurrentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
+}
+
+void real::UploadManager::SubmitAcquire(FrameUpload& frame)
+{
+	vkResetCommandBuffer(frame.acquireCommandBuffer, 0);
+
+	VkCommandBufferBeginInfo beginInfo{};
+	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+	if (vkBeginCommandBuffer(frame.acquireCommandBuffer, &beginInfo) != VK_SUCCESS)
+	{
+		throw std::runtime_error("failed to begin recording acquire command buffer!");
+	}
+
+	// Every draw submitted after this one sees the uploaded data
+	vkCmdPipelineBarrier(frame.acquireCommandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+		VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+		0, nullptr,
+		static_cast<uint32_t>(m_BufferAcquires.size()), m_BufferAcquires.data(),
+		static_cast<uint32_t>(m_ImageAcquires.size()), m_ImageAcquires.data());
+
+	for (const auto& chain : m_MipChains)
+		RecordMipChain(frame.acquireCommandBuffer, chain);
+
+	m_BufferAcquires.clear();
+	m_ImageAcquires.clear();
+	m_MipChains.clear();
+
+	if (vkEndCommandBuffer(frame.acquireCommandBuffer) != VK_SUCCESS)
+	{
+		throw std::runtime_error("failed to record acquire command buffer!");
+	}
+
+	// Waits on the transfer queue, the slice is only reused once the acquire is done as well
+	const uint64_t waitValue = frame.timelineValue;
+	frame.timelineValue = ++m_TimelineValue;
+
+	VkTimelineSemaphoreSubmitInfo timelineInfo{};
+	timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+	timelineInfo.waitSemaphoreValueCount = 1;
+	timelineInfo.pWaitSemaphoreValues = &waitValue;
+	timelineInfo.signalSemaphoreValueCount = 1;
+	timelineInfo.pSignalSemaphoreValues = &frame.timelineValue;
+
+	constexpr VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+
+	VkSubmitInfo submitInfo{};
+	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submitInfo.pNext = &timelineInfo;
+	submitInfo.waitSemaphoreCount = 1;
+	submitInfo.pWaitSemaphores = &m_TimelineSemaphore;
+	submitInfo.pWaitDstStageMask = &waitStage;
+	submitInfo.commandBufferCount = 1;
+	submitInfo.pCommandBuffers = &frame.acquireCommandBuffer;
+	submitInfo.signalSemaphoreCount = 1;
+	submitInfo.pSignalSemaphores = &m_TimelineSemaphore;
+
+	if (vkQueueSubmit(Renderer::GetInstance().GetGraphicsQueue(), 1, &submitInfo, nullptr) != VK_SUCCESS)
+	{
+		throw std::runtime_error("failed to submit acquire command buffer!");
+	}
+}
+
+void real::UploadManager::RecordMipChain(VkCommandBuffer commandBuffer, const MipChain& chain)
+{
+	VkImageMemoryBarrier barrier{};
+	barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.image = chain.image;
+	barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	barrier.subresourceRange.levelCount = 1;
+	barrier.subresourceRange.baseArrayLayer = 0;
+	barrier.subresourceRange.layerCount = chain.layerCount;
+
+	auto mipWidth = static_cast<int32_t>(chain.width);
+	auto mipHeight = static_cast<int32_t>(chain.height);
+
+	for (uint32_t level = 1; level < chain.mipLevels; ++level)
+	{
+		// The previous level is complete, read from it
+		barrier.subresourceRange.baseMipLevel = level - 1;
+		barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+		vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+			0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+		const int32_t nextWidth = mipWidth > 1 ? mipWidth / 2 : 1;
+		const int32_t nextHeight = mipHeight > 1 ? mipHeight / 2 : 1;
+
+		// Every layer is blitted at once, the layers never bleed into each other
+		VkImageBlit blit{};
+		blit.srcOffsets[0] = { 0, 0, 0 };
+		blit.srcOffsets[1] = { mipWidth, mipHeight, 1 };
+		blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		blit.srcSubresource.mipLevel = level - 1;
+		blit.srcSubresource.baseArrayLayer = 0;
+		blit.srcSubresource.layerCount = chain.layerCount;
+		blit.dstOffsets[0] = { 0, 0, 0 };
+		blit.dstOffsets[1] = { nextWidth, nextHeight, 1 };
+		blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		blit.dstSubresource.mipLevel = level;
+		blit.dstSubresource.baseArrayLayer = 0;
+		blit.dstSubresource.layerCount = chain.layerCount;
+
+		vkCmdBlitImage(commandBuffer, chain.image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+			chain.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, VK_FILTER_LINEAR);
+
+		barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+		barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+		barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+		vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+			0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+		mipWidth = nextWidth;
+		mipHeight = nextHeight;
+	}
+
+	// The last level was only ever written to
+	barrier.subresourceRange.baseMipLevel = chain.mipLevels - 1;
+	barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+		0, 0, nullptr, 0, nullptr, 1, &barrier);
+}
@@ -0,0 +1,120 @@
+#ifndef UPLOADMANAGER_H
+#define UPLOADMANAGER_H
+
+#include <array>
+#include <deque>
+#include <functional>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+
+#include <real_core/Singleton.h>
+
+#include "Util/Structs.h"
+#include "Util/VulkanUtil.h"
+
+namespace real
+{
+	// Records every copy of a frame into a single command buffer, the data is staged in a persistently mapped ring.
+	// The copies run on the transfer queue when the device has one, the graphics queue then acquires the results.
+	class UploadManager final : public Singleton<UploadManager>
+	{
+	public:
+		virtual ~UploadManager() override = default;
+
+		UploadManager(const UploadManager&) = delete;
+		UploadManager& operator=(const UploadManager&) = delete;
+		UploadManager(UploadManager&&) = delete;
+		UploadManager& operator=(UploadManager&&) = delete;
+
+		void Init(const GameContext& context);  // NOLINT(clang-diagnostic-overloaded-virtual)
+		void CleanUp(const GameContext& context);
+
+		void UploadBuffer(VkBuffer dstBuffer, const void* data, VkDeviceSize size, VkDeviceSize dstOffset = 0);
+		// For buffers created with the shared queue families, no ownership has to be transferred
+		void UploadSharedBuffer(VkBuffer dstBuffer, const void* data, VkDeviceSize size, VkDeviceSize dstOffset = 0);
+		void UploadImage(VkImage dstImage, const void* data, VkDeviceSize size, uint32_t width, uint32_t height);
+		// The data holds the layers one after the other, the other mip levels are blitted from the first one.
+		// Blits need a graphics queue, with a dedicated transfer queue they are recorded after the acquire.
+		void UploadImageArray(VkImage dstImage, const void* data, VkDeviceSize size, uint32_t width, uint32_t height,
+			uint32_t layerCount, uint32_t mipLevels);
+
+		// Runs the release once the frames that might still use the resource are finished
+		void Release(std::function<void(const GameContext&)> release);
+		void ReleaseBuffer(VkBuffer buffer, VmaAllocation allocation);
+
+		// Submits the recorded copies, must happen before the frame that uses them is submitted
+		void Flush(const GameContext& context);
+
+		VkDeviceSize GetUploadedBytes() const { return m_UploadedBytes; }
+		bool HasDedicatedTransfer() const { return m_HasDedicatedTransfer; }
+		// Queue families a buffer has to be shared between to skip the ownership transfers
+		std::vector<uint32_t> GetSharedQueueFamilies() const;
+
+	private:
+		friend class Singleton<UploadManager>;
+		UploadManager() = default;
+
+		struct FrameUpload
+		{
+			VkCommandBuffer commandBuffer{ nullptr };
+			VkCommandBuffer acquireCommandBuffer{ nullptr };
+			uint64_t timelineValue{ 0 };
+		};
+
+		struct MipChain
+		{
+			VkImage image{ nullptr };
+			uint32_t width{}, height{};
+			uint32_t layerCount{}, mipLevels{};
+		};
+
+		struct ReleasedResource
+		{
+			uint64_t frame{};
+			std::function<void(const GameContext&)> release{};
+		};
+
+		// 32MB of staging memory, split in one slice per frame in flight
+		static constexpr VkDeviceSize staging_size = 32 * 1024 * 1024;
+		static constexpr VkDeviceSize slice_size = staging_size / MAX_FRAMES_IN_FLIGHT;
+
+		VkCommandPool m_CommandPool{ nullptr };
+		VkCommandPool m_AcquireCommandPool{ nullptr };
+		std::array<FrameUpload, MAX_FRAMES_IN_FLIGHT> m_Frames{};
+		uint32_t m_CurrentFrame{ 0 };
+		bool m_IsRecording{ false };
+
+		VkQueue m_TransferQueue{ nullptr };
+		uint32_t m_TransferFamily{ 0 }, m_GraphicsFamily{ 0 };
+		bool m_HasDedicatedTransfer{ false };
+
+		// Signaled by every batch, the graphics queue and the staging ring wait on it
+		VkSemaphore m_TimelineSemaphore{ nullptr };
+		uint64_t m_TimelineValue{ 0 };
+
+		std::vector<VkBufferMemoryBarrier> m_BufferAcquires{};
+		std::vector<VkImageMemoryBarrier> m_ImageAcquires{};
+		std::vector<MipChain> m_MipChains{};
+
+		VkBuffer m_StagingBuffer{ nullptr };
+		VmaAllocation m_StagingAllocation{ nullptr };
+		uint8_t* m_pStagingData{ nullptr };
+		VkDeviceSize m_SliceOffset{ 0 };
+
+		std::deque<ReleasedResource> m_ReleasedResources{};
+		uint64_t m_FrameCount{ 0 };
+
+		VkDeviceSize m_UploadedBytes{ 0 };
+
+		VkDeviceSize Stage(const void* data, VkDeviceSize size);
+		void RecordCopy(VkBuffer dstBuffer, const void* data, VkDeviceSize size, VkDeviceSize dstOffset);
+		void BeginBatch(const GameContext& context);
+		void Submit();
+		void SubmitAcquire(FrameUpload& frame);
+
+		// Every level has to be in the transfer destination layout, they all end up read only for the fragment shader
+		static void RecordMipChain(VkCommandBuffer commandBuffer, const MipChain& chain);
+	};
+}
+
+#endif // UPLOADMANAGER_H
@@ -0,0 +1,288 @@
+#include "DepthPyramid.h"
+
+#include <array>
+#include <bit>
+#include <stdexcept>
+
+#include "Renderer.h"
+#include "PipelineCache.h"
+#include "ShaderManager.h"
+#include "Core/SwapChain.h"
+#include "Core/DescriptorPoolManager.h"
+#include "Core/CommandBuffers/CommandBuffer.h"
+#include "Core/DepthBuffer/DepthBufferManager.h"
+#include "Util/VulkanUtil.h"
+
+real::DepthPyramid::DepthPyramid(const GameContext& context)
+	: m_IsEnabled(context.occlusionCulling)
+{
+	const auto pDepthBuffer = DepthBufferManager::GetInstance().GetDepthBuffer(0);
+	m_DepthImage = pDepthBuffer->GetImage();
+	m_DepthExtent = Renderer::GetInstance().GetSwapChain()->GetExtent();
+	if (DepthBuffer::HasStencilComponent(DepthBuffer::FindDepthFormat(context)))
+		m_DepthAspect |= VK_IMAGE_ASPECT_STENCIL_BIT;
+
+	// A power of two, so every level is exactly half of the one above it
+	if (m_IsEnabled)
+	{
+		m_Width = std::bit_floor(m_DepthExtent.width);
+		m_Height = std::bit_floor(m_DepthExtent.height);
+		m_MipLevels = static_cast<uint32_t>(std::bit_width(std::max(m_Width, m_Height)));
+	}
+
+	CreatePyramid(context);
+	CreateSampler(context);
+	Clear(context);
+
+	if (m_IsEnabled)
+	{
+		CreateDescriptorSets(context, pDepthBuffer->GetImageView());
+		CreatePipeline(context);
+	}
+}
+
+void real::DepthPyramid::CleanUp(const GameContext& context) const
+{
+	const auto device = context.vulkanContext.device;
+
+	if (m_Pipeline != nullptr)
+	{
+		vkDestroyPipeline(device, m_Pipeline, nullptr);
+		vkDestroyPipelineLayout(device, m_PipelineLayout, nullptr);
+	}
+
+	vkDestroySampler(device, m_Sampler, nullptr);
+	for (const auto mipView : m_MipViews)
+		vkDestroyImageView(device, mipView, nullptr);
+	vkDestroyImageView(device, m_ImageView, nullptr);
+
+	DestroyImage(context.vulkanContext.allocator, m_Image, m_ImageAllocation);
+}
+
+void real::DepthPyramid::Build(VkCommandBuffer commandBuffer) const
+{
+	if (m_IsEnabled == false)
+		return;
+
+	// The depth buffer is read by the first level, the cull pass of this frame has to be done with the pyramid
+	std::array<VkImageMemoryBarrier, 2> barriers{};
+	barriers[0].sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+	barriers[0].srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+	barriers[0].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+	barriers[0].oldLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+	barriers[0].newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	barriers[0].srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barriers[0].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barriers[0].image = m_DepthImage;
+	barriers[0].subresourceRange = { m_DepthAspect, 0, 1, 0, 1 };
+
+	barriers[1].sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+	barriers[1].srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
+	barriers[1].dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+	barriers[1].oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+	barriers[1].newLayout = VK_IMAGE_LAYOUT_GENERAL;
+	barriers[1].srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barriers[1].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barriers[1].image = m_Image;
+	barriers[1].subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, m_MipLevels, 0, 1 };
+
+	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+		VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 0, nullptr, static_cast<uint32_t>(barriers.size()), barriers.data());
+
+	vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_Pipeline);
+
+	for (uint32_t level = 0; level < m_MipLevels; ++level)
+	{
+		ReduceConstants constants{};
+		constants.inputSize = level == 0
+			? glm::ivec2(m_DepthExtent.width, m_DepthExtent.height)
+			: glm::ivec2(GetMipWidth(level - 1), GetMipHeight(level - 1));
+		constants.outputSize = glm::ivec2(GetMipWidth(level), GetMipHeight(level));
+
+		vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_PipelineLayout, 0, 1, &m_DescriptorSets[level], 0, nullptr);
+		vkCmdPushConstants(commandBuffer, m_PipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(ReduceConstants), &constants);
+		vkCmdDispatch(commandBuffer, (constants.outputSize.x + workgroup_size - 1) / workgroup_size,
+			(constants.outputSize.y + workgroup_size - 1) / workgroup_size, 1);
+
+		// The next level reads this one, the last barrier makes the pyramid visible to the cull pass of the next frame
+		VkImageMemoryBarrier levelBarrier = barriers[1];
+		levelBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+		levelBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+		levelBarrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, level, 1, 0, 1 };
+
+		vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			0, 0, nullptr, 0, nullptr, 1, &levelBarrier);
+	}
+
+	// The render pass of the next frame clears the depth buffer again
+	VkImageMemoryBarrier depthBarrier = barriers[0];
+	depthBarrier.srcAccessMask = 0;
+	depthBarrier.dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+	depthBarrier.oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	depthBarrier.newLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+		VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+		0, 0, nullptr, 0, nullptr, 1, &depthBarrier);
+}
+
+void real::DepthPyramid::CreatePyramid(const GameContext& context)
+{
+	CreateImage(context, m_Width, m_Height, format, VK_IMAGE_TILING_OPTIMAL,
+		VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_Image, m_ImageAllocation, m_MipLevels, 1, EMemoryCategory::renderTarget);
+
+	VkImageViewCreateInfo viewInfo{};
+	viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+	viewInfo.image = m_Image;
+	viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+	viewInfo.format = format;
+	viewInfo.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, m_MipLevels, 0, 1 };
+
+	if (vkCreateImageView(context.vulkanContext.device, &viewInfo, nullptr, &m_ImageView) != VK_SUCCESS)
+	{
+		throw std::runtime_error("failed to create depth pyramid image view!");
+	}
+
+	if (m_IsEnabled == false)
+		return;
+
+	// Every level is written through its own view
+	m_MipViews.resize(m_MipLevels);
+	for (uint32_t level = 0; level < m_MipLevels; ++level)
+	{
+		viewInfo.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, level, 1, 0, 1 };
+		if (vkCreateImageView(context.vulkanContext.device, &viewInfo, nullptr, &m_MipViews[level]) != VK_SUCCESS)
+		{
+			throw std::runtime_error("failed to create depth pyramid image view!");
+		}
+	}
+}
+
+void real::DepthPyramid::CreateSampler(const GameContext& context)
+{
+	// Texels are never blended, a blended depth would no longer be the farthest one
+	VkSamplerCreateInfo samplerInfo{};
+	samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+	samplerInfo.magFilter = VK_FILTER_NEAREST;
+	samplerInfo.minFilter = VK_FILTER_NEAREST;
+	samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+	samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+	samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+	samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+	samplerInfo.minLod = 0.0f;
+	samplerInfo.maxLod = static_cast<float>(m_MipLevels);
+
+	if (vkCreateSampler(context.vulkanContext.device, &samplerInfo, nullptr, &m_Sampler) != VK_SUCCESS)
+	{
+		throw std::runtime_error("failed to create depth pyramid sampler!");
+	}
+}
+
+void real::DepthPyramid::CreateDescriptorSets(const GameContext& context, VkImageView depthImageView)
+{
+	std::array<VkDescriptorSetLayoutBinding, 2> bindings{};
+	bindings[0].binding = 0;
+	bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+	bindings[0].descriptorCount = 1;
+	bindings[0].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+	bindings[1].binding = 1;
+	bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+	bindings[1].descriptorCount = 1;
+	bindings[1].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+	auto& descriptorPoolManager = DescriptorPoolManager::GetInstance();
+	m_DescriptorSetLayout = descriptorPoolManager.GetDescriptorSetLayout(bindings);
+
+	m_DescriptorSets.resize(m_MipLevels);
+	for (uint32_t level = 0; level < m_MipLevels; ++level)
+	{
+		m_DescriptorSets[level] = descriptorPoolManager.AllocateDescriptorSet(m_DescriptorSetLayout);
+
+		const std::array imageInfos = {
+			level == 0
+				? VkDescriptorImageInfo{ m_Sampler, depthImageView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL }
+				: VkDescriptorImageInfo{ m_Sampler, m_MipViews[level - 1], VK_IMAGE_LAYOUT_GENERAL },
+			VkDescriptorImageInfo{ VK_NULL_HANDLE, m_MipViews[level], VK_IMAGE_LAYOUT_GENERAL }
+		};
+
+		std::array<VkWriteDescriptorSet, 2> descriptorWrites{};
+		for (uint32_t i = 0; i < descriptorWrites.size(); ++i)
+		{
+			descriptorWrites[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			descriptorWrites[i].dstSet = m_DescriptorSets[level];
+			descriptorWrites[i].dstBinding = i;
+			descriptorWrites[i].dstArrayElement = 0;
+			descriptorWrites[i].descriptorType = bindings[i].descriptorType;
+			descriptorWrites[i].descriptorCount = 1;
+			descriptorWrites[i].pImageInfo = &imageInfos[i];
+		}
+
+		vkUpdateDescriptorSets(context.vulkanContext.device, static_cast<uint32_t>(descriptorWrites.size()),
+			descriptorWrites.data(), 0, nullptr);
+	}
+}
+
+void real::DepthPyramid::CreatePipeline(const GameContext& context)
+{
+	VkPushConstantRange pushConstantRange{};
+	pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+	pushConstantRange.offset = 0;
+	pushConstantRange.size = sizeof(ReduceConstants);
+
+	VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+	pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+	pipelineLayoutInfo.setLayoutCount = 1;
+	pipelineLayoutInfo.pSetLayouts = &m_DescriptorSetLayout;
+	pipelineLayoutInfo.pushConstantRangeCount = 1;
+	pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+
+	if (vkCreatePipelineLayout(context.vulkanContext.device, &pipelineLayoutInfo, nullptr, &m_PipelineLayout) != VK_SUCCESS)
+	{
+		throw std::runtime_error("failed to create pipeline layout!");
+	}
+
+	VkComputePipelineCreateInfo pipelineInfo{};
+	pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+	pipelineInfo.stage = ShaderManager::GetInstance().CreateShaderInfo(context.vulkanContext.device, ShaderType::compute, "depthreduce.comp.spv");
+	pipelineInfo.layout = m_PipelineLayout;
+
+	if (PipelineCache::GetInstance().CreateComputePipeline(context.vulkanContext.device, pipelineInfo, &m_Pipeline) != VK_SUCCESS)
+	{
+		throw std::runtime_error("failed to create compute pipeline!");
+	}
+}
+
+void real::DepthPyramid::Clear(const GameContext& context) const
+{
+	const auto commandBuffer = CommandBuffer::StartSingleTimeCommands(context);
+
+	const VkImageSubresourceRange range{ VK_IMAGE_ASPECT_COLOR_BIT, 0, m_MipLevels, 0, 1 };
+
+	// Stays in the general layout, it is written as a storage image and sampled by the cull pass
+	VkImageMemoryBarrier barrier{};
+	barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+	barrier.srcAccessMask = 0;
+	barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.image = m_Image;
+	barrier.subresourceRange = range;
+
+	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+		0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+	constexpr VkClearColorValue farPlane{ { 1.0f, 1.0f, 1.0f, 1.0f } };
+	vkCmdClearColorImage(commandBuffer, m_Image, VK_IMAGE_LAYOUT_GENERAL, &farPlane, 1, &range);
+
+	barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+	barrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+		0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+	CommandBuffer::StopSingleTimeCommands(context, commandBuffer);
+}
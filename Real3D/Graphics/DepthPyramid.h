@@ -0,0 +1,79 @@
+#ifndef DEPTHPYRAMID_H
+#define DEPTHPYRAMID_H
+
+#include <algorithm>
+#include <vector>
+#include <glm/vec2.hpp>
+#include <vulkan/vulkan_core.h>
+
+#include "Util/Structs.h"
+
+namespace real
+{
+	// Reduces the depth buffer of a frame into a mip chain, every texel holds the farthest depth of the texels it covers.
+	// The cull pass of the next frame tests the bounds of its draws against it, see IndirectBatch::Cull.
+	// Without occlusion culling only a single cleared texel is created, so the cull pass always has something to bind.
+	class DepthPyramid final
+	{
+	public:
+		explicit DepthPyramid(const GameContext& context);
+		~DepthPyramid() = default;
+
+		DepthPyramid(const DepthPyramid&) = delete;
+		DepthPyramid& operator=(const DepthPyramid&) = delete;
+		DepthPyramid(DepthPyramid&&) = delete;
+		DepthPyramid& operator=(DepthPyramid&&) = delete;
+
+		void CleanUp(const GameContext& context) const;
+
+		// Must be recorded after the render pass that wrote the depth buffer
+		void Build(VkCommandBuffer commandBuffer) const;
+
+		bool IsEnabled() const { return m_IsEnabled; }
+		VkSampler GetSampler() const { return m_Sampler; }
+		VkImageView GetImageView() const { return m_ImageView; }
+		// In texels of the first level
+		glm::vec2 GetSize() const { return { m_Width, m_Height }; }
+
+	private:
+		struct ReduceConstants
+		{
+			glm::ivec2 inputSize{};
+			glm::ivec2 outputSize{};
+		};
+
+		static constexpr VkFormat format = VK_FORMAT_R32_SFLOAT;
+		static constexpr uint32_t workgroup_size = 8;
+
+		bool m_IsEnabled{ false };
+
+		VkImage m_Image{ nullptr };
+		VmaAllocation m_ImageAllocation{ nullptr };
+		VkImageView m_ImageView{ nullptr };
+		std::vector<VkImageView> m_MipViews{};
+		VkSampler m_Sampler{ nullptr };
+		uint32_t m_Width{ 1 }, m_Height{ 1 }, m_MipLevels{ 1 };
+
+		VkImage m_DepthImage{ nullptr };
+		VkImageAspectFlags m_DepthAspect{ VK_IMAGE_ASPECT_DEPTH_BIT };
+		VkExtent2D m_DepthExtent{};
+
+		VkDescriptorSetLayout m_DescriptorSetLayout{ nullptr };
+		// One per level, reading the level above it or the depth buffer
+		std::vector<VkDescriptorSet> m_DescriptorSets{};
+		VkPipelineLayout m_PipelineLayout{ nullptr };
+		VkPipeline m_Pipeline{ nullptr };
+
+		void CreatePyramid(const GameContext& context);
+		void CreateSampler(const GameContext& context);
+		void CreateDescriptorSets(const GameContext& context, VkImageView depthImageView);
+		void CreatePipeline(const GameContext& context);
+		// Cleared to the far plane, nothing is occluded until the first build
+		void Clear(const GameContext& context) const;
+
+		uint32_t GetMipWidth(uint32_t level) const { return std::max(m_Width >> level, 1u); }
+		uint32_t GetMipHeight(uint32_t level) const { return std::max(m_Height >> level, 1u); }
+	};
+}
+
+#endif // DEPTHPYRAMID_H
@@ -0,0 +1,234 @@
+#include "GpuProfiler.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+#include <real_core/implot.h>
+
+void real::GpuProfiler::Init(const GameContext& context)
+{
+	m_Device = context.vulkanContext.device;
+	m_IsEnabled = context.profiling;
+	if (m_IsEnabled == false)
+		return;
+
+	const auto physicalDevice = context.vulkanContext.physicalDevice;
+
+	VkPhysicalDeviceProperties properties;
+	vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+
+	uint32_t familyCount = 0;
+	vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &familyCount, nullptr);
+	std::vector<VkQueueFamilyProperties> families(familyCount);
+	vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &familyCount, families.data());
+
+	// Every scope is recorded on the graphics queue
+	const auto graphicsFamily = FindQueueFamilies(physicalDevice, context.vulkanContext.surface).graphicsFamily.value();
+	const auto validBits = families[graphicsFamily].timestampValidBits;
+
+	m_IsSupported = properties.limits.timestampPeriod > 0.f && validBits > 0;
+	if (m_IsSupported == false)
+	{
+		std::cout << "\033[1;90mGPU profiler: timestamps are not supported by the graphics queue, nothing will be measured\033[0m\n";
+		return;
+	}
+
+	m_TimestampPeriod = properties.limits.timestampPeriod;
+	m_TimestampMask = validBits >= 64 ? UINT64_MAX : (uint64_t{ 1 } << validBits) - 1;
+
+	VkQueryPoolCreateInfo queryPoolInfo{};
+	queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+	queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+	queryPoolInfo.queryCount = max_queries;
+
+	for (auto& frame : m_Frames)
+	{
+		if (vkCreateQueryPool(m_Device, &queryPoolInfo, nullptr, &frame.queryPool) != VK_SUCCESS)
+		{
+			throw std::runtime_error("failed to create timestamp query pool!");
+		}
+	}
+}
+
+void real::GpuProfiler::CleanUp(const GameContext& context)
+{
+	for (auto& frame : m_Frames)
+	{
+		if (frame.queryPool != nullptr)
+			vkDestroyQueryPool(context.vulkanContext.device, frame.queryPool, nullptr);
+
+		frame.queryPool = nullptr;
+		frame.scopes.clear();
+		frame.queryCount = 0;
+	}
+
+	m_IsSupported = false;
+}
+
+void real::GpuProfiler::BeginFrame(VkCommandBuffer commandBuffer, uint32_t frame)
+{
+	if (m_IsSupported == false)
+		return;
+
+	m_CurrentFrame = frame;
+
+	auto& queries = m_Frames[frame];
+	ReadResults(queries);
+
+	queries.scopes.clear();
+	queries.queryCount = 0;
+	vkCmdResetQueryPool(commandBuffer, queries.queryPool, 0, max_queries);
+}
+
+uint32_t real::GpuProfiler::BeginScope(VkCommandBuffer commandBuffer, const std::string& name)
+{
+	if (m_IsSupported == false)
+		return no_scope;
+
+	auto& frame = m_Frames[m_CurrentFrame];
+	uint32_t firstQuery;
+	{
+		std::lock_guard lock(m_Mutex);
+		if (frame.queryCount + 2 > max_queries)
+			return no_scope;
+
+		const auto [it, inserted] = m_ScopeIds.try_emplace(name, static_cast<uint32_t>(m_History.size()));
+		if (inserted)
+			m_History.push_back({ name });
+
+		firstQuery = frame.queryCount;
+		frame.queryCount += 2;
+		frame.scopes.push_back({ it->second, firstQuery });
+	}
+
+	vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, frame.queryPool, firstQuery);
+	return firstQuery;
+}
+
+void real::GpuProfiler::EndScope(VkCommandBuffer commandBuffer, uint32_t scope) const
+{
+	if (scope == no_scope)
+		return;
+
+	vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_Frames[m_CurrentFrame].queryPool, scope + 1);
+}
+
+void real::GpuProfiler::OnGui()
+{
+	if (m_IsEnabled == false)
+		return;
+
+	ImGui::SetNextWindowSize(ImVec2(480, 360), ImGuiCond_FirstUseEver);
+	ImGui::Begin("GPU profiler");
+
+	if (m_IsSupported == false)
+	{
+		ImGui::TextUnformatted("Timestamps are not supported by the graphics queue of this device");
+		ImGui::End();
+		return;
+	}
+
+	if (ImGui::Button("Export CSV"))
+		ExportCsv("gpu_profile.csv");
+	ImGui::SameLine();
+	ImGui::Text("%u frames, read back %d frames late", m_HistoryCount, MAX_FRAMES_IN_FLIGHT);
+
+	if (ImPlot::BeginPlot("##GpuTimes", ImVec2(-1, 200)))
+	{
+		ImPlot::SetupAxes("frame", "ms", ImPlotAxisFlags_NoTickLabels, ImPlotAxisFlags_AutoFit);
+		ImPlot::SetupAxisLimits(ImAxis_X1, 0, history_size, ImGuiCond_Always);
+
+		// The history is a ring, the offset makes the plot start at the oldest frame
+		for (const auto& [name, times] : m_History)
+			ImPlot::PlotLine(name.c_str(), times.data(), static_cast<int>(history_size), 1.0, 0.0, 0, static_cast<int>(m_HistoryOffset));
+
+		ImPlot::EndPlot();
+	}
+
+	if (ImGui::BeginTable("##GpuScopes", 3, ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders))
+	{
+		ImGui::TableSetupColumn("Scope");
+		ImGui::TableSetupColumn("Last (ms)");
+		ImGui::TableSetupColumn("Average (ms)");
+		ImGui::TableHeadersRow();
+
+		const uint32_t last = (m_HistoryOffset + history_size - 1) % history_size;
+		for (const auto& [name, times] : m_History)
+		{
+			float sum = 0.f;
+			for (uint32_t i = 0; i < m_HistoryCount; ++i)
+				sum += times[(m_HistoryOffset + history_size - 1 - i) % history_size];
+
+			ImGui::TableNextRow();
+			ImGui::TableNextColumn();
+			ImGui::TextUnformatted(name.c_str());
+			ImGui::TableNextColumn();
+			ImGui::Text("%.3f", times[last]);
+			ImGui::TableNextColumn();
+			ImGui::Text("%.3f", m_HistoryCount > 0 ? sum / static_cast<float>(m_HistoryCount) : 0.f);
+		}
+
+		ImGui::EndTable();
+	}
+
+	ImGui::End();
+}
+
+bool real::GpuProfiler::ExportCsv(const std::string& path) const
+{
+	std::ofstream file(path, std::ios::trunc);
+	if (file.is_open() == false)
+		return false;
+
+	file << "frame";
+	for (const auto& scope : m_History)
+		file << ',' << scope.name;
+	file << '\n';
+
+	// Oldest frame first
+	for (uint32_t i = 0; i < m_HistoryCount; ++i)
+	{
+		const uint32_t slot = (m_HistoryOffset + history_size - m_HistoryCount + i) % history_size;
+
+		file << i;
+		for (const auto& scope : m_History)
+			file << ',' << scope.times[slot];
+		file << '\n';
+	}
+
+	std::cout << "\033[1;90mGPU profiler: " << m_HistoryCount << " frames written to " << path << "\033[0m\n";
+	return true;
+}
+
+void real::GpuProfiler::ReadResults(FrameQueries& frame)
+{
+	if (frame.queryCount == 0)
+		return;
+
+	// Every query is followed by its availability, a scope that was never ended is skipped
+	std::vector<uint64_t> results(frame.queryCount * 2);
+	vkGetQueryPoolResults(m_Device, frame.queryPool, 0, frame.queryCount, results.size() * sizeof(uint64_t), results.data(),
+		2 * sizeof(uint64_t), VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+
+	std::lock_guard lock(m_Mutex);
+
+	std::vector<float> times(m_History.size(), 0.f);
+	for (const auto& [id, firstQuery] : frame.scopes)
+	{
+		const auto begin = results[firstQuery * 2];
+		const auto end = results[(firstQuery + 1) * 2];
+		if (results[firstQuery * 2 + 1] == 0 || results[(firstQuery + 1) * 2 + 1] == 0)
+			continue;
+
+		const auto ticks = ((end & m_TimestampMask) - (begin & m_TimestampMask)) & m_TimestampMask;
+		times[id] += static_cast<float>(static_cast<double>(ticks) * m_TimestampPeriod / 1'000'000.0);
+	}
+
+	for (size_t i = 0; i < m_History.size(); ++i)
+		m_History[i].times[m_HistoryOffset] = times[i];
+
+	m_HistoryOffset = (m_HistoryOffset + 1) % history_size;
+	m_HistoryCount = std::min(m_HistoryCount + 1, history_size);
+}
@@ -0,0 +1,98 @@
+#ifndef GPUPROFILER_H
+#define GPUPROFILER_H
+
+#include <array>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+
+#include <real_core/Singleton.h>
+
+#include "Util/Structs.h"
+#include "Util/VulkanUtil.h"
+
+namespace real
+{
+	// Measures named scopes on the gpu with timestamp queries. Every frame in flight has its own query pool,
+	// the results of a frame are read once its fence has been waited on, MAX_FRAMES_IN_FLIGHT frames later.
+	// Scopes with the same name are summed per frame, so they can be opened from several command buffers.
+	class GpuProfiler final : public Singleton<GpuProfiler>
+	{
+	public:
+		virtual ~GpuProfiler() override = default;
+
+		GpuProfiler(const GpuProfiler&) = delete;
+		GpuProfiler& operator=(const GpuProfiler&) = delete;
+		GpuProfiler(GpuProfiler&&) = delete;
+		GpuProfiler& operator=(GpuProfiler&&) = delete;
+
+		static constexpr uint32_t no_scope = UINT32_MAX;
+
+		void Init(const GameContext& context);
+		void CleanUp(const GameContext& context);
+
+		// Reads the results of the frame and resets its queries, has to be recorded outside of a render pass
+		void BeginFrame(VkCommandBuffer commandBuffer, uint32_t frame);
+
+		// Thread safe, returns no_scope when the profiler is disabled or the queries of the frame ran out.
+		// The end has to be recorded in the same command buffer, cached command buffers can not be profiled.
+		uint32_t BeginScope(VkCommandBuffer commandBuffer, const std::string& name);
+		void EndScope(VkCommandBuffer commandBuffer, uint32_t scope) const;
+
+		void OnGui();
+		// One row per frame in the history, one column per scope, in milliseconds
+		bool ExportCsv(const std::string& path) const;
+
+		bool IsEnabled() const { return m_IsEnabled; }
+		bool IsSupported() const { return m_IsSupported; }
+
+	private:
+		friend class Singleton<GpuProfiler>;
+		GpuProfiler() = default;
+
+		static constexpr uint32_t max_queries = 512;
+		static constexpr uint32_t history_size = 256;
+
+		// The begin and end timestamps are written to firstQuery and the query after it
+		struct Scope
+		{
+			uint32_t id{};
+			uint32_t firstQuery{};
+		};
+
+		struct FrameQueries
+		{
+			VkQueryPool queryPool{ nullptr };
+			std::vector<Scope> scopes{};
+			uint32_t queryCount{ 0 };
+		};
+
+		struct ScopeHistory
+		{
+			std::string name{};
+			std::array<float, history_size> times{};
+		};
+
+		VkDevice m_Device{ nullptr };
+		bool m_IsEnabled{ false };
+		bool m_IsSupported{ false };
+		float m_TimestampPeriod{ 0.f };
+		uint64_t m_TimestampMask{ 0 };
+
+		std::mutex m_Mutex{};
+		std::array<FrameQueries, MAX_FRAMES_IN_FLIGHT> m_Frames{};
+		uint32_t m_CurrentFrame{ 0 };
+
+		std::unordered_map<std::string, uint32_t> m_ScopeIds{};
+		std::vector<ScopeHistory> m_History{};
+		// The slot the next frame is written to, the oldest frame in the history
+		uint32_t m_HistoryOffset{ 0 };
+		uint32_t m_HistoryCount{ 0 };
+
+		void ReadResults(FrameQueries& frame);
+	};
+}
+
+#endif // GPUPROFILER_H
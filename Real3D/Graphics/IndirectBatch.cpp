@@ -0,0 +1,343 @@
+#include "IndirectBatch.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "Renderer.h"
+#include "PipelineCache.h"
+#include "ShaderManager.h"
+#include "DepthPyramid.h"
+#include "Core/DescriptorPoolManager.h"
+
+real::IndirectBatch::IndirectBatch(const GameContext& context, uint32_t capacity)
+{
+	VkPhysicalDeviceVulkan12Features vulkan12Features{};
+	vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+
+	VkPhysicalDeviceFeatures2 features{};
+	features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+	features.pNext = &vulkan12Features;
+	vkGetPhysicalDeviceFeatures2(context.vulkanContext.physicalDevice, &features);
+
+	m_SupportsMultiDraw = features.features.multiDrawIndirect;
+	m_SupportsDrawCount = vulkan12Features.drawIndirectCount;
+
+	CreatePipeline(context);
+
+	for (auto& frame : m_Frames)
+	{
+		CreateFrameBuffers(context, frame, capacity);
+	}
+}
+
+void real::IndirectBatch::CleanUp(const GameContext& context)
+{
+	for (auto& frame : m_Frames)
+	{
+		DestroyFrameBuffers(context, frame);
+	}
+
+	vkDestroyPipeline(context.vulkanContext.device, m_Pipeline, nullptr);
+	vkDestroyPipelineLayout(context.vulkanContext.device, m_PipelineLayout, nullptr);
+}
+
+void real::IndirectBatch::Add(const BufferRange& vertices, const BufferRange& indices, const glm::mat4& transform, const AABB& bounds)
+{
+	if (vertices.count == 0 || indices.count == 0)
+		return;
+
+	m_Draws.push_back({ vertices, indices, transform, bounds });
+}
+
+void real::IndirectBatch::Prepare(const GameContext& context)
+{
+	auto& frame = m_Frames[Renderer::GetInstance().GetCurrentFrame()];
+
+	// The fence of this frame has been waited on, so the counts its cull pass wrote can be read
+	const auto pCounts = static_cast<uint32_t*>(frame.pMappedCounts);
+	m_VisibleCount = 0;
+	for (uint32_t i = 0; i < frame.groups.size(); ++i)
+		m_VisibleCount += pCounts[i];
+
+	const auto pStats = static_cast<CullStats*>(frame.pMappedStats);
+	m_FrustumCulledCount = pStats->frustumCulled;
+	m_OcclusionCulledCount = pStats->occlusionCulled;
+
+	// ...and its buffers can be replaced right away
+	if (m_Draws.size() > frame.capacity)
+	{
+		const auto capacity = std::max(frame.capacity * 2, static_cast<uint32_t>(m_Draws.size()));
+		DestroyFrameBuffers(context, frame);
+		CreateFrameBuffers(context, frame, capacity);
+		++frame.drawVersion;
+	}
+
+	// The transient pools of this frame were reset, the cull set is written again every frame
+	frame.descriptorSet = DescriptorPoolManager::GetInstance().AllocateTransientSet(m_DescriptorSetLayout);
+	WriteDescriptorSet(context, frame);
+
+	// Draws that share their arena blocks end up next to each other and are issued together
+	std::ranges::sort(m_Draws, [](const DrawInfo& a, const DrawInfo& b)
+		{
+			if (a.vertices.block != b.vertices.block)
+				return a.vertices.block < b.vertices.block;
+			return a.indices.block < b.indices.block;
+		});
+
+	m_Groups.clear();
+
+	const auto pCommands = static_cast<VkDrawIndexedIndirectCommand*>(frame.pMappedCommands);
+	const auto pCullData = static_cast<CullData*>(frame.pMappedCull);
+	const auto pTransforms = static_cast<glm::mat4*>(frame.pMappedTransforms);
+
+	for (uint32_t i = 0; i < m_Draws.size(); ++i)
+	{
+		const auto& [vertices, indices, transform, bounds] = m_Draws[i];
+
+		if (m_Groups.empty() || m_Groups.back().vertexBlock != vertices.block || m_Groups.back().indexBlock != indices.block)
+			m_Groups.push_back({ i, 0, vertices.block, indices.block });
+		++m_Groups.back().count;
+
+		pCommands[i].indexCount = indices.count;
+		pCommands[i].instanceCount = 1;
+		pCommands[i].firstIndex = indices.offset;
+		pCommands[i].vertexOffset = static_cast<int32_t>(vertices.offset);
+		pCommands[i].firstInstance = i;
+
+		pCullData[i].min = bounds.min;
+		pCullData[i].max = bounds.max;
+		pCullData[i].group = static_cast<uint32_t>(m_Groups.size() - 1);
+		pCullData[i].groupFirst = m_Groups.back().first;
+
+		pTransforms[i] = transform;
+	}
+
+	if (frame.groups != m_Groups)
+	{
+		frame.groups = m_Groups;
+		++frame.drawVersion;
+	}
+}
+
+void real::IndirectBatch::Cull(VkCommandBuffer commandBuffer, const glm::mat4& viewProjection) const
+{
+	const auto& frame = m_Frames[Renderer::GetInstance().GetCurrentFrame()];
+
+	// Culled draws leave zeroed commands behind, which draw nothing when the count can not be used
+	vkCmdFillBuffer(commandBuffer, frame.visibleBuffer, 0, VK_WHOLE_SIZE, 0);
+	vkCmdFillBuffer(commandBuffer, frame.countBuffer, 0, VK_WHOLE_SIZE, 0);
+	vkCmdFillBuffer(commandBuffer, frame.statsBuffer, 0, VK_WHOLE_SIZE, 0);
+
+	VkMemoryBarrier clearBarrier{};
+	clearBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+	clearBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	clearBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+		0, 1, &clearBarrier, 0, nullptr, 0, nullptr);
+
+	const auto pDepthPyramid = Renderer::GetInstance().GetDepthPyramid();
+
+	CullConstants constants{};
+	constants.viewProjection = viewProjection;
+	constants.pyramidSize = pDepthPyramid->GetSize();
+	constants.drawCount = static_cast<uint32_t>(m_Draws.size());
+	constants.isOcclusionEnabled = pDepthPyramid->IsEnabled() ? 1 : 0;
+
+	vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_Pipeline);
+	vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_PipelineLayout, 0, 1, &frame.descriptorSet, 0, nullptr);
+	vkCmdPushConstants(commandBuffer, m_PipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(CullConstants), &constants);
+	vkCmdDispatch(commandBuffer, (constants.drawCount + workgroup_size - 1) / workgroup_size, 1, 1);
+
+	VkMemoryBarrier cullBarrier{};
+	cullBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+	cullBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+	cullBarrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_HOST_READ_BIT;
+	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_HOST_BIT,
+		0, 1, &cullBarrier, 0, nullptr, 0, nullptr);
+}
+
+void real::IndirectBatch::Draw(VkCommandBuffer commandBuffer, const BufferArena& vertexArena, const BufferArena& indexArena)
+{
+	m_DrawCallCount = 0;
+
+	const auto& frame = m_Frames[Renderer::GetInstance().GetCurrentFrame()];
+	constexpr uint32_t stride = sizeof(VkDrawIndexedIndirectCommand);
+
+	for (uint32_t group = 0; group < m_Groups.size(); ++group)
+	{
+		const auto& [first, count, vertexBlock, indexBlock] = m_Groups[group];
+
+		const VkBuffer vertexBuffers[] = { vertexArena.GetBuffer(vertexBlock) };
+		constexpr VkDeviceSize offsets[] = { 0 };
+		vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
+		vkCmdBindIndexBuffer(commandBuffer, indexArena.GetBuffer(indexBlock), 0, VK_INDEX_TYPE_UINT32);
+
+		if (m_SupportsDrawCount)
+		{
+			vkCmdDrawIndexedIndirectCount(commandBuffer, frame.visibleBuffer, first * stride,
+				frame.countBuffer, group * sizeof(uint32_t), count, stride);
+			++m_DrawCallCount;
+		}
+		else if (m_SupportsMultiDraw)
+		{
+			vkCmdDrawIndexedIndirect(commandBuffer, frame.visibleBuffer, first * stride, count, stride);
+			++m_DrawCallCount;
+		}
+		else
+		{
+			for (uint32_t i = first; i < first + count; ++i)
+			{
+				vkCmdDrawIndexedIndirect(commandBuffer, frame.visibleBuffer, i * stride, 1, stride);
+				++m_DrawCallCount;
+			}
+		}
+	}
+}
+
+void real::IndirectBatch::CreatePipeline(const GameContext& context)
+{
+	// The depth pyramid sits at binding 4, between the buffers
+	std::array<VkDescriptorSetLayoutBinding, 6> bindings{};
+	for (uint32_t i = 0; i < bindings.size(); ++i)
+	{
+		bindings[i].binding = i;
+		bindings[i].descriptorType = i == 4 ? VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER : VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		bindings[i].descriptorCount = 1;
+		bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+	}
+
+	m_DescriptorSetLayout = DescriptorPoolManager::GetInstance().GetDescriptorSetLayout(bindings);
+
+	VkPushConstantRange pushConstantRange{};
+	pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+	pushConstantRange.offset = 0;
+	pushConstantRange.size = sizeof(CullConstants);
+
+	VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+	pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+	pipelineLayoutInfo.setLayoutCount = 1;
+	pipelineLayoutInfo.pSetLayouts = &m_DescriptorSetLayout;
+	pipelineLayoutInfo.pushConstantRangeCount = 1;
+	pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+
+	if (vkCreatePipelineLayout(context.vulkanContext.device, &pipelineLayoutInfo, nullptr, &m_PipelineLayout) != VK_SUCCESS)
+	{
+		throw std::runtime_error("failed to create pipeline layout!");
+	}
+
+	VkComputePipelineCreateInfo pipelineInfo{};
+	pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+	pipelineInfo.stage = ShaderManager::GetInstance().CreateShaderInfo(context.vulkanContext.device, ShaderType::compute, "indirectcull.comp.spv");
+	pipelineInfo.layout = m_PipelineLayout;
+
+	if (PipelineCache::GetInstance().CreateComputePipeline(context.vulkanContext.device, pipelineInfo, &m_Pipeline) != VK_SUCCESS)
+	{
+		throw std::runtime_error("failed to create compute pipeline!");
+	}
+}
+
+void real::IndirectBatch::CreateFrameBuffers(const GameContext& context, FrameBuffers& frame, uint32_t capacity) const
+{
+	const auto allocator = context.vulkanContext.allocator;
+	constexpr auto hostVisible = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+
+	CreateBuffer(context, sizeof(VkDrawIndexedIndirectCommand) * capacity, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+		hostVisible, frame.commandBuffer, frame.commandAllocation, EMemoryCategory::indirect);
+	vmaMapMemory(allocator, frame.commandAllocation, &frame.pMappedCommands);
+
+	CreateBuffer(context, sizeof(CullData) * capacity, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+		hostVisible, frame.cullBuffer, frame.cullAllocation, EMemoryCategory::indirect);
+	vmaMapMemory(allocator, frame.cullAllocation, &frame.pMappedCull);
+
+	CreateBuffer(context, sizeof(glm::mat4) * capacity, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+		hostVisible, frame.transformBuffer, frame.transformAllocation, EMemoryCategory::indirect);
+	vmaMapMemory(allocator, frame.transformAllocation, &frame.pMappedTransforms);
+
+	CreateBuffer(context, sizeof(VkDrawIndexedIndirectCommand) * capacity,
+		VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, frame.visibleBuffer, frame.visibleAllocation, EMemoryCategory::indirect);
+
+	// There are never more groups than draws, host visible so the visible count can be read back
+	CreateBuffer(context, sizeof(uint32_t) * capacity,
+		VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+		hostVisible, frame.countBuffer, frame.countAllocation, EMemoryCategory::indirect);
+	vmaMapMemory(allocator, frame.countAllocation, &frame.pMappedCounts);
+
+	CreateBuffer(context, sizeof(CullStats), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+		hostVisible, frame.statsBuffer, frame.statsAllocation, EMemoryCategory::indirect);
+	vmaMapMemory(allocator, frame.statsAllocation, &frame.pMappedStats);
+	*static_cast<CullStats*>(frame.pMappedStats) = {};
+
+	frame.capacity = capacity;
+	frame.groups.clear();
+}
+
+void real::IndirectBatch::WriteDescriptorSet(const GameContext& context, const FrameBuffers& frame)
+{
+	const std::array<VkDescriptorBufferInfo, 6> bufferInfos{ {
+		{ frame.commandBuffer, 0, VK_WHOLE_SIZE },
+		{ frame.cullBuffer, 0, VK_WHOLE_SIZE },
+		{ frame.visibleBuffer, 0, VK_WHOLE_SIZE },
+		{ frame.countBuffer, 0, VK_WHOLE_SIZE },
+		{},
+		{ frame.statsBuffer, 0, VK_WHOLE_SIZE },
+	} };
+
+	// Always bound, without occlusion culling it is a single texel the shader never samples
+	const auto pDepthPyramid = Renderer::GetInstance().GetDepthPyramid();
+	const VkDescriptorImageInfo pyramidInfo{ pDepthPyramid->GetSampler(), pDepthPyramid->GetImageView(), VK_IMAGE_LAYOUT_GENERAL };
+
+	std::array<VkWriteDescriptorSet, 6> descriptorWrites{};
+	for (uint32_t i = 0; i < descriptorWrites.size(); ++i)
+	{
+		descriptorWrites[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		descriptorWrites[i].dstSet = frame.descriptorSet;
+		descriptorWrites[i].dstBinding = i;
+		descriptorWrites[i].dstArrayElement = 0;
+		descriptorWrites[i].descriptorCount = 1;
+
+		if (i == 4)
+		{
+			descriptorWrites[i].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+			descriptorWrites[i].pImageInfo = &pyramidInfo;
+		}
+		else
+		{
+			descriptorWrites[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+			descriptorWrites[i].pBufferInfo = &bufferInfos[i];
+		}
+	}
+
+	vkUpdateDescriptorSets(context.vulkanContext.device, static_cast<uint32_t>(descriptorWrites.size()),
+		descriptorWrites.data(), 0, nullptr);
+}
+
+void real::IndirectBatch::DestroyFrameBuffers(const GameContext& context, FrameBuffers& frame)
+{
+	const auto allocator = context.vulkanContext.allocator;
+
+	auto destroy = [allocator](VkBuffer& buffer, VmaAllocation allocation, void** ppMapped)
+		{
+			if (buffer == nullptr)
+				return;
+
+			if (ppMapped != nullptr)
+			{
+				vmaUnmapMemory(allocator, allocation);
+				*ppMapped = nullptr;
+			}
+
+			DestroyBuffer(allocator, buffer, allocation);
+			buffer = nullptr;
+		};
+
+	destroy(frame.commandBuffer, frame.commandAllocation, &frame.pMappedCommands);
+	destroy(frame.cullBuffer, frame.cullAllocation, &frame.pMappedCull);
+	destroy(frame.transformBuffer, frame.transformAllocation, &frame.pMappedTransforms);
+	destroy(frame.visibleBuffer, frame.visibleAllocation, nullptr);
+	destroy(frame.countBuffer, frame.countAllocation, &frame.pMappedCounts);
+	destroy(frame.statsBuffer, frame.statsAllocation, &frame.pMappedStats);
+
+	frame.capacity = 0;
+	frame.groups.clear();
+}
@@ -0,0 +1,157 @@
+#ifndef INDIRECTBATCH_H
+#define INDIRECTBATCH_H
+
+#include <array>
+#include <vector>
+#include <glm/mat4x4.hpp>
+#include <glm/vec2.hpp>
+#include <vulkan/vulkan_core.h>
+
+#include "Mesh/BufferArena.h"
+#include "Misc/AABB.h"
+#include "Util/Structs.h"
+#include "Util/VulkanUtil.h"
+
+namespace real
+{
+	// Collects arena ranges and draws them with as few vkCmdDrawIndexedIndirect calls as possible.
+	// The transform of a draw is stored at its firstInstance, so shaders index it with gl_InstanceIndex.
+	// A compute pass tests the bounds of every draw against the frustum and compacts the survivors on the gpu.
+	// With occlusion culling the survivors are also tested against the DepthPyramid of the previous frame.
+	class IndirectBatch final
+	{
+	public:
+		explicit IndirectBatch(const GameContext& context, uint32_t capacity = 1024);
+		~IndirectBatch() = default;
+
+		IndirectBatch(const IndirectBatch&) = delete;
+		IndirectBatch& operator=(const IndirectBatch&) = delete;
+		IndirectBatch(IndirectBatch&&) = delete;
+		IndirectBatch& operator=(IndirectBatch&&) = delete;
+
+		void CleanUp(const GameContext& context);
+
+		void Clear() { m_Draws.clear(); }
+		void Add(const BufferRange& vertices, const BufferRange& indices, const glm::mat4& transform, const AABB& bounds);
+
+		// Writes the commands and transforms of the current frame, must happen before its transform buffer is bound
+		void Prepare(const GameContext& context);
+		// Must be recorded outside of the render pass, after Prepare
+		void Cull(VkCommandBuffer commandBuffer, const glm::mat4& viewProjection) const;
+		void Draw(VkCommandBuffer commandBuffer, const BufferArena& vertexArena, const BufferArena& indexArena);
+
+		VkBuffer GetTransformBuffer(uint32_t frame) const { return m_Frames[frame].transformBuffer; }
+		VkDeviceSize GetTransformBufferSize(uint32_t frame) const { return sizeof(glm::mat4) * m_Frames[frame].capacity; }
+
+		// Changes whenever the commands Draw records for the frame would change, the culling results are read from buffers
+		uint64_t GetDrawVersion(uint32_t frame) const { return m_Frames[frame].drawVersion; }
+
+		uint32_t GetDrawCount() const { return static_cast<uint32_t>(m_Draws.size()); }
+		uint32_t GetDrawCallCount() const { return m_DrawCallCount; }
+		// Draws that survived the culling, read back MAX_FRAMES_IN_FLIGHT frames late
+		uint32_t GetVisibleCount() const { return m_VisibleCount; }
+		uint32_t GetFrustumCulledCount() const { return m_FrustumCulledCount; }
+		uint32_t GetOcclusionCulledCount() const { return m_OcclusionCulledCount; }
+
+	private:
+		struct DrawInfo
+		{
+			BufferRange vertices{};
+			BufferRange indices{};
+			glm::mat4 transform{};
+			AABB bounds{};
+		};
+
+		// Draws that share their arena blocks, compacted into [first, first + count) of the output commands
+		struct DrawGroup
+		{
+			uint32_t first{}, count{};
+			uint32_t vertexBlock{}, indexBlock{};
+
+			bool operator==(const DrawGroup&) const = default;
+		};
+
+		// Matches the std430 layout of the cull shader
+		struct CullData
+		{
+			glm::vec3 min{};
+			uint32_t group{};
+			glm::vec3 max{};
+			uint32_t groupFirst{};
+		};
+
+		// The frustum planes are extracted from the matrix in the shader
+		struct CullConstants
+		{
+			glm::mat4 viewProjection{};
+			glm::vec2 pyramidSize{};
+			uint32_t drawCount{};
+			uint32_t isOcclusionEnabled{};
+		};
+
+		// Matches the std430 layout of the cull shader
+		struct CullStats
+		{
+			uint32_t frustumCulled{};
+			uint32_t occlusionCulled{};
+		};
+
+		struct FrameBuffers
+		{
+			VkBuffer commandBuffer{ nullptr };
+			VmaAllocation commandAllocation{ nullptr };
+			void* pMappedCommands{ nullptr };
+
+			VkBuffer cullBuffer{ nullptr };
+			VmaAllocation cullAllocation{ nullptr };
+			void* pMappedCull{ nullptr };
+
+			VkBuffer transformBuffer{ nullptr };
+			VmaAllocation transformAllocation{ nullptr };
+			void* pMappedTransforms{ nullptr };
+
+			// Written by the cull shader
+			VkBuffer visibleBuffer{ nullptr };
+			VmaAllocation visibleAllocation{ nullptr };
+
+			VkBuffer countBuffer{ nullptr };
+			VmaAllocation countAllocation{ nullptr };
+			void* pMappedCounts{ nullptr };
+
+			VkBuffer statsBuffer{ nullptr };
+			VmaAllocation statsAllocation{ nullptr };
+			void* pMappedStats{ nullptr };
+
+			// Transient, allocated again by every Prepare
+			VkDescriptorSet descriptorSet{ nullptr };
+			uint32_t capacity{ 0 };
+			// The groups Draw was last prepared with for this frame
+			std::vector<DrawGroup> groups{};
+			uint64_t drawVersion{ 0 };
+		};
+
+		static constexpr uint32_t workgroup_size = 64;
+
+		std::array<FrameBuffers, MAX_FRAMES_IN_FLIGHT> m_Frames{};
+		std::vector<DrawInfo> m_Draws{};
+		std::vector<DrawGroup> m_Groups{};
+
+		VkDescriptorSetLayout m_DescriptorSetLayout{ nullptr };
+		VkPipelineLayout m_PipelineLayout{ nullptr };
+		VkPipeline m_Pipeline{ nullptr };
+
+		bool m_SupportsMultiDraw{ false };
+		bool m_SupportsDrawCount{ false };
+		uint32_t m_DrawCallCount{ 0 };
+		uint32_t m_VisibleCount{ 0 };
+		uint32_t m_FrustumCulledCount{ 0 };
+		uint32_t m_OcclusionCulledCount{ 0 };
+
+		void CreatePipeline(const GameContext& context);
+		void CreateFrameBuffers(const GameContext& context, FrameBuffers& frame, uint32_t capacity) const;
+		static void DestroyFrameBuffers(const GameContext& context, FrameBuffers& frame);
+		static void WriteDescriptorSet(const GameContext& context, const FrameBuffers& frame);
+	};
+}
+
+#endif // INDIRECTBATCH_H
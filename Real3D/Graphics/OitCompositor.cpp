@@ -0,0 +1,215 @@
+#include "OitCompositor.h"
+
+#include <stdexcept>
+
+#include "RenderPass.h"
+#include "Renderer.h"
+#include "PipelineCache.h"
+#include "ShaderManager.h"
+#include "Core/SwapChain.h"
+#include "Core/DescriptorPoolManager.h"
+#include "Util/VulkanUtil.h"
+
+real::OitCompositor::OitCompositor(const GameContext& context)
+{
+	CreateAttachments(context);
+	CreateDescriptorSet(context);
+	CreatePipeline(context);
+}
+
+void real::OitCompositor::CleanUp(const GameContext& context) const
+{
+	vkDestroyPipeline(context.vulkanContext.device, m_Pipeline, nullptr);
+	vkDestroyPipelineLayout(context.vulkanContext.device, m_PipelineLayout, nullptr);
+
+	vkDestroyImageView(context.vulkanContext.device, m_AccumulationImageView, nullptr);
+	DestroyImage(context.vulkanContext.allocator, m_AccumulationImage, m_AccumulationImageAllocation);
+
+	vkDestroyImageView(context.vulkanContext.device, m_RevealageImageView, nullptr);
+	DestroyImage(context.vulkanContext.allocator, m_RevealageImage, m_RevealageImageAllocation);
+}
+
+void real::OitCompositor::Draw(VkCommandBuffer commandBuffer) const
+{
+	vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_Pipeline);
+	vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_PipelineLayout, 0, 1, &m_DescriptorSet, 0, nullptr);
+
+	// Fullscreen triangle, generated in the vertex shader
+	vkCmdDraw(commandBuffer, 3, 1, 0, 0);
+}
+
+std::array<VkPipelineColorBlendAttachmentState, 2> real::OitCompositor::GetTransparentBlendAttachments()
+{
+	// Accumulation: sum of premultiplied, weighted colors
+	VkPipelineColorBlendAttachmentState accumulation{};
+	accumulation.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+	accumulation.blendEnable = VK_TRUE;
+	accumulation.srcColorBlendFactor = VK_BLEND_FACTOR_ONE;
+	accumulation.dstColorBlendFactor = VK_BLEND_FACTOR_ONE;
+	accumulation.colorBlendOp = VK_BLEND_OP_ADD;
+	accumulation.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+	accumulation.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+	accumulation.alphaBlendOp = VK_BLEND_OP_ADD;
+
+	// Revealage: product of (1 - alpha)
+	VkPipelineColorBlendAttachmentState revealage{};
+	revealage.colorWriteMask = VK_COLOR_COMPONENT_R_BIT;
+	revealage.blendEnable = VK_TRUE;
+	revealage.srcColorBlendFactor = VK_BLEND_FACTOR_ZERO;
+	revealage.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_COLOR;
+	revealage.colorBlendOp = VK_BLEND_OP_ADD;
+	revealage.srcAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+	revealage.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+	revealage.alphaBlendOp = VK_BLEND_OP_ADD;
+
+	return { accumulation, revealage };
+}
+
+void real::OitCompositor::CreateAttachments(const GameContext& context)
+{
+	const auto [width, height] = Renderer::GetInstance().GetSwapChain()->GetExtent();
+	constexpr VkImageUsageFlags usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+
+	CreateImage(context, width, height, accumulation_format, VK_IMAGE_TILING_OPTIMAL, usage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+		m_AccumulationImage, m_AccumulationImageAllocation, 1, 1, EMemoryCategory::renderTarget);
+	m_AccumulationImageView = CreateImageView(context, m_AccumulationImage, accumulation_format);
+
+	CreateImage(context, width, height, revealage_format, VK_IMAGE_TILING_OPTIMAL, usage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+		m_RevealageImage, m_RevealageImageAllocation, 1, 1, EMemoryCategory::renderTarget);
+	m_RevealageImageView = CreateImageView(context, m_RevealageImage, revealage_format);
+}
+
+void real::OitCompositor::CreateDescriptorSet(const GameContext& context)
+{
+	std::array<VkDescriptorSetLayoutBinding, 2> bindings{};
+	for (uint32_t i = 0; i < bindings.size(); ++i)
+	{
+		bindings[i].binding = i;
+		bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+		bindings[i].descriptorCount = 1;
+		bindings[i].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+		bindings[i].pImmutableSamplers = nullptr;
+	}
+
+	// The set points at attachments the compositor owns, so it is not taken from the cache
+	m_DescriptorSetLayout = DescriptorPoolManager::GetInstance().GetDescriptorSetLayout(bindings);
+	m_DescriptorSet = DescriptorPoolManager::GetInstance().AllocateDescriptorSet(m_DescriptorSetLayout);
+
+	const std::array imageInfos = {
+		VkDescriptorImageInfo{ VK_NULL_HANDLE, m_AccumulationImageView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL },
+		VkDescriptorImageInfo{ VK_NULL_HANDLE, m_RevealageImageView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL }
+	};
+
+	std::array<VkWriteDescriptorSet, 2> descriptorWrites{};
+	for (uint32_t i = 0; i < descriptorWrites.size(); ++i)
+	{
+		descriptorWrites[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		descriptorWrites[i].dstSet = m_DescriptorSet;
+		descriptorWrites[i].dstBinding = i;
+		descriptorWrites[i].dstArrayElement = 0;
+		descriptorWrites[i].descriptorType = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+		descriptorWrites[i].descriptorCount = 1;
+		descriptorWrites[i].pImageInfo = &imageInfos[i];
+	}
+
+	vkUpdateDescriptorSets(context.vulkanContext.device, static_cast<uint32_t>(descriptorWrites.size()),
+		descriptorWrites.data(), 0, nullptr);
+}
+
+void real::OitCompositor::CreatePipeline(const GameContext& context)
+{
+	const auto vulkan = context.vulkanContext;
+
+	auto vertShaderStageInfo = ShaderManager::GetInstance().CreateShaderInfo(vulkan.device, ShaderType::vertex, "oitcomposite.vert.spv");
+	auto fragShaderStageInfo = ShaderManager::GetInstance().CreateShaderInfo(vulkan.device, ShaderType::fragment, "oitcomposite.frag.spv");
+
+	std::vector shaderStages = { vertShaderStageInfo, fragShaderStageInfo };
+
+	const auto assemblyStateInfo = CreateInputAssemblyStateInfo(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST);
+
+	VkPipelineVertexInputStateCreateInfo vertexInput{};
+	vertexInput.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+
+	VkPipelineViewportStateCreateInfo viewportState{};
+	viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+	viewportState.viewportCount = 1;
+	viewportState.scissorCount = 1;
+
+	VkPipelineRasterizationStateCreateInfo rasterizer{};
+	rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+	rasterizer.depthClampEnable = VK_FALSE;
+	rasterizer.rasterizerDiscardEnable = VK_FALSE;
+	rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
+	rasterizer.lineWidth = 1.0f;
+	rasterizer.cullMode = VK_CULL_MODE_NONE;
+	rasterizer.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+	rasterizer.depthBiasEnable = VK_FALSE;
+
+	VkPipelineMultisampleStateCreateInfo multisampling{};
+	multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+	multisampling.sampleShadingEnable = VK_FALSE;
+	multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+	VkPipelineColorBlendAttachmentState colorBlendAttachment{};
+	colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+	colorBlendAttachment.blendEnable = VK_TRUE;
+	colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+	colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+	colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
+	colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+	colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+	colorBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
+
+	VkPipelineColorBlendStateCreateInfo colorBlending{};
+	colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+	colorBlending.logicOpEnable = VK_FALSE;
+	colorBlending.attachmentCount = 1;
+	colorBlending.pAttachments = &colorBlendAttachment;
+
+	VkPipelineDepthStencilStateCreateInfo depthStencil{};
+	depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+	depthStencil.depthTestEnable = VK_FALSE;
+	depthStencil.depthWriteEnable = VK_FALSE;
+
+	std::vector<VkDynamicState> dynamicStates = {
+		VK_DYNAMIC_STATE_VIEWPORT,
+		VK_DYNAMIC_STATE_SCISSOR
+	};
+	VkPipelineDynamicStateCreateInfo dynamicState{};
+	dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+	dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
+	dynamicState.pDynamicStates = dynamicStates.data();
+
+	VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+	pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+	pipelineLayoutInfo.setLayoutCount = 1;
+	pipelineLayoutInfo.pSetLayouts = &m_DescriptorSetLayout;
+	pipelineLayoutInfo.pushConstantRangeCount = 0;
+
+	if (vkCreatePipelineLayout(vulkan.device, &pipelineLayoutInfo, nullptr, &m_PipelineLayout) != VK_SUCCESS)
+	{
+		throw std::runtime_error("failed to create OIT pipeline layout!");
+	}
+
+	VkGraphicsPipelineCreateInfo pipelineInfo{};
+	pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+	pipelineInfo.stageCount = static_cast<uint32_t>(shaderStages.size());
+	pipelineInfo.pStages = shaderStages.data();
+	pipelineInfo.pVertexInputState = &vertexInput;
+	pipelineInfo.pInputAssemblyState = &assemblyStateInfo;
+	pipelineInfo.pViewportState = &viewportState;
+	pipelineInfo.pRasterizationState = &rasterizer;
+	pipelineInfo.pMultisampleState = &multisampling;
+	pipelineInfo.pColorBlendState = &colorBlending;
+	pipelineInfo.pDynamicState = &dynamicState;
+	pipelineInfo.pDepthStencilState = &depthStencil;
+	pipelineInfo.layout = m_PipelineLayout;
+	pipelineInfo.renderPass = vulkan.renderPass;
+	pipelineInfo.subpass = RenderPass::composite_subpass;
+	pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
+
+	if (PipelineCache::GetInstance().CreateGraphicsPipeline(vulkan.device, pipelineInfo, &m_Pipeline) != VK_SUCCESS)
+	{
+		throw std::runtime_error("failed to create OIT composite pipeline!");
+	}
+}
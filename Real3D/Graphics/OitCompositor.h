@@ -0,0 +1,55 @@
+#ifndef OITCOMPOSITOR_H
+#define OITCOMPOSITOR_H
+
+#include <array>
+#include <vulkan/vulkan_core.h>
+
+#include "Util/Structs.h"
+
+namespace real
+{
+	class OitCompositor final
+	{
+	public:
+		explicit OitCompositor(const GameContext& context);
+		~OitCompositor() = default;
+
+		OitCompositor(const OitCompositor&) = delete;
+		OitCompositor& operator=(const OitCompositor&) = delete;
+		OitCompositor(OitCompositor&&) = delete;
+		OitCompositor& operator=(OitCompositor&&) = delete;
+
+		void CleanUp(const GameContext& context) const;
+
+		void Draw(VkCommandBuffer commandBuffer) const;
+
+		VkImageView GetAccumulationImageView() const { return m_AccumulationImageView; }
+		VkImageView GetRevealageImageView() const { return m_RevealageImageView; }
+
+		// Blend states for the accumulation and revealage attachments of the transparent subpass
+		static std::array<VkPipelineColorBlendAttachmentState, 2> GetTransparentBlendAttachments();
+
+		static constexpr VkFormat accumulation_format = VK_FORMAT_R16G16B16A16_SFLOAT;
+		static constexpr VkFormat revealage_format = VK_FORMAT_R16_SFLOAT;
+
+	private:
+		VkImage m_AccumulationImage{};
+		VmaAllocation m_AccumulationImageAllocation{};
+		VkImageView m_AccumulationImageView{};
+
+		VkImage m_RevealageImage{};
+		VmaAllocation m_RevealageImageAllocation{};
+		VkImageView m_RevealageImageView{};
+
+		VkDescriptorSetLayout m_DescriptorSetLayout{};
+		VkDescriptorSet m_DescriptorSet{};
+		VkPipelineLayout m_PipelineLayout{};
+		VkPipeline m_Pipeline{};
+
+		void CreateAttachments(const GameContext& context);
+		void CreateDescriptorSet(const GameContext& context);
+		void CreatePipeline(const GameContext& context);
+	};
+}
+
+#endif // OITCOMPOSITOR_H
@@ -0,0 +1,172 @@
+#include "ParallelRecorder.h"
+
+#include <stdexcept>
+#include <string>
+
+#include <real_core/CpuProfiler.h>
+
+#include "Core/CommandPool.h"
+#include "Util/VulkanUtil.h"
+
+real::ParallelRecorder::ParallelRecorder(const GameContext& context, uint32_t threadCount)
+	: m_Device(context.vulkanContext.device)
+	, m_Workers(threadCount)
+{
+	const QueueFamilyIndices queueFamilyIndices = FindQueueFamilies(context.vulkanContext.physicalDevice, context.vulkanContext.surface);
+
+	VkCommandPoolCreateInfo poolInfo{};
+	poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+	poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+	poolInfo.queueFamilyIndex = queueFamilyIndices.graphicsFamily.value();
+
+	for (auto& worker : m_Workers)
+	{
+		for (auto& commandPool : worker.commandPools)
+		{
+			if (vkCreateCommandPool(m_Device, &poolInfo, nullptr, &commandPool) != VK_SUCCESS)
+			{
+				throw std::runtime_error("failed to create worker command pool!");
+			}
+		}
+	}
+
+	// The vector is never resized again, the workers can keep a reference to their slot
+	for (auto& worker : m_Workers)
+		worker.thread = std::thread([this, &worker] { Work(worker); });
+}
+
+void real::ParallelRecorder::CleanUp(const GameContext& context)
+{
+	{
+		std::lock_guard lock(m_Mutex);
+		m_Quit = true;
+	}
+	m_WorkAvailable.notify_all();
+
+	for (auto& worker : m_Workers)
+	{
+		if (worker.thread.joinable())
+			worker.thread.join();
+
+		for (const auto commandPool : worker.commandPools)
+			vkDestroyCommandPool(context.vulkanContext.device, commandPool, nullptr);
+	}
+
+	m_Workers.clear();
+}
+
+void real::ParallelRecorder::BeginFrame(const GameContext& context, uint32_t frame)
+{
+	m_CurrentFrame = frame;
+
+	for (auto& worker : m_Workers)
+	{
+		vkResetCommandPool(context.vulkanContext.device, worker.commandPools[frame], 0);
+		worker.usedCommandBuffers = 0;
+	}
+}
+
+const std::vector<VkCommandBuffer>& real::ParallelRecorder::Record(const VkCommandBufferInheritanceInfo& inheritance, uint32_t jobCount,
+	const std::function<void(VkCommandBuffer, uint32_t)>& job)
+{
+	m_RecordedBuffers.assign(jobCount, nullptr);
+	if (jobCount == 0)
+		return m_RecordedBuffers;
+
+	{
+		std::lock_guard lock(m_Mutex);
+		m_pJob = &job;
+		m_pInheritance = &inheritance;
+		m_JobCount = jobCount;
+		m_NextJob = 0;
+		m_BusyWorkers = GetThreadCount();
+		++m_Generation;
+	}
+	m_WorkAvailable.notify_all();
+
+	{
+		std::unique_lock lock(m_Mutex);
+		m_WorkDone.wait(lock, [this] { return m_BusyWorkers == 0; });
+	}
+
+	return m_RecordedBuffers;
+}
+
+void real::ParallelRecorder::Work(Worker& worker)
+{
+	uint64_t generation = 0;
+	REAL_PROFILE_THREAD("Recorder " + std::to_string(&worker - m_Workers.data()));
+
+	while (true)
+	{
+		{
+			std::unique_lock lock(m_Mutex);
+			m_WorkAvailable.wait(lock, [this, generation] { return m_Quit || m_Generation != generation; });
+
+			if (m_Quit)
+				return;
+
+			generation = m_Generation;
+		}
+
+		for (uint32_t job = m_NextJob++; job < m_JobCount; job = m_NextJob++)
+		{
+			REAL_PROFILE_ZONE("Record secondary");
+
+			const auto commandBuffer = AcquireCommandBuffer(worker);
+
+			VkCommandBufferBeginInfo beginInfo{};
+			beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+			beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+			beginInfo.pInheritanceInfo = m_pInheritance;
+
+			if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS)
+			{
+				throw std::runtime_error("failed to begin recording secondary command buffer!");
+			}
+
+			// The materials push their constants into the active command buffer of the recording thread
+			CommandPool::SetThreadCommandBuffer(commandBuffer);
+			(*m_pJob)(commandBuffer, job);
+			CommandPool::SetThreadCommandBuffer(nullptr);
+
+			if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+			{
+				throw std::runtime_error("failed to record secondary command buffer!");
+			}
+
+			m_RecordedBuffers[job] = commandBuffer;
+		}
+
+		{
+			std::lock_guard lock(m_Mutex);
+			if (--m_BusyWorkers == 0)
+				m_WorkDone.notify_one();
+		}
+	}
+}
+
+VkCommandBuffer real::ParallelRecorder::AcquireCommandBuffer(Worker& worker) const
+{
+	auto& commandBuffers = worker.commandBuffers[m_CurrentFrame];
+
+	// Reused every frame after the pool got reset, only grows when a frame needs more jobs than before
+	if (worker.usedCommandBuffers == commandBuffers.size())
+	{
+		VkCommandBufferAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		allocInfo.commandPool = worker.commandPools[m_CurrentFrame];
+		allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+		allocInfo.commandBufferCount = 1;
+
+		VkCommandBuffer commandBuffer;
+		if (vkAllocateCommandBuffers(m_Device, &allocInfo, &commandBuffer) != VK_SUCCESS)
+		{
+			throw std::runtime_error("failed to allocate secondary command buffer!");
+		}
+
+		commandBuffers.push_back(commandBuffer);
+	}
+
+	return commandBuffers[worker.usedCommandBuffers++];
+}
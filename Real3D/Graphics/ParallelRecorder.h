@@ -0,0 +1,71 @@
+#ifndef PARALLELRECORDER_H
+#define PARALLELRECORDER_H
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+
+#include "Util/Structs.h"
+
+namespace real
+{
+	// Records jobs into secondary command buffers on a fixed set of worker threads.
+	// Command pools are externally synchronized, so every worker owns one per frame in flight.
+	class ParallelRecorder final
+	{
+	public:
+		explicit ParallelRecorder(const GameContext& context, uint32_t threadCount);
+		~ParallelRecorder() = default;
+
+		ParallelRecorder(const ParallelRecorder&) = delete;
+		ParallelRecorder& operator=(const ParallelRecorder&) = delete;
+		ParallelRecorder(ParallelRecorder&&) = delete;
+		ParallelRecorder& operator=(ParallelRecorder&&) = delete;
+
+		void CleanUp(const GameContext& context);
+
+		// The fence of the frame must have been waited on, its pools get reset
+		void BeginFrame(const GameContext& context, uint32_t frame);
+		// Every job is recorded into its own secondary, returned in the order of the jobs
+		const std::vector<VkCommandBuffer>& Record(const VkCommandBufferInheritanceInfo& inheritance, uint32_t jobCount,
+			const std::function<void(VkCommandBuffer, uint32_t)>& job);
+
+		uint32_t GetThreadCount() const { return static_cast<uint32_t>(m_Workers.size()); }
+
+	private:
+		struct Worker
+		{
+			std::array<VkCommandPool, MAX_FRAMES_IN_FLIGHT> commandPools{};
+			std::array<std::vector<VkCommandBuffer>, MAX_FRAMES_IN_FLIGHT> commandBuffers{};
+			uint32_t usedCommandBuffers{ 0 };
+			std::thread thread{};
+		};
+
+		VkDevice m_Device{ nullptr };
+		uint32_t m_CurrentFrame{ 0 };
+		std::vector<Worker> m_Workers{};
+
+		std::mutex m_Mutex{};
+		std::condition_variable m_WorkAvailable{}, m_WorkDone{};
+		uint64_t m_Generation{ 0 };
+		uint32_t m_BusyWorkers{ 0 };
+		bool m_Quit{ false };
+
+		// The work of the current Record call, the workers take the jobs in order
+		const std::function<void(VkCommandBuffer, uint32_t)>* m_pJob{ nullptr };
+		const VkCommandBufferInheritanceInfo* m_pInheritance{ nullptr };
+		uint32_t m_JobCount{ 0 };
+		std::atomic<uint32_t> m_NextJob{ 0 };
+		std::vector<VkCommandBuffer> m_RecordedBuffers{};
+
+		void Work(Worker& worker);
+		VkCommandBuffer AcquireCommandBuffer(Worker& worker) const;
+	};
+}
+
+#endif // PARALLELRECORDER_H
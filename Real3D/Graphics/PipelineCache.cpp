@@ -0,0 +1,120 @@
+#include "PipelineCache.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+void real::PipelineCache::Init(const GameContext& context, std::string filePath)
+{
+	m_FilePath = std::move(filePath);
+
+	std::vector<char> data{};
+	if (std::ifstream file(m_FilePath, std::ios::binary | std::ios::ate); file.is_open())
+	{
+		data.resize(static_cast<size_t>(file.tellg()));
+		file.seekg(0);
+		file.read(data.data(), static_cast<std::streamsize>(data.size()));
+	}
+
+	VkPhysicalDeviceProperties properties;
+	vkGetPhysicalDeviceProperties(context.vulkanContext.physicalDevice, &properties);
+
+	if (std::string reason; data.empty() == false && IsCompatible(data, properties, reason) == false)
+	{
+		std::cout << "\033[1;90mPipeline cache: discarded " << m_FilePath << ", " << reason << "\033[0m\n";
+		data.clear();
+	}
+
+	m_IsWarm = data.empty() == false;
+
+	VkPipelineCacheCreateInfo cacheInfo{};
+	cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+	cacheInfo.initialDataSize = data.size();
+	cacheInfo.pInitialData = data.data();
+
+	if (vkCreatePipelineCache(context.vulkanContext.device, &cacheInfo, nullptr, &m_PipelineCache) != VK_SUCCESS)
+	{
+		throw std::runtime_error("failed to create pipeline cache!");
+	}
+}
+
+void real::PipelineCache::CleanUp(const GameContext& context)
+{
+	const auto device = context.vulkanContext.device;
+
+	size_t size = 0;
+	vkGetPipelineCacheData(device, m_PipelineCache, &size, nullptr);
+
+	std::vector<char> data(size);
+	if (size > 0 && vkGetPipelineCacheData(device, m_PipelineCache, &size, data.data()) == VK_SUCCESS)
+	{
+		if (std::ofstream file(m_FilePath, std::ios::binary | std::ios::trunc); file.is_open())
+			file.write(data.data(), static_cast<std::streamsize>(size));
+	}
+
+	vkDestroyPipelineCache(device, m_PipelineCache, nullptr);
+	m_PipelineCache = nullptr;
+}
+
+VkResult real::PipelineCache::CreateGraphicsPipeline(VkDevice device, const VkGraphicsPipelineCreateInfo& createInfo, VkPipeline* pPipeline)
+{
+	const auto start = std::chrono::high_resolution_clock::now();
+	const auto result = vkCreateGraphicsPipelines(device, m_PipelineCache, 1, &createInfo, nullptr, pPipeline);
+
+	std::lock_guard lock(m_Mutex);
+	m_CreationTime += std::chrono::high_resolution_clock::now() - start;
+	++m_PipelineCount;
+
+	return result;
+}
+
+VkResult real::PipelineCache::CreateComputePipeline(VkDevice device, const VkComputePipelineCreateInfo& createInfo, VkPipeline* pPipeline)
+{
+	const auto start = std::chrono::high_resolution_clock::now();
+	const auto result = vkCreateComputePipelines(device, m_PipelineCache, 1, &createInfo, nullptr, pPipeline);
+
+	std::lock_guard lock(m_Mutex);
+	m_CreationTime += std::chrono::high_resolution_clock::now() - start;
+	++m_PipelineCount;
+
+	return result;
+}
+
+void real::PipelineCache::LogCreationTime() const
+{
+	// Summed over the threads that created them
+	std::cout << "\033[1;90mPipeline cache: " << m_PipelineCount << " pipelines created in " << m_CreationTime.count() << "ms ("
+		<< (m_IsWarm ? "warm" : "cold") << ")\033[0m\n";
+}
+
+bool real::PipelineCache::IsCompatible(const std::vector<char>& data, const VkPhysicalDeviceProperties& properties, std::string& reason)
+{
+	VkPipelineCacheHeaderVersionOne header{};
+	if (data.size() < sizeof(header))
+	{
+		reason = "the header is incomplete";
+		return false;
+	}
+
+	std::memcpy(&header, data.data(), sizeof(header));
+
+	if (header.headerSize < sizeof(header) || header.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE)
+	{
+		reason = "unknown header version";
+		return false;
+	}
+	if (header.vendorID != properties.vendorID || header.deviceID != properties.deviceID)
+	{
+		reason = "written by another device";
+		return false;
+	}
+	if (std::memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) != 0)
+	{
+		reason = "written by another driver";
+		return false;
+	}
+
+	return true;
+}
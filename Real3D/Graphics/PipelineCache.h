@@ -0,0 +1,58 @@
+#ifndef PIPELINECACHE_H
+#define PIPELINECACHE_H
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+
+#include <real_core/Singleton.h>
+
+#include "Util/Structs.h"
+
+namespace real
+{
+	// One VkPipelineCache shared by every pipeline, kept on disk so the driver does not compile the shaders again on every launch.
+	// A file written by another vendor, device or driver is discarded, the driver would ignore it at best.
+	class PipelineCache final : public Singleton<PipelineCache>
+	{
+	public:
+		virtual ~PipelineCache() override = default;
+
+		PipelineCache(const PipelineCache&) = delete;
+		PipelineCache& operator=(const PipelineCache&) = delete;
+		PipelineCache(PipelineCache&&) = delete;
+		PipelineCache& operator=(PipelineCache&&) = delete;
+
+		void Init(const GameContext& context, std::string filePath = "pipeline_cache.bin");  // NOLINT(clang-diagnostic-overloaded-virtual)
+		// Writes the cache back to its file
+		void CleanUp(const GameContext& context);
+
+		// Thread safe, the cache itself is synchronized by the driver
+		VkResult CreateGraphicsPipeline(VkDevice device, const VkGraphicsPipelineCreateInfo& createInfo, VkPipeline* pPipeline);
+		VkResult CreateComputePipeline(VkDevice device, const VkComputePipelineCreateInfo& createInfo, VkPipeline* pPipeline);
+
+		// Prints how long the pipelines created so far took, and whether the cache was warm
+		void LogCreationTime() const;
+
+		VkPipelineCache GetCache() const { return m_PipelineCache; }
+		bool IsWarm() const { return m_IsWarm; }
+
+	private:
+		friend class Singleton<PipelineCache>;
+		PipelineCache() = default;
+
+		VkPipelineCache m_PipelineCache{ nullptr };
+		std::string m_FilePath{};
+		bool m_IsWarm{ false };
+
+		std::mutex m_Mutex{};
+		uint32_t m_PipelineCount{ 0 };
+		std::chrono::duration<float, std::milli> m_CreationTime{};
+
+		static bool IsCompatible(const std::vector<char>& data, const VkPhysicalDeviceProperties& properties, std::string& reason);
+	};
+}
+
+#endif // PIPELINECACHE_H
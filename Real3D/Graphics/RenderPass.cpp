@@ -1,7 +1,9 @@
 #include "RenderPass.h"
 
 #include <array>
+#include <vector>
 
+#include "OitCompositor.h"
 #include "Core/DepthBuffer/DepthBuffer.h"
 
 void real::RenderPass::Create(const GameContext& context, VkFormat format)
@@ -14,7 +16,8 @@ void real::RenderPass::Create(const GameContext& context, VkFormat format)
 	colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
 	colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
 	colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-	colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+	// Headless there is no swap chain, the offscreen image is left ready to be copied from
+	colorAttachment.finalLayout = context.headless ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
 
 	VkAttachmentReference colorAttachmentRef;
 	colorAttachmentRef.attachment = 0;
@@ -24,7 +27,8 @@ void real::RenderPass::Create(const GameContext& context, VkFormat format)
 	depthAttachment.format = DepthBuffer::FindDepthFormat(context);
 	depthAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
 	depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-	depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+	// The DepthPyramid is built from the depth of the finished frame
+	depthAttachment.storeOp = context.occlusionCulling ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
 	depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
 	depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
 	depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
@@ -34,30 +38,126 @@ void real::RenderPass::Create(const GameContext& context, VkFormat format)
 	depthAttachmentRef.attachment = 1;
 	depthAttachmentRef.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
 
-	VkSubpassDescription subpass{};
-	subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
-	subpass.colorAttachmentCount = 1;
-	subpass.pColorAttachments = &colorAttachmentRef;
-	subpass.pDepthStencilAttachment = &depthAttachmentRef;
+	std::vector<VkSubpassDescription> subpasses{};
+
+	VkSubpassDescription opaqueSubpass{};
+	opaqueSubpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+	opaqueSubpass.colorAttachmentCount = 1;
+	opaqueSubpass.pColorAttachments = &colorAttachmentRef;
+	opaqueSubpass.pDepthStencilAttachment = &depthAttachmentRef;
+	subpasses.push_back(opaqueSubpass);
+
+	std::vector<VkSubpassDependency> dependencies{};
 
 	VkSubpassDependency dependency{};
 	dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
-	dependency.dstSubpass = 0;
+	dependency.dstSubpass = opaque_subpass;
 	dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
 	dependency.srcAccessMask = 0;
 	dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
 	dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+	dependencies.push_back(dependency);
+
+	std::vector attachments = { colorAttachment, depthAttachment };
+
+	// Weighted blended OIT: transparent geometry accumulates into two extra attachments,
+	// which get resolved on top of the opaque color in a last fullscreen subpass
+	const std::array oitColorRefs = {
+		VkAttachmentReference{ accumulation_attachment, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL },
+		VkAttachmentReference{ revealage_attachment, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL }
+	};
+	const std::array oitInputRefs = {
+		VkAttachmentReference{ accumulation_attachment, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL },
+		VkAttachmentReference{ revealage_attachment, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL }
+	};
+	const uint32_t preservedColorAttachment = 0;
+
+	if (context.weightedBlendedOit)
+	{
+		VkAttachmentDescription oitAttachment{};
+		oitAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+		oitAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+		oitAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+		oitAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+		oitAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+		oitAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		oitAttachment.finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+		oitAttachment.format = OitCompositor::accumulation_format;
+		attachments.push_back(oitAttachment);
+		oitAttachment.format = OitCompositor::revealage_format;
+		attachments.push_back(oitAttachment);
+
+		VkSubpassDescription transparentSubpass{};
+		transparentSubpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+		transparentSubpass.colorAttachmentCount = static_cast<uint32_t>(oitColorRefs.size());
+		transparentSubpass.pColorAttachments = oitColorRefs.data();
+		transparentSubpass.pDepthStencilAttachment = &depthAttachmentRef;
+		transparentSubpass.preserveAttachmentCount = 1;
+		transparentSubpass.pPreserveAttachments = &preservedColorAttachment;
+		subpasses.push_back(transparentSubpass);
+
+		VkSubpassDescription compositeSubpass{};
+		compositeSubpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+		compositeSubpass.colorAttachmentCount = 1;
+		compositeSubpass.pColorAttachments = &colorAttachmentRef;
+		compositeSubpass.inputAttachmentCount = static_cast<uint32_t>(oitInputRefs.size());
+		compositeSubpass.pInputAttachments = oitInputRefs.data();
+		subpasses.push_back(compositeSubpass);
+
+		// Both frames in flight share the accumulation and revealage images,
+		// the previous frame has to be done compositing them before they are cleared again
+		VkSubpassDependency oitDependency{};
+		oitDependency.srcSubpass = VK_SUBPASS_EXTERNAL;
+		oitDependency.dstSubpass = transparent_subpass;
+		oitDependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+		oitDependency.srcAccessMask = VK_ACCESS_INPUT_ATTACHMENT_READ_BIT;
+		oitDependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+		oitDependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+		dependencies.push_back(oitDependency);
+
+		// Transparent geometry is depth tested against the opaque geometry
+		VkSubpassDependency depthDependency{};
+		depthDependency.srcSubpass = opaque_subpass;
+		depthDependency.dstSubpass = transparent_subpass;
+		depthDependency.srcStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+		depthDependency.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+		depthDependency.dstStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+		depthDependency.dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
+		depthDependency.dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+		dependencies.push_back(depthDependency);
+
+		// The composite reads the accumulated values of the same pixel
+		VkSubpassDependency inputDependency{};
+		inputDependency.srcSubpass = transparent_subpass;
+		inputDependency.dstSubpass = composite_subpass;
+		inputDependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+		inputDependency.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+		inputDependency.dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+		inputDependency.dstAccessMask = VK_ACCESS_INPUT_ATTACHMENT_READ_BIT;
+		inputDependency.dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+		dependencies.push_back(inputDependency);
+
+		// The composite blends on top of the opaque color
+		VkSubpassDependency colorDependency{};
+		colorDependency.srcSubpass = opaque_subpass;
+		colorDependency.dstSubpass = composite_subpass;
+		colorDependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+		colorDependency.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+		colorDependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+		colorDependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+		colorDependency.dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+		dependencies.push_back(colorDependency);
+	}
 
-	const std::array attachments = { colorAttachment, depthAttachment };
 	VkRenderPassCreateInfo renderPassInfo{};
 	renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
 	renderPassInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
 	renderPassInfo.pAttachments = attachments.data();
-	renderPassInfo.subpassCount = 1;
-	renderPassInfo.pSubpasses = &subpass;
-	renderPassInfo.dependencyCount = 1;
-	renderPassInfo.pDependencies = &dependency;
-
+	renderPassInfo.subpassCount = static_cast<uint32_t>(subpasses.size());
+	renderPassInfo.pSubpasses = subpasses.data();
+	renderPassInfo.dependencyCount = static_cast<uint32_t>(dependencies.size());
+	renderPassInfo.pDependencies = dependencies.data();
 
 	if (vkCreateRenderPass(context.vulkanContext.device, &renderPassInfo, nullptr, &m_RenderPass) != VK_SUCCESS)
 	{
@@ -21,6 +21,13 @@ namespace real
 
 		void CleanUp(VkDevice device);
 
+		static constexpr uint32_t opaque_subpass = 0;
+		static constexpr uint32_t transparent_subpass = 1;
+		static constexpr uint32_t composite_subpass = 2;
+
+		static constexpr uint32_t accumulation_attachment = 2;
+		static constexpr uint32_t revealage_attachment = 3;
+
 	protected:
 		bool m_IsCreated{ false };
 		VkRenderPass m_RenderPass;
@@ -0,0 +1,178 @@
+#include "RenderQueue.h"
+
+#include <algorithm>
+#include <bit>
+
+#include "GpuProfiler.h"
+#include "ParallelRecorder.h"
+#include "Renderer.h"
+#include "Core/CommandBuffers/CachedCommandBuffer.h"
+#include "Material/BaseMaterial.h"
+
+void real::RenderQueue::Init(const GameContext& context)
+{
+	// Weighted blended transparency does not depend on the order, those draws only get grouped per material
+	m_SortTransparentByDepth = context.weightedBlendedOit == false;
+}
+
+void real::RenderQueue::Begin(const glm::mat4& view)
+{
+	m_View = view;
+	m_Packets.clear();
+	m_Stats = {};
+}
+
+void real::RenderQueue::Submit(RenderPassType pass, BaseMaterial* pMaterial, const glm::vec3& position,
+	std::function<void(VkCommandBuffer)> draw, CachedCommandBuffer* pCache)
+{
+	const float depth = -(m_View * glm::vec4(position, 1.f)).z;
+	m_Packets.emplace_back(CreateKey(pass, pMaterial->GetSortId(), depth), pMaterial, std::move(draw), pCache);
+}
+
+void real::RenderQueue::Sort()
+{
+	// Stable, so the packets that share a key keep the order they were submitted in
+	std::ranges::stable_sort(m_Packets, {}, &RenderPacket::key);
+	m_Stats.packets = static_cast<uint32_t>(m_Packets.size());
+}
+
+void real::RenderQueue::Execute(VkCommandBuffer commandBuffer, RenderPassType pass)
+{
+	const auto stats = Record(commandBuffer, GetPackets(pass));
+	m_Stats.pipelineBinds += stats.pipelineBinds;
+	m_Stats.descriptorBinds += stats.descriptorBinds;
+}
+
+void real::RenderQueue::ExecuteParallel(ParallelRecorder& recorder, VkCommandBuffer primary, const VkCommandBufferInheritanceInfo& inheritance,
+	std::initializer_list<RenderPassType> passes, const std::function<void(VkCommandBuffer)>& beginSecondary)
+{
+	const uint32_t frame = Renderer::GetInstance().GetCurrentFrame();
+
+	// Cached packets are a segment of their own, the packets in between are split in ranges for the worker threads
+	m_Segments.clear();
+	m_Ranges.clear();
+	const auto addRanges = [this, &recorder](std::span<const RenderPacket> packets)
+		{
+			const size_t rangeSize = std::max(min_packets_per_range, (packets.size() + recorder.GetThreadCount() - 1) / recorder.GetThreadCount());
+			for (size_t first = 0; first < packets.size(); first += rangeSize)
+			{
+				m_Segments.emplace_back(nullptr, static_cast<uint32_t>(m_Ranges.size()));
+				m_Ranges.push_back(packets.subspan(first, std::min(rangeSize, packets.size() - first)));
+			}
+		};
+
+	for (const auto pass : passes)
+	{
+		const auto packets = GetPackets(pass);
+
+		size_t first = 0;
+		for (size_t i = 0; i < packets.size(); ++i)
+		{
+			const auto pCache = packets[i].pCache;
+			if (pCache == nullptr)
+				continue;
+
+			addRanges(packets.subspan(first, i - first));
+			first = i + 1;
+
+			// Only recorded again when its owner invalidated it, on the main thread since the cache shares its pool
+			if (pCache->IsValid(frame, inheritance.subpass) == false)
+			{
+				pCache->Record(frame, inheritance, [&](VkCommandBuffer commandBuffer)
+					{
+						beginSecondary(commandBuffer);
+						const auto stats = Record(commandBuffer, packets.subspan(i, 1), false);
+						m_Stats.pipelineBinds += stats.pipelineBinds;
+						m_Stats.descriptorBinds += stats.descriptorBinds;
+					});
+			}
+			else
+			{
+				++m_Stats.cachedPackets;
+			}
+
+			m_Segments.emplace_back(pCache, 0);
+		}
+
+		addRanges(packets.subspan(first));
+	}
+
+	m_RangeStats.assign(m_Ranges.size(), {});
+	const auto& recorded = recorder.Record(inheritance, static_cast<uint32_t>(m_Ranges.size()),
+		[this, &beginSecondary](VkCommandBuffer commandBuffer, uint32_t range)
+		{
+			// Nothing is inherited from the primary besides the render pass, the dynamic state has to be set again
+			beginSecondary(commandBuffer);
+			m_RangeStats[range] = Record(commandBuffer, m_Ranges[range]);
+		});
+
+	for (const auto& stats : m_RangeStats)
+	{
+		m_Stats.pipelineBinds += stats.pipelineBinds;
+		m_Stats.descriptorBinds += stats.descriptorBinds;
+	}
+
+	m_SecondaryBuffers.clear();
+	for (const auto& [pCache, range] : m_Segments)
+		m_SecondaryBuffers.push_back(pCache != nullptr ? pCache->GetCommandBuffer(frame) : recorded[range]);
+
+	if (m_SecondaryBuffers.empty() == false)
+		vkCmdExecuteCommands(primary, static_cast<uint32_t>(m_SecondaryBuffers.size()), m_SecondaryBuffers.data());
+}
+
+uint64_t real::RenderQueue::CreateKey(RenderPassType pass, uint16_t material, float depth) const
+{
+	// The bits of a positive float sort the same way as its value
+	const uint64_t depthBits = std::bit_cast<uint32_t>(std::max(depth, 0.f));
+	const uint64_t key = static_cast<uint64_t>(pass) << pass_shift;
+
+	// The regions of one model share their depth, they must stay in the back to front order they were submitted in
+	if (pass == RenderPassType::transparent && m_SortTransparentByDepth)
+		return key | (~depthBits & 0xFFFFFFFF);
+
+	return key | static_cast<uint64_t>(material) << 44 | depthBits;
+}
+
+std::span<const real::RenderPacket> real::RenderQueue::GetPackets(RenderPassType pass) const
+{
+	const uint64_t passBits = static_cast<uint64_t>(pass);
+	const auto first = std::ranges::lower_bound(m_Packets, passBits << pass_shift, {}, &RenderPacket::key);
+	const auto last = std::ranges::lower_bound(m_Packets, (passBits + 1) << pass_shift, {}, &RenderPacket::key);
+
+	return { first, last };
+}
+
+real::RenderStats real::RenderQueue::Record(VkCommandBuffer commandBuffer, std::span<const RenderPacket> packets, bool profile)
+{
+	RenderStats stats{};
+	auto& profiler = GpuProfiler::GetInstance();
+	profile = profile && profiler.IsSupported();
+
+	// Anything recorded outside the queue might have bound another pipeline in between
+	const BaseMaterial* pBoundMaterial = nullptr;
+	uint32_t scope = GpuProfiler::no_scope;
+	for (const auto& [key, pMaterial, draw, pCache] : packets)
+	{
+		if (pMaterial != pBoundMaterial)
+		{
+			if (profile)
+			{
+				profiler.EndScope(commandBuffer, scope);
+				scope = profiler.BeginScope(commandBuffer, pMaterial->GetName());
+			}
+
+			pMaterial->Bind(commandBuffer);
+			pBoundMaterial = pMaterial;
+
+			++stats.pipelineBinds;
+			if (pMaterial->HasDescriptorSet())
+				++stats.descriptorBinds;
+		}
+
+		draw(commandBuffer);
+	}
+
+	profiler.EndScope(commandBuffer, scope);
+
+	return stats;
+}
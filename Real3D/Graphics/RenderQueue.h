@@ -0,0 +1,110 @@
+#ifndef RENDERQUEUE_H
+#define RENDERQUEUE_H
+
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <span>
+#include <vector>
+#include <glm/glm.hpp>
+#include <vulkan/vulkan_core.h>
+
+#include <real_core/Singleton.h>
+
+#include "Util/Structs.h"
+
+namespace real
+{
+	class BaseMaterial;
+	class CachedCommandBuffer;
+	class ParallelRecorder;
+
+	enum class RenderPassType : uint8_t
+	{
+		opaque = 0,
+		transparent = 1,
+		// Drawn last, after the transparent composite when there is one, e.g. the gui
+		overlay = 2,
+	};
+
+	struct RenderPacket
+	{
+		uint64_t key{};
+		BaseMaterial* pMaterial{ nullptr };
+		std::function<void(VkCommandBuffer)> draw{};
+		// Replays the draw without recording it when the scene is recorded into secondary command buffers
+		CachedCommandBuffer* pCache{ nullptr };
+	};
+
+	struct RenderStats
+	{
+		uint32_t packets{ 0 };
+		uint32_t pipelineBinds{ 0 };
+		uint32_t descriptorBinds{ 0 };
+		uint32_t cachedPackets{ 0 };
+	};
+
+	// Drawables submit their draws as packets instead of recording them, the packets get sorted once per frame
+	// so every pass is drawn grouped per material and the redundant binds in between get skipped.
+	class RenderQueue final : public Singleton<RenderQueue>
+	{
+	public:
+		virtual ~RenderQueue() override = default;
+
+		RenderQueue(const RenderQueue&) = delete;
+		RenderQueue& operator=(const RenderQueue&) = delete;
+		RenderQueue(RenderQueue&&) = delete;
+		RenderQueue& operator=(RenderQueue&&) = delete;
+
+		void Init(const GameContext& context);  // NOLINT(clang-diagnostic-overloaded-virtual)
+
+		// Clears the packets of the previous frame, the depth of every packet is measured in this view
+		void Begin(const glm::mat4& view);
+		void Submit(RenderPassType pass, BaseMaterial* pMaterial, const glm::vec3& position, std::function<void(VkCommandBuffer)> draw,
+			CachedCommandBuffer* pCache = nullptr);
+
+		void Sort();
+		void Execute(VkCommandBuffer commandBuffer, RenderPassType pass);
+		// Splits the passes in ranges that are recorded on the worker threads, the secondaries keep the sorted order.
+		// The draws only read their state, anything that has to be resolved first is done when they are submitted.
+		void ExecuteParallel(ParallelRecorder& recorder, VkCommandBuffer primary, const VkCommandBufferInheritanceInfo& inheritance,
+			std::initializer_list<RenderPassType> passes, const std::function<void(VkCommandBuffer)>& beginSecondary);
+
+		const RenderStats& GetStats() const { return m_Stats; }
+
+	private:
+		friend class Singleton<RenderQueue>;
+		RenderQueue() = default;
+
+		// Bits 63..60 hold the pass, then either the material in 59..44 and the depth in 31..0, drawn front to back,
+		// or only the inverted depth in 31..0 for the blended transparent pass, drawn back to front
+		static constexpr uint64_t pass_shift = 60;
+		// Smaller ranges are not worth the extra secondary command buffer
+		static constexpr size_t min_packets_per_range = 64;
+
+		std::vector<RenderPacket> m_Packets{};
+		glm::mat4 m_View{ 1.f };
+		bool m_SortTransparentByDepth{ true };
+
+		RenderStats m_Stats{};
+
+		// Either a cached packet or one of the ranges recorded on the worker threads
+		struct Segment
+		{
+			CachedCommandBuffer* pCache{ nullptr };
+			uint32_t range{ 0 };
+		};
+
+		std::vector<Segment> m_Segments{};
+		std::vector<std::span<const RenderPacket>> m_Ranges{};
+		std::vector<RenderStats> m_RangeStats{};
+		std::vector<VkCommandBuffer> m_SecondaryBuffers{};
+
+		uint64_t CreateKey(RenderPassType pass, uint16_t material, float depth) const;
+		std::span<const RenderPacket> GetPackets(RenderPassType pass) const;
+		// Every material gets a gpu profiler scope, unless the commands are cached and replayed in later frames
+		static RenderStats Record(VkCommandBuffer commandBuffer, std::span<const RenderPacket> packets, bool profile = true);
+	};
+}
+
+#endif // RENDERQUEUE_H
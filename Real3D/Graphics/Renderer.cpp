@@ -1,15 +1,29 @@
 #include "Renderer.h"
 
 #include <array>
+#include <initializer_list>
 #include <vulkan/vulkan_core.h>
 
+#include <real_core/CpuProfiler.h>
+
 #include "RealEngine.h"
+#include "DepthPyramid.h"
+#include "GpuProfiler.h"
+#include "OitCompositor.h"
+#include "ParallelRecorder.h"
 #include "RenderPass.h"
+#include "RenderQueue.h"
 #include "Core/SwapChain.h"
 #include "Core/CommandPool.h"
 #include "Core/CommandBuffers/CommandBuffer.h"
+#include "Core/DescriptorPoolManager.h"
+#include "Core/UploadManager.h"
 #include "Core/DepthBuffer/DepthBufferManager.h"
+#include "Material/CameraBuffer.h"
 #include "Material/MaterialManager.h"
+#include "Misc/Camera.h"
+#include "Misc/CameraManager.h"
+#include "ImGui/imgui_impl_vulkan.h"
 #include "real_core/SceneManager.h"
 
 void real::Renderer::Init(GameContext& context)
@@ -22,7 +36,10 @@ void real::Renderer::Init(GameContext& context)
 
 	// Create Swap chain
 	m_pSwapChain = new SwapChain();
-	m_pSwapChain->CreateSwapChain(context);
+	if (context.headless)
+		m_pSwapChain->CreateOffscreenImages(context);
+	else
+		m_pSwapChain->CreateSwapChain(context);
 
 	// Create Image Views
 	m_pSwapChain->CreateSwapChainImages(context);
@@ -32,14 +49,23 @@ void real::Renderer::Init(GameContext& context)
 	renderPass->Create(context, m_pSwapChain->GetFormat());
 	context.vulkanContext.renderPass = renderPass->GetRenderPass();
 
+	// Create OIT Attachments
+	if (context.weightedBlendedOit)
+		m_pOitCompositor = new OitCompositor(context);
+
 	// Create Depth Buffer
 	DepthBufferManager::GetInstance().AddDepthBuffer(context);
+	m_pDepthPyramid = new DepthPyramid(context);
 
 	// Create Frame Buffers
 	CreateFrameBuffers(context);
 
 	// Create Sync Objects
 	CreateSyncObjects(context);
+
+	// Create Worker Threads
+	if (context.recordingThreads > 0)
+		m_pRecorder = new ParallelRecorder(context, context.recordingThreads);
 }
 
 void real::Renderer::CleanUp(const GameContext& context) const
@@ -56,6 +82,21 @@ void real::Renderer::CleanUp(const GameContext& context) const
 		vkDestroyFramebuffer(context.vulkanContext.device, frameBuffer, nullptr);
 	}
 
+	if (m_pOitCompositor != nullptr)
+	{
+		m_pOitCompositor->CleanUp(context);
+		delete m_pOitCompositor;
+	}
+
+	if (m_pRecorder != nullptr)
+	{
+		m_pRecorder->CleanUp(context);
+		delete m_pRecorder;
+	}
+
+	m_pDepthPyramid->CleanUp(context);
+	delete m_pDepthPyramid;
+
 	m_pSwapChain->CleanUp(context);
 }
 
@@ -67,11 +108,17 @@ void real::Renderer::CreateFrameBuffers(const GameContext& context)
 	m_SwapChainFrameBuffers.resize(swapChainImageViews.size());
 	for (size_t i = 0; i < swapChainImageViews.size(); ++i)
 	{
-		std::array attachments{
+		std::vector attachments{
 			swapChainImageViews[i],
 			DepthBufferManager::GetInstance().GetDepthBuffer(0)->GetImageView()
 		};
 
+		if (m_pOitCompositor != nullptr)
+		{
+			attachments.push_back(m_pOitCompositor->GetAccumulationImageView());
+			attachments.push_back(m_pOitCompositor->GetRevealageImageView());
+		}
+
 		VkFramebufferCreateInfo framebufferInfo{};
 		framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
 		framebufferInfo.renderPass = context.vulkanContext.renderPass;
@@ -114,12 +161,22 @@ void real::Renderer::CreateSyncObjects(const GameContext& context)
 
 void real::Renderer::Draw(const GameContext& context)
 {
+	REAL_PROFILE_ZONE("Renderer::Draw");
+
 	vkWaitForFences(context.vulkanContext.device, 1, &m_InFlightFences[m_CurrentFrame], VK_TRUE, UINT64_MAX);
 	vkResetFences(context.vulkanContext.device, 1, &m_InFlightFences[m_CurrentFrame]);
 
-	uint32_t imageIndex;
-	vkAcquireNextImageKHR(context.vulkanContext.device, m_pSwapChain->GetSwapChain(), UINT64_MAX,
-	                      m_ImageAvailableSemaphores[m_CurrentFrame], VK_NULL_HANDLE, &imageIndex);
+	// The gpu is done with the transient descriptor sets of this frame
+	DescriptorPoolManager::GetInstance().BeginFrame(m_CurrentFrame);
+
+	// Every frame in flight has its own offscreen image, the fence above guarantees the gpu is done with it
+	const bool isOffscreen = m_pSwapChain->IsOffscreen();
+	uint32_t imageIndex = m_CurrentFrame;
+	if (isOffscreen == false)
+	{
+		vkAcquireNextImageKHR(context.vulkanContext.device, m_pSwapChain->GetSwapChain(), UINT64_MAX,
+			m_ImageAvailableSemaphores[m_CurrentFrame], VK_NULL_HANDLE, &imageIndex);
+	}
 
 	VkRenderPassBeginInfo renderPassInfo{};
 	renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
@@ -128,15 +185,36 @@ void real::Renderer::Draw(const GameContext& context)
 	renderPassInfo.renderArea.offset = { 0, 0 };
 	renderPassInfo.renderArea.extent = m_pSwapChain->GetExtent();
 
-	std::array<VkClearValue, 2> clearValues{};
+	std::array<VkClearValue, 4> clearValues{};
 	clearValues[0].color = { {0.392f, 0.584f, 0.929f, 1.0f} };
 	clearValues[1].depthStencil = { 1.0f, 0 };
-	renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
+	clearValues[RenderPass::accumulation_attachment].color = { {0.0f, 0.0f, 0.0f, 0.0f} };
+	clearValues[RenderPass::revealage_attachment].color = { {1.0f, 0.0f, 0.0f, 0.0f} };
+	renderPassInfo.clearValueCount = m_pOitCompositor != nullptr ? static_cast<uint32_t>(clearValues.size()) : 2;
 	renderPassInfo.pClearValues = clearValues.data();
 
 	const auto commandBuffer = CommandPool::GetInstance().GetCommandBuffer()->SetCommandBufferActive(m_CurrentFrame);
 	CommandBuffer::StartRecording(commandBuffer);
-	vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+
+	// The scopes inside the render pass can only be written to the primary while its contents are inline,
+	// with secondaries only the materials recorded on the worker threads are measured
+	auto& profiler = GpuProfiler::GetInstance();
+	profiler.BeginFrame(commandBuffer, m_CurrentFrame);
+	const auto frameScope = profiler.BeginScope(commandBuffer, "Frame");
+
+	if (m_pRecorder != nullptr)
+		m_pRecorder->BeginFrame(context, m_CurrentFrame);
+
+	// Compute passes can not be recorded inside the render pass
+	const auto preRenderScope = profiler.BeginScope(commandBuffer, "Pre render");
+	SceneManager::GetInstance().PreRender();
+	profiler.EndScope(commandBuffer, preRenderScope);
+
+	// The scene only submits its draws, they get recorded per pass in the order of their sort keys
+	auto& renderQueue = RenderQueue::GetInstance();
+	renderQueue.Begin(CameraManager::GetInstance().GetActiveCamera()->GetView());
+	SceneManager::GetInstance().Render();
+	renderQueue.Sort();
 
 	VkViewport viewport{};
 	viewport.x = 0.0f;
@@ -145,16 +223,89 @@ void real::Renderer::Draw(const GameContext& context)
 	viewport.height = (float)m_pSwapChain->GetExtent().height;
 	viewport.minDepth = 0.0f;
 	viewport.maxDepth = 1.0f;
-	vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
 
 	VkRect2D scissor{};
 	scissor.offset = { 0, 0 };
 	scissor.extent = m_pSwapChain->GetExtent();
-	vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
 
-	//TODO: Call SceneManager::Render instead
+	// The camera is bound once per command buffer, every material pipeline layout is compatible with it at set 0
+	CameraBuffer::GetInstance().Update(m_CurrentFrame);
+	const auto setState = [&](VkCommandBuffer buffer)
+		{
+			vkCmdSetViewport(buffer, 0, 1, &viewport);
+			vkCmdSetScissor(buffer, 0, 1, &scissor);
+			CameraBuffer::GetInstance().Bind(buffer, m_CurrentFrame);
+		};
+	setState(commandBuffer);
 
-	SceneManager::GetInstance().Render();
+	// A subpass with secondary contents can only execute the secondaries, the compositor is always drawn inline
+	const auto sceneContents = m_pRecorder != nullptr ? VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS : VK_SUBPASS_CONTENTS_INLINE;
+	const auto getInheritanceInfo = [&](uint32_t subpass)
+		{
+			VkCommandBufferInheritanceInfo inheritanceInfo{};
+			inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+			inheritanceInfo.renderPass = context.vulkanContext.renderPass;
+			inheritanceInfo.subpass = subpass;
+			inheritanceInfo.framebuffer = m_SwapChainFrameBuffers[imageIndex];
+			return inheritanceInfo;
+		};
+	const auto recordPasses = [&](uint32_t subpass, std::initializer_list<RenderPassType> passes)
+		{
+			if (m_pRecorder == nullptr)
+			{
+				for (const auto pass : passes)
+					renderQueue.Execute(commandBuffer, pass);
+				return;
+			}
+
+			renderQueue.ExecuteParallel(*m_pRecorder, commandBuffer, getInheritanceInfo(subpass), passes, setState);
+		};
+
+	// The gui is built before the frame is drawn, it ends up on top of everything in the last subpass
+	const auto pGuiData = context.profiling && context.headless == false ? ImGui::GetDrawData() : nullptr;
+	const auto drawGui = [&](VkCommandBuffer buffer)
+		{
+			const auto scope = profiler.BeginScope(buffer, "ImGui");
+			ImGui_ImplVulkan_RenderDrawData(pGuiData, buffer);
+			profiler.EndScope(buffer, scope);
+		};
+
+	const auto renderPassScope = profiler.BeginScope(commandBuffer, "Render pass");
+	vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, sceneContents);
+
+	if (m_pOitCompositor != nullptr)
+	{
+		recordPasses(0, { RenderPassType::opaque });
+
+		vkCmdNextSubpass(commandBuffer, sceneContents);
+		recordPasses(1, { RenderPassType::transparent });
+
+		vkCmdNextSubpass(commandBuffer, VK_SUBPASS_CONTENTS_INLINE);
+		const auto compositeScope = profiler.BeginScope(commandBuffer, "OIT composite");
+		m_pOitCompositor->Draw(commandBuffer);
+		profiler.EndScope(commandBuffer, compositeScope);
+
+		// The overlay goes on top of the composited transparents, the compositor replaced the camera set
+		setState(commandBuffer);
+		renderQueue.Execute(commandBuffer, RenderPassType::overlay);
+
+		if (pGuiData != nullptr)
+			drawGui(commandBuffer);
+	}
+	else
+	{
+		recordPasses(0, { RenderPassType::opaque, RenderPassType::transparent, RenderPassType::overlay });
+
+		if (pGuiData != nullptr && m_pRecorder != nullptr)
+		{
+			const auto& guiBuffers = m_pRecorder->Record(getInheritanceInfo(0), 1, [&](VkCommandBuffer buffer, uint32_t) { drawGui(buffer); });
+			vkCmdExecuteCommands(commandBuffer, static_cast<uint32_t>(guiBuffers.size()), guiBuffers.data());
+		}
+		else if (pGuiData != nullptr)
+		{
+			drawGui(commandBuffer);
+		}
+	}
 
 	//for (const auto& pMaterial : MaterialManager::GetInstance().GetMaterials())
 	//{
@@ -163,14 +314,27 @@ void real::Renderer::Draw(const GameContext& context)
 	//}
 
 	vkCmdEndRenderPass(commandBuffer);
+	profiler.EndScope(commandBuffer, renderPassScope);
+
+	// Read by the cull pass of the next frame
+	if (m_pDepthPyramid->IsEnabled())
+	{
+		const auto pyramidScope = profiler.BeginScope(commandBuffer, "Depth pyramid");
+		m_pDepthPyramid->Build(commandBuffer);
+		profiler.EndScope(commandBuffer, pyramidScope);
+	}
+	profiler.EndScope(commandBuffer, frameScope);
 	CommandBuffer::StopRecording(commandBuffer);
 
+	// The copies recorded this frame have to be submitted before the draws that read them
+	UploadManager::GetInstance().Flush(context);
+
 	VkSubmitInfo submitInfo{};
 	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 
 	VkSemaphore waitSemaphores[] = { m_ImageAvailableSemaphores[m_CurrentFrame] };
 	VkPipelineStageFlags waitStages[] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
-	submitInfo.waitSemaphoreCount = 1;
+	submitInfo.waitSemaphoreCount = isOffscreen ? 0 : 1;
 	submitInfo.pWaitSemaphores = waitSemaphores;
 	submitInfo.pWaitDstStageMask = waitStages;
 
@@ -178,13 +342,19 @@ void real::Renderer::Draw(const GameContext& context)
 	submitInfo.pCommandBuffers = &commandBuffer;
 
 	VkSemaphore signalSemaphores[] = { m_RenderFinishedSemaphores[m_CurrentFrame] };
-	submitInfo.signalSemaphoreCount = 1;
+	submitInfo.signalSemaphoreCount = isOffscreen ? 0 : 1;
 	submitInfo.pSignalSemaphores = signalSemaphores;
 
 	if (vkQueueSubmit(m_GraphicsQueue, 1, &submitInfo, m_InFlightFences[m_CurrentFrame]) != VK_SUCCESS) {
 		throw std::runtime_error("failed to submit draw command buffer!");
 	}
 
+	if (isOffscreen)
+	{
+		m_CurrentFrame = (m_CurrentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
+		return;
+	}
+
 	VkPresentInfoKHR presentInfo{};
 	presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
 
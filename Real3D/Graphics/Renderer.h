@@ -9,6 +9,9 @@
 namespace real
 {
 	class SwapChain;
+	class OitCompositor;
+	class DepthPyramid;
+	class ParallelRecorder;
 
 	class Renderer final : public real::Singleton<Renderer>
 	{
@@ -26,6 +29,7 @@ namespace real
 		void Draw(const GameContext& context);
 
 		SwapChain* GetSwapChain() const { return m_pSwapChain; }
+		DepthPyramid* GetDepthPyramid() const { return m_pDepthPyramid; }
 
 		uint32_t GetCurrentFrame() const { return m_CurrentFrame; }
 		VkFramebuffer GetCurrentFrameBuffer() const { return m_SwapChainFrameBuffers[m_CurrentFrame]; }
@@ -42,6 +46,9 @@ namespace real
 		std::vector<VkSemaphore> m_ImageAvailableSemaphores, m_RenderFinishedSemaphores;
 		std::vector<VkFence> m_InFlightFences;
 		SwapChain* m_pSwapChain;
+		OitCompositor* m_pOitCompositor{ nullptr };
+		DepthPyramid* m_pDepthPyramid{ nullptr };
+		ParallelRecorder* m_pRecorder{ nullptr };
 		std::vector<VkFramebuffer> m_SwapChainFrameBuffers;
 
 		void CreateFrameBuffers(const GameContext& context);
@@ -13,9 +13,13 @@ VkPipelineShaderStageCreateInfo real::ShaderManager::CreateShaderInfo(const VkDe
                                                                 const std::string& fileName,
                                                                 const char* entryPoint)
 {
-	if (m_ShaderPtrs.find(fileName) != m_ShaderPtrs.end())
-		return m_ShaderPtrs[fileName];
+	{
+		std::lock_guard lock(m_Mutex);
+		if (m_ShaderPtrs.find(fileName) != m_ShaderPtrs.end())
+			return m_ShaderPtrs[fileName];
+	}
 
+	// Read and compiled outside of the lock, so different shaders can load at the same time
 	const auto filepath = m_ShaderDataPath + '/' + fileName;
 	const std::vector<char> shaderCode = ReadFile(filepath);
 	const VkShaderModule shaderModule = CreateShaderModule(device, shaderCode);
@@ -26,8 +30,16 @@ VkPipelineShaderStageCreateInfo real::ShaderManager::CreateShaderInfo(const VkDe
 	shaderStageInfo.module = shaderModule;
 	shaderStageInfo.pName = entryPoint;
 
-	m_ShaderPtrs[fileName] = shaderStageInfo;
-	return m_ShaderPtrs[fileName];
+	std::lock_guard lock(m_Mutex);
+
+	// Another thread might have loaded the same shader in the meantime
+	if (const auto [it, inserted] = m_ShaderPtrs.try_emplace(fileName, shaderStageInfo); inserted == false)
+	{
+		vkDestroyShaderModule(device, shaderModule, nullptr);
+		return it->second;
+	}
+
+	return shaderStageInfo;
 }
 
 void real::ShaderManager::DestroyShaderModules(VkDevice device)
@@ -2,6 +2,7 @@
 #define SHADERMANAGER_H
 
 #include <map>
+#include <mutex>
 #include <string>
 
 #include <real_core/Singleton.h>
@@ -16,6 +17,7 @@ namespace real
 		fragment = 1,
 		geometry = 2,
 		//tessellation = 3,
+		compute = 4,
 	};
 
 	class ShaderManager final : public real::Singleton<ShaderManager>
@@ -24,6 +26,7 @@ namespace real
 		void Init(std::string shaderSourcePath);  // NOLINT(clang-diagnostic-overloaded-virtual)
 		virtual ~ShaderManager() override = default;
 
+		// Thread safe, the materials create their pipelines in parallel
 		VkPipelineShaderStageCreateInfo CreateShaderInfo(const VkDevice& device, ShaderType type, const std::string&
 														 fileName, const char* entryPoint = "main");
 
@@ -32,6 +35,7 @@ namespace real
 	private:
 		std::string m_ShaderDataPath{};
 		std::map<std::string, VkPipelineShaderStageCreateInfo> m_ShaderPtrs;
+		std::mutex m_Mutex{};
 
 		friend class Singleton<ShaderManager>;
 		ShaderManager() = default;
@@ -43,6 +47,7 @@ namespace real
 			{ShaderType::vertex, VK_SHADER_STAGE_VERTEX_BIT},
 			{ShaderType::fragment, VK_SHADER_STAGE_FRAGMENT_BIT},
 			{ShaderType::geometry, VK_SHADER_STAGE_GEOMETRY_BIT},
+			{ShaderType::compute, VK_SHADER_STAGE_COMPUTE_BIT},
 		};
 	};
 }
@@ -1,10 +1,29 @@
 #include "BaseMaterial.h"
 
+#include <vector>
+
+#include "CameraBuffer.h"
+#include "PipelineRegistry.h"
 #include "Graphics/Renderer.h"
 
-void real::BaseMaterial::Bind(VkCommandBuffer buffer, uint32_t reference)
+void real::BaseMaterial::Bind(VkCommandBuffer buffer) const
 {
 	vkCmdBindPipeline(buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_Pipeline);
-	vkCmdBindDescriptorSets(buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_PipelineLayout, 0, 1,
-		&m_DescriptorSets[reference][real::Renderer::GetInstance().GetCurrentFrame()], 0, nullptr);
+
+	if (const auto descriptorSet = m_DescriptorSets[real::Renderer::GetInstance().GetCurrentFrame()];
+		descriptorSet != nullptr)
+	{
+		vkCmdBindDescriptorSets(buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_PipelineLayout, 1, 1,
+			&descriptorSet, 0, nullptr);
+	}
+}
+
+void real::BaseMaterial::CreatePipelineLayout(VkDevice device)
+{
+	std::vector setLayouts = { CameraBuffer::GetInstance().GetDescriptorSetLayout() };
+	if (m_DescriptorSetLayout != nullptr)
+		setLayouts.push_back(m_DescriptorSetLayout);
+
+	// Materials with the same set layouts share the layout, and with it the pipelines they have in common
+	m_PipelineLayout = PipelineRegistry::GetInstance().GetPipelineLayout(device, setLayouts, { CameraBuffer::GetPushConstantRange() });
 }
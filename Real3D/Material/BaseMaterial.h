@@ -1,8 +1,8 @@
 #ifndef BASEMATERIAL_H
 #define BASEMATERIAL_H
 
+#include <array>
 #include <cstdint>
-#include <map>
 
 #include <vulkan/vulkan.h>
 
@@ -13,7 +13,7 @@ namespace real
 	class BaseMaterial
 	{
 	public:
-		BaseMaterial() = default;
+		BaseMaterial() : m_SortId(m_SortIdCounter++) {}
 		virtual ~BaseMaterial() = default;
 
 		BaseMaterial(const BaseMaterial&) = delete;
@@ -21,25 +21,36 @@ namespace real
 		BaseMaterial(BaseMaterial&&) = delete;
 		BaseMaterial& operator=(BaseMaterial&&) = delete;
 
+		// Creates everything the pipeline depends on, the pipeline itself is built by InitPipeline
 		virtual void Init() = 0;
+		// Has to be thread safe, the MaterialManager builds the pipelines of all materials at the same time
+		virtual void InitPipeline() = 0;
 		virtual void CleanUp() = 0;
 
-		virtual void CleanUpUbo(uint32_t reference) = 0;
+		// Readable name for the profiler and the console, typeid names are mangled on some compilers
+		virtual const char* GetName() const = 0;
 
-		void Bind(VkCommandBuffer buffer, uint32_t reference);
+		void Bind(VkCommandBuffer buffer) const;
+		bool HasDescriptorSet() const { return m_DescriptorSetLayout != nullptr; }
 
+		// Every material owns a single pipeline, so this id also groups the draws per pipeline
+		uint16_t GetSortId() const { return m_SortId; }
 
 	protected:
 		VkPipeline m_Pipeline{ nullptr };
 		VkPipelineLayout m_PipelineLayout{ nullptr };
 
-		std::map<uint32_t, std::array<VkBuffer, MAX_FRAMES_IN_FLIGHT>> m_UniformBuffers{};
-		std::map<uint32_t, std::array<VmaAllocation, MAX_FRAMES_IN_FLIGHT>> m_UniformBufferAllocations{};
-		std::map<uint32_t, std::array<void*, MAX_FRAMES_IN_FLIGHT>> m_UniformBuffersMapped{};
-
+		// Set 1, holds the resources shared by everything drawn with this material. The layout is owned by the DescriptorPoolManager
 		VkDescriptorSetLayout m_DescriptorSetLayout{ nullptr };
-		std::map<uint32_t, std::array<VkDescriptorSet, MAX_FRAMES_IN_FLIGHT>> m_DescriptorSets{};
+		std::array<VkDescriptorSet, MAX_FRAMES_IN_FLIGHT> m_DescriptorSets{};
+
+		// Set 0 is the camera, set 1 the layout of the material if it has one
+		void CreatePipelineLayout(VkDevice device);
+
+	private:
+		uint16_t m_SortId;
+		inline static uint16_t m_SortIdCounter{ 0 };
 	};
 }
 
-#endif // BASEMATERIAL_H
\ No newline at end of file
+#endif // BASEMATERIAL_H
@@ -0,0 +1,92 @@
+#include "CameraBuffer.h"
+
+#include <stdexcept>
+
+#include "Core/DescriptorPoolManager.h"
+#include "Misc/Camera.h"
+#include "Misc/CameraManager.h"
+
+void real::CameraBuffer::Init(const GameContext& context)
+{
+	VkDescriptorSetLayoutBinding uboLayoutBinding{};
+	uboLayoutBinding.binding = 0;
+	uboLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+	uboLayoutBinding.descriptorCount = 1;
+	uboLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+	uboLayoutBinding.pImmutableSamplers = nullptr;
+
+	auto& descriptorPoolManager = DescriptorPoolManager::GetInstance();
+	m_DescriptorSetLayout = descriptorPoolManager.GetDescriptorSetLayout({ &uboLayoutBinding, 1 });
+
+	// Only used to bind set 0, it is compatible with the layout of every material
+	const auto pushConstantRange = GetPushConstantRange();
+
+	VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+	pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+	pipelineLayoutInfo.setLayoutCount = 1;
+	pipelineLayoutInfo.pSetLayouts = &m_DescriptorSetLayout;
+	pipelineLayoutInfo.pushConstantRangeCount = 1;
+	pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+
+	if (vkCreatePipelineLayout(context.vulkanContext.device, &pipelineLayoutInfo, nullptr, &m_PipelineLayout) != VK_SUCCESS)
+	{
+		throw std::runtime_error("failed to create pipeline layout!");
+	}
+
+	for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
+	{
+		CreateBuffer(context, sizeof(CameraUbo), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, m_Buffers[i], m_Allocations[i],
+			EMemoryCategory::uniform);
+		vmaMapMemory(context.vulkanContext.allocator, m_Allocations[i], &m_pMappedData[i]);
+
+		DescriptorResource resource{};
+		resource.binding = 0;
+		resource.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+		resource.bufferInfo.buffer = m_Buffers[i];
+		resource.bufferInfo.offset = 0;
+		resource.bufferInfo.range = sizeof(CameraUbo);
+
+		m_DescriptorSets[i] = descriptorPoolManager.GetDescriptorSet(m_DescriptorSetLayout, { &resource, 1 });
+	}
+}
+
+void real::CameraBuffer::CleanUp(const GameContext& context)
+{
+	for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
+	{
+		vmaUnmapMemory(context.vulkanContext.allocator, m_Allocations[i]);
+		DestroyBuffer(context.vulkanContext.allocator, m_Buffers[i], m_Allocations[i]);
+	}
+
+	vkDestroyPipelineLayout(context.vulkanContext.device, m_PipelineLayout, nullptr);
+}
+
+void real::CameraBuffer::Update(uint32_t frame)
+{
+	if (const auto pCamera = CameraManager::GetInstance().GetActiveCamera(); pCamera != nullptr)
+	{
+		CameraUbo ubo{};
+		ubo.view = pCamera->GetView();
+		ubo.proj = pCamera->GetProjection();
+		ubo.proj[1][1] *= -1;
+
+		memcpy(m_pMappedData[frame], &ubo, sizeof(CameraUbo));
+	}
+}
+
+void real::CameraBuffer::Bind(VkCommandBuffer commandBuffer, uint32_t frame) const
+{
+	vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_PipelineLayout, 0, 1,
+		&m_DescriptorSets[frame], 0, nullptr);
+}
+
+VkPushConstantRange real::CameraBuffer::GetPushConstantRange()
+{
+	VkPushConstantRange pushConstantRange{};
+	pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+	pushConstantRange.offset = 0;
+	pushConstantRange.size = push_constants_size;
+
+	return pushConstantRange;
+}
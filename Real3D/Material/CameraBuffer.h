@@ -0,0 +1,56 @@
+#ifndef CAMERABUFFER_H
+#define CAMERABUFFER_H
+
+#include <array>
+#include <vulkan/vulkan_core.h>
+
+#include <real_core/Singleton.h>
+
+#include "Util/Structs.h"
+#include "Util/VulkanUtil.h"
+
+namespace real
+{
+	// Holds the view and projection of the active camera in one uniform buffer per frame.
+	// It is bound once per frame at set 0, every material pipeline layout starts with its set layout.
+	class CameraBuffer final : public Singleton<CameraBuffer>
+	{
+	public:
+		virtual ~CameraBuffer() override = default;
+
+		CameraBuffer(const CameraBuffer&) = delete;
+		CameraBuffer& operator=(const CameraBuffer&) = delete;
+		CameraBuffer(CameraBuffer&&) = delete;
+		CameraBuffer& operator=(CameraBuffer&&) = delete;
+
+		void Init(const GameContext& context);  // NOLINT(clang-diagnostic-overloaded-virtual)
+		void CleanUp(const GameContext& context);
+
+		// Writes the matrices of the active camera, once per frame before anything binds them
+		void Update(uint32_t frame);
+		// Binds the matrices for every material drawn this frame, every command buffer has to bind them itself
+		void Bind(VkCommandBuffer commandBuffer, uint32_t frame) const;
+
+		VkDescriptorSetLayout GetDescriptorSetLayout() const { return m_DescriptorSetLayout; }
+
+		// All materials share this range, so set 0 stays bound when switching between their pipelines
+		static VkPushConstantRange GetPushConstantRange();
+
+		// The minimum every implementation supports
+		static constexpr uint32_t push_constants_size = 128;
+
+	private:
+		friend class Singleton<CameraBuffer>;
+		CameraBuffer() = default;
+
+		VkDescriptorSetLayout m_DescriptorSetLayout{ nullptr };
+		VkPipelineLayout m_PipelineLayout{ nullptr };
+
+		std::array<VkBuffer, MAX_FRAMES_IN_FLIGHT> m_Buffers{};
+		std::array<VmaAllocation, MAX_FRAMES_IN_FLIGHT> m_Allocations{};
+		std::array<void*, MAX_FRAMES_IN_FLIGHT> m_pMappedData{};
+		std::array<VkDescriptorSet, MAX_FRAMES_IN_FLIGHT> m_DescriptorSets{};
+	};
+}
+
+#endif // CAMERABUFFER_H
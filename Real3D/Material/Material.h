@@ -1,21 +1,21 @@
 #ifndef MATERIALNEW_H
 #define MATERIALNEW_H
 
-#include <map>
-
-#include "Util/vk_mem_alloc.h"
 #include "Graphics/Renderer.h"
 #include "Util/VulkanUtil.h"
 #include "Core/CommandPool.h"
 
 #include "BaseMaterial.h"
+#include "CameraBuffer.h"
+#include "PipelineRegistry.h"
 #include "RealEngine.h"
 
 namespace real
 {
 	class DrawableComponent;
 
-	template <typename Ubo>
+	// PushConstants is the per draw data of the material, it is pushed instead of stored in a buffer per mesh
+	template <typename PushConstants>
 	class Material : public BaseMaterial
 	{
 	public:
@@ -28,112 +28,53 @@ namespace real
 		Material& operator=(Material&&) = delete;
 
 		virtual void Init() override;
+		virtual void InitPipeline() override;
 		virtual void CleanUp() override;
-		virtual void CleanUpUbo(uint32_t reference) override;
-
-		uint32_t AddReference(); // To keep track of amount of meshes?
 
-		virtual void UpdateShaderVariables(const DrawableComponent* mesh, uint32_t reference) = 0;
-		void UpdateUniformBuffer(uint32_t reference, Ubo ubo);
+		virtual void UpdateShaderVariables(const DrawableComponent* mesh) = 0;
+		void Push(const PushConstants& constants) const;
 
 	protected:
 		virtual void CreatePipeline() = 0;
-		virtual void CreateDescriptorSetLayout() = 0;
-		virtual void CreateDescriptorSets(uint32_t reference, VkDescriptorSetLayout layout) = 0;
-
-	private:
-		inline static uint32_t m_AmountOfMeshes{ 0 };
+		// Materials without resources of their own only use the camera set
+		virtual void CreateDescriptorSetLayout() {}
+		virtual void CreateDescriptorSets() {}
 
-		void CreateUniformBuffers(uint32_t reference);
+		static_assert(sizeof(PushConstants) <= CameraBuffer::push_constants_size);
 	};
 
-	template <typename Ubo>
-	void Material<Ubo>::Init()
+	template <typename PushConstants>
+	void Material<PushConstants>::Init()
 	{
 		CreateDescriptorSetLayout();
-		CreatePipeline();
+		CreateDescriptorSets();
 	}
 
-	template <typename Ubo>
-	void Material<Ubo>::CleanUp()
+	template <typename PushConstants>
+	void Material<PushConstants>::InitPipeline()
 	{
-		const auto context = RealEngine::GetGameContext();
-
-		for (const auto& [reference, buffers] : m_UniformBuffers)
-		{
-			for (size_t j = 0; j < buffers.size(); ++j)
-			{
-				vmaUnmapMemory(context.vulkanContext.allocator, m_UniformBufferAllocations[reference][j]);
-				vmaDestroyBuffer(context.vulkanContext.allocator, m_UniformBuffers[reference][j], m_UniformBufferAllocations[reference][j]);
-			}
-		}
-
-		vkDestroyDescriptorSetLayout(context.vulkanContext.device, m_DescriptorSetLayout, nullptr);
-
-		vkDestroyPipeline(context.vulkanContext.device, m_Pipeline, nullptr);
-		vkDestroyPipelineLayout(context.vulkanContext.device, m_PipelineLayout, nullptr);
+		CreatePipeline();
 	}
 
-	template <typename Ubo>
-	void Material<Ubo>::CleanUpUbo(uint32_t reference)
+	template <typename PushConstants>
+	void Material<PushConstants>::CleanUp()
 	{
 		const auto context = RealEngine::GetGameContext();
 
-		for (size_t i = 0; i < m_UniformBuffers[reference].size(); ++i)
-		{
-			vmaUnmapMemory(context.vulkanContext.allocator, m_UniformBufferAllocations[reference][i]);
-			vmaDestroyBuffer(context.vulkanContext.allocator, m_UniformBuffers[reference][i], m_UniformBufferAllocations[reference][i]);
-		}
+		// The pipeline and its layout belong to the PipelineRegistry and the set layout to the DescriptorPoolManager, other materials might share them
+		if (m_PipelineLayout != nullptr)
+			PipelineRegistry::GetInstance().ReleasePipelineLayout(context.vulkanContext.device, m_PipelineLayout);
 
-		m_UniformBuffers.erase(reference);
+		m_PipelineLayout = nullptr;
+		m_Pipeline = nullptr;
 	}
 
-	template <typename Ubo>
-	uint32_t Material<Ubo>::AddReference()
+	template <typename PushConstants>
+	void Material<PushConstants>::Push(const PushConstants& constants) const
 	{
-		++m_AmountOfMeshes;
-
-		CreateUniformBuffers(m_AmountOfMeshes);
-		CreateDescriptorSets(m_AmountOfMeshes, m_DescriptorSetLayout);
-
-		return m_AmountOfMeshes;
-
-	}
-
-	template <typename Ubo>
-	void Material<Ubo>::UpdateUniformBuffer(uint32_t reference, Ubo ubo)
-	{
-		memcpy(m_UniformBuffersMapped[reference][Renderer::GetInstance().GetCurrentFrame()], &ubo, sizeof(Ubo));
-
 		const auto buffer = CommandPool::GetInstance().GetActiveCommandBuffer();
-		const auto frame = Renderer::GetInstance().GetCurrentFrame();
-		vkCmdBindDescriptorSets(buffer,
-			VK_PIPELINE_BIND_POINT_GRAPHICS,
-			m_PipelineLayout,
-			0,
-			1,
-			&m_DescriptorSets[reference][frame],
-			0,
-			nullptr
-		);
-	}
-
-	template <typename Ubo>
-	void Material<Ubo>::CreateUniformBuffers(uint32_t reference)
-	{
-		VkDeviceSize bufferSize = sizeof(Ubo);
-
-		const auto context = RealEngine::GetGameContext();
-
-		for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
-		{
-			CreateBuffer(context, bufferSize, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-				VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, m_UniformBuffers[reference][i],
-				m_UniformBufferAllocations[reference][i]);
-
-			vmaMapMemory(context.vulkanContext.allocator, m_UniformBufferAllocations[reference][i], &m_UniformBuffersMapped[reference][i]);
-		}
+		vkCmdPushConstants(buffer, m_PipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(PushConstants), &constants);
 	}
 }
 
-#endif // MATERIALNEW_H
\ No newline at end of file
+#endif // MATERIALNEW_H
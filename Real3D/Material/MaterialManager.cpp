@@ -1,6 +1,12 @@
 #include "MaterialManager.h"
 
+#include <chrono>
+#include <future>
+#include <iomanip>
+#include <iostream>
+
 #include "BaseMaterial.h"
+#include "PipelineRegistry.h"
 
 void real::MaterialManager::CleanUp()
 {
@@ -10,6 +16,45 @@ void real::MaterialManager::CleanUp()
 	}
 
     m_pMaterials.clear();
+    m_pMaterialsByType.clear();
+    m_pPendingMaterials.clear();
+}
+
+void real::MaterialManager::BuildPipelines()
+{
+	using clock = std::chrono::high_resolution_clock;
+	using milliseconds = std::chrono::duration<float, std::milli>;
+
+	const auto start = clock::now();
+
+	// Every material only touches its own pipeline, the shader modules and the pipeline cache are shared but synchronized
+	std::vector<std::future<milliseconds>> builds{};
+	builds.reserve(m_pPendingMaterials.size());
+	for (const auto pMaterial : m_pPendingMaterials)
+	{
+		builds.push_back(std::async(std::launch::async, [pMaterial]
+			{
+				const auto materialStart = clock::now();
+				pMaterial->InitPipeline();
+				return milliseconds(clock::now() - materialStart);
+			}));
+	}
+
+	std::vector<milliseconds> buildTimes{};
+	buildTimes.reserve(builds.size());
+	for (auto& build : builds)
+		buildTimes.push_back(build.get());
+
+	const milliseconds total = clock::now() - start;
+
+	std::cout << "\033[1;90mMaterials: " << m_pPendingMaterials.size() << " pipelines built in " << total.count() << "ms, "
+		<< PipelineRegistry::GetInstance().GetPipelineCount() << " unique\n";
+	for (size_t i = 0; i < m_pPendingMaterials.size(); ++i)
+		std::cout << "  " << std::left << std::setw(32) << m_pPendingMaterials[i]->GetName() << buildTimes[i].count() << "ms\n";
+	std::cout << "\033[0m";
+
+	m_pPendingMaterials.clear();
+	m_PipelinesBuilt = true;
 }
 
 real::BaseMaterial* real::MaterialManager::GetMaterial(uint8_t id) const
@@ -29,6 +74,10 @@ std::vector<real::BaseMaterial*> real::MaterialManager::GetMaterials() const
 
 void real::MaterialManager::RemoveMaterial(const GameContext& context, uint8_t id)
 {
+    std::erase(m_pPendingMaterials, m_pMaterials.at(id).get());
+
+    std::ranges::replace(m_pMaterialsByType, m_pMaterials.at(id).get(), nullptr);
+
     m_pMaterials.at(id)->CleanUp();
     m_pMaterials.erase(id);
 }
@@ -39,4 +88,6 @@ void real::MaterialManager::RemoveMaterials(const GameContext& context)
         mat->CleanUp();
 
 	m_pMaterials.clear();
+	m_pMaterialsByType.clear();
+	m_pPendingMaterials.clear();
 }
\ No newline at end of file
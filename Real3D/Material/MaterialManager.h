@@ -5,6 +5,9 @@
 #include <memory>
 #include <algorithm>
 #include <ranges>
+#include <string>
+#include <cstdint>
+#include <vector>
 
 #include <real_core/Singleton.h>
 
@@ -27,10 +30,14 @@ namespace real
 
 		void CleanUp();
 
-		template <typename T>
+		// The pipeline of a material added before BuildPipelines is only built once BuildPipelines is called
+		template <material_type T>
 		std::pair<uint8_t, T*> AddMaterial(const GameContext& context);
+		// Builds the pipelines of the added materials on worker threads and waits for all of them
+		void BuildPipelines();
 
-		template <typename T>
+		// The first material of type T that was added, indexed by the id of its type instead of searched for
+		template <material_type T>
 		T* GetMaterial() const;
 		BaseMaterial* GetMaterial(uint8_t id) const;
 		std::vector<BaseMaterial*> GetMaterials() const;
@@ -43,33 +50,52 @@ namespace real
 		MaterialManager() = default;
 
 		std::map<uint8_t, std::unique_ptr<BaseMaterial>> m_pMaterials;
+		// Indexed by material_type_id, only holds exact types
+		std::vector<BaseMaterial*> m_pMaterialsByType{};
+
+		std::vector<BaseMaterial*> m_pPendingMaterials{};
+		bool m_PipelinesBuilt{ false };
 
 		static inline uint8_t m_NextId{ 0 };
+
+		// Every material type gets the next id the first time it is used, the lookup is a single load
+		static inline uint32_t m_NextTypeId{ 0 };
+		template <material_type T>
+		static inline const uint32_t material_type_id = m_NextTypeId++;
 	};
 }
 
 #endif // MATERIALMANAGER_H
 
-template <typename T>
+template <real::material_type T>
 std::pair<uint8_t, T*> real::MaterialManager::AddMaterial(const GameContext& context)
 {
 	auto pMat = std::make_unique<T>();
 	T* rawPtr = pMat.get();
 	pMat->Init();
 
+	if (m_PipelinesBuilt)
+		rawPtr->InitPipeline();
+	else
+		m_pPendingMaterials.push_back(rawPtr);
+
 	m_pMaterials[++m_NextId] = std::move(pMat);
 
+	const auto typeId = material_type_id<T>;
+	if (typeId >= m_pMaterialsByType.size())
+		m_pMaterialsByType.resize(typeId + 1, nullptr);
+	if (m_pMaterialsByType[typeId] == nullptr)
+		m_pMaterialsByType[typeId] = rawPtr;
+
 	return { m_NextId, rawPtr };
 }
 
-template <typename T>
+template <real::material_type T>
 T* real::MaterialManager::GetMaterial() const
 {
-	for (const auto& base : m_pMaterials | std::views::values)
-	{
-		if (auto mat = dynamic_cast<T*>(base.get()))
-			return mat;
-	}
+	const auto typeId = material_type_id<T>;
+	if (typeId >= m_pMaterialsByType.size())
+		return nullptr;
 
-	return nullptr;
+	return static_cast<T*>(m_pMaterialsByType[typeId]);
 }
\ No newline at end of file
@@ -1,6 +1,179 @@
 #include "PipelineBuilder.h"
 
+#include <cstring>
+#include <functional>
+
+#include "PipelineRegistry.h"
+
+namespace
+{
+	// The vertex and blend states are plain structs of 32 bit members without padding, their bytes can be compared and hashed
+	template <typename T>
+	bool BytesEqual(const std::vector<T>& a, const std::vector<T>& b)
+	{
+		return a.size() == b.size() && (a.empty() || std::memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0);
+	}
+
+	void HashBytes(size_t& hash, const void* pData, size_t size)
+	{
+		// FNV-1a
+		const auto pBytes = static_cast<const unsigned char*>(pData);
+		for (size_t i = 0; i < size; ++i)
+		{
+			hash ^= pBytes[i];
+			hash *= 1099511628211ull;
+		}
+	}
+
+	template <typename T>
+	void HashValue(size_t& hash, const T& value)
+	{
+		HashBytes(hash, &value, sizeof(T));
+	}
+
+	template <typename T>
+	void HashVector(size_t& hash, const std::vector<T>& values)
+	{
+		HashValue(hash, values.size());
+		if (values.empty() == false)
+			HashBytes(hash, values.data(), values.size() * sizeof(T));
+	}
+}
+
+bool real::PipelineDescription::operator==(const PipelineDescription& other) const
+{
+	return shaderStages == other.shaderStages
+		&& BytesEqual(vertexBindings, other.vertexBindings)
+		&& BytesEqual(vertexAttributes, other.vertexAttributes)
+		&& topology == other.topology
+		&& primitiveRestart == other.primitiveRestart
+		&& polygonMode == other.polygonMode
+		&& cullMode == other.cullMode
+		&& frontFace == other.frontFace
+		&& lineWidth == other.lineWidth
+		&& BytesEqual(blendAttachments, other.blendAttachments)
+		&& depthTest == other.depthTest
+		&& depthWrite == other.depthWrite
+		&& depthCompareOp == other.depthCompareOp
+		&& layout == other.layout
+		&& renderPass == other.renderPass
+		&& subpass == other.subpass;
+}
+
+size_t real::PipelineDescriptionHash::operator()(const PipelineDescription& description) const
+{
+	size_t hash = 14695981039346656037ull;
+
+	for (const auto& stage : description.shaderStages)
+	{
+		HashValue(hash, stage.stage);
+		HashValue(hash, stage.module);
+		HashBytes(hash, stage.entryPoint.data(), stage.entryPoint.size());
+	}
+
+	HashVector(hash, description.vertexBindings);
+	HashVector(hash, description.vertexAttributes);
+	HashValue(hash, description.topology);
+	HashValue(hash, description.primitiveRestart);
+	HashValue(hash, description.polygonMode);
+	HashValue(hash, description.cullMode);
+	HashValue(hash, description.frontFace);
+	HashValue(hash, description.lineWidth);
+	HashVector(hash, description.blendAttachments);
+	HashValue(hash, description.depthTest);
+	HashValue(hash, description.depthWrite);
+	HashValue(hash, description.depthCompareOp);
+	HashValue(hash, description.layout);
+	HashValue(hash, description.renderPass);
+	HashValue(hash, description.subpass);
+
+	return hash;
+}
+
 real::PipelineBuilder::PipelineBuilder(VkDevice device)
 	: m_Device(device)
 {
+	SetColorBlend(EBlendMode::opaque);
+}
+
+void real::PipelineBuilder::SetShaders(const std::vector<VkPipelineShaderStageCreateInfo>& shaderModules)
+{
+	m_Description.shaderStages.clear();
+	for (const auto& shader : shaderModules)
+		m_Description.shaderStages.push_back({ shader.stage, shader.module, shader.pName });
+}
+
+void real::PipelineBuilder::SetInputAssembly(EPrimitiveTopology topology, bool primitiveRestart)
+{
+	// The enum follows the order of VkPrimitiveTopology
+	m_Description.topology = static_cast<VkPrimitiveTopology>(topology);
+	m_Description.primitiveRestart = primitiveRestart;
+}
+
+void real::PipelineBuilder::SetRasterizer(ERenderMode renderMode, ECullMode cullMode, float lineWidth)
+{
+	switch (renderMode)
+	{
+	case ERenderMode::filled: m_Description.polygonMode = VK_POLYGON_MODE_FILL; break;
+	case ERenderMode::lines: m_Description.polygonMode = VK_POLYGON_MODE_LINE; break;
+	case ERenderMode::points: m_Description.polygonMode = VK_POLYGON_MODE_POINT; break;
+	}
+
+	switch (cullMode)
+	{
+	case ECullMode::back: m_Description.cullMode = VK_CULL_MODE_BACK_BIT; break;
+	case ECullMode::front: m_Description.cullMode = VK_CULL_MODE_FRONT_BIT; break;
+	case ECullMode::both: m_Description.cullMode = VK_CULL_MODE_FRONT_AND_BACK; break;
+	case ECullMode::none: m_Description.cullMode = VK_CULL_MODE_NONE; break;
+	}
+
+	m_Description.lineWidth = lineWidth;
+}
+
+void real::PipelineBuilder::SetColorBlend(EBlendMode blendMode)
+{
+	VkPipelineColorBlendAttachmentState colorBlendAttachment{};
+	colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+	colorBlendAttachment.blendEnable = VK_FALSE;
+
+	if (blendMode == EBlendMode::alpha)
+	{
+		colorBlendAttachment.blendEnable = VK_TRUE;
+		colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+		colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+		colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
+		colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+		colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+		colorBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
+	}
+
+	m_Description.blendAttachments = { colorBlendAttachment };
+}
+
+void real::PipelineBuilder::SetColorBlend(std::span<const VkPipelineColorBlendAttachmentState> attachments)
+{
+	m_Description.blendAttachments.assign(attachments.begin(), attachments.end());
+}
+
+void real::PipelineBuilder::SetDepth(bool depthTest, bool depthWrite, VkCompareOp compareOp)
+{
+	m_Description.depthTest = depthTest;
+	m_Description.depthWrite = depthWrite;
+	m_Description.depthCompareOp = compareOp;
+}
+
+void real::PipelineBuilder::SetLayout(VkPipelineLayout layout)
+{
+	m_Description.layout = layout;
+}
+
+void real::PipelineBuilder::SetRenderPass(VkRenderPass renderPass, uint32_t subpass)
+{
+	m_Description.renderPass = renderPass;
+	m_Description.subpass = subpass;
+}
+
+VkPipeline real::PipelineBuilder::Build() const
+{
+	return PipelineRegistry::GetInstance().GetPipeline(m_Device, m_Description);
 }
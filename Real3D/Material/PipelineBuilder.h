@@ -1,6 +1,8 @@
 #ifndef PIPELINEBUILDER_H
 #define PIPELINEBUILDER_H
 
+#include <span>
+#include <string>
 #include <vector>
 #include <vulkan/vulkan.h>
 
@@ -9,6 +11,51 @@
 
 namespace real
 {
+	struct PipelineShaderStage
+	{
+		VkShaderStageFlagBits stage{};
+		VkShaderModule module{ nullptr };
+		std::string entryPoint{};
+
+		bool operator==(const PipelineShaderStage&) const = default;
+	};
+
+	// Everything a graphics pipeline is made of, the viewport and scissor are always dynamic.
+	// Two equal descriptions result in the same pipeline, see PipelineRegistry.
+	struct PipelineDescription
+	{
+		std::vector<PipelineShaderStage> shaderStages{};
+		std::vector<VkVertexInputBindingDescription> vertexBindings{};
+		std::vector<VkVertexInputAttributeDescription> vertexAttributes{};
+
+		VkPrimitiveTopology topology{ VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST };
+		bool primitiveRestart{ false };
+
+		VkPolygonMode polygonMode{ VK_POLYGON_MODE_FILL };
+		VkCullModeFlags cullMode{ VK_CULL_MODE_BACK_BIT };
+		VkFrontFace frontFace{ VK_FRONT_FACE_COUNTER_CLOCKWISE };
+		float lineWidth{ 1.0f };
+
+		std::vector<VkPipelineColorBlendAttachmentState> blendAttachments{};
+
+		bool depthTest{ true };
+		bool depthWrite{ true };
+		VkCompareOp depthCompareOp{ VK_COMPARE_OP_LESS };
+
+		VkPipelineLayout layout{ nullptr };
+		VkRenderPass renderPass{ nullptr };
+		uint32_t subpass{ 0 };
+
+		bool operator==(const PipelineDescription& other) const;
+	};
+
+	struct PipelineDescriptionHash
+	{
+		size_t operator()(const PipelineDescription& description) const;
+	};
+
+	// Fills in a PipelineDescription, Build returns the pipeline of the PipelineRegistry for it.
+	// Starts out as an opaque, depth tested, back face culled triangle list drawn in the first subpass.
 	class PipelineBuilder final
 	{
 	public:
@@ -20,17 +67,36 @@ namespace real
 		PipelineBuilder(PipelineBuilder&&) = delete;
 		PipelineBuilder& operator=(PipelineBuilder&&) = delete;
 
-		void SetShaders(std::vector<VkPipelineShaderStageCreateInfo> shaderModules);
+		void SetShaders(const std::vector<VkPipelineShaderStageCreateInfo>& shaderModules);
 		void SetInputAssembly(EPrimitiveTopology topology, bool primitiveRestart);
 		template<vertex_type V>
 		void SetInputType();
 		void SetRasterizer(ERenderMode renderMode, ECullMode cullMode, float lineWidth = 1.0f);
-		void SetColorBlend();
+		void SetColorBlend(EBlendMode blendMode);
+		// One state per color attachment of the subpass
+		void SetColorBlend(std::span<const VkPipelineColorBlendAttachmentState> attachments);
+		void SetDepth(bool depthTest, bool depthWrite, VkCompareOp compareOp = VK_COMPARE_OP_LESS);
+		void SetLayout(VkPipelineLayout layout);
+		void SetRenderPass(VkRenderPass renderPass, uint32_t subpass = 0);
+
+		const PipelineDescription& GetDescription() const { return m_Description; }
+		// Pipelines are owned by the PipelineRegistry, don't destroy them
+		VkPipeline Build() const;
 
 	private:
 		VkDevice m_Device;
+		PipelineDescription m_Description{};
 	};
 
+	template <vertex_type V>
+	void PipelineBuilder::SetInputType()
+	{
+		const auto bindings = V::GetBindingDescription();
+		m_Description.vertexBindings.assign(bindings.begin(), bindings.end());
+
+		const auto attributes = V::GetAttributeDescriptions();
+		m_Description.vertexAttributes.assign(attributes.begin(), attributes.end());
+	}
 }
 
-#endif // PIPELINEBUILDER_H
\ No newline at end of file
+#endif // PIPELINEBUILDER_H
@@ -32,6 +32,13 @@ namespace real
 		both = 2,
 		none = 3
 	};
+
+	enum class EBlendMode
+	{
+		opaque = 0,
+		// Source alpha over the destination
+		alpha = 1
+	};
 }
 
 #endif // PIPELINEENUMS_H
\ No newline at end of file
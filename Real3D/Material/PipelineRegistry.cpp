@@ -0,0 +1,228 @@
+#include "PipelineRegistry.h"
+
+#include <algorithm>
+#include <array>
+#include <ranges>
+#include <stdexcept>
+
+#include "Graphics/PipelineCache.h"
+
+namespace
+{
+	template <typename T>
+	void HashValue(size_t& hash, const T& value)
+	{
+		// FNV-1a
+		const auto pBytes = reinterpret_cast<const unsigned char*>(&value);
+		for (size_t i = 0; i < sizeof(T); ++i)
+		{
+			hash ^= pBytes[i];
+			hash *= 1099511628211ull;
+		}
+	}
+}
+
+bool real::PipelineRegistry::LayoutKey::operator==(const LayoutKey& other) const
+{
+	return setLayouts == other.setLayouts
+		&& std::ranges::equal(pushConstantRanges, other.pushConstantRanges, [](const VkPushConstantRange& a, const VkPushConstantRange& b)
+			{
+				return a.stageFlags == b.stageFlags && a.offset == b.offset && a.size == b.size;
+			});
+}
+
+size_t real::PipelineRegistry::LayoutKeyHash::operator()(const LayoutKey& key) const
+{
+	size_t hash = 14695981039346656037ull;
+	for (const auto setLayout : key.setLayouts)
+		HashValue(hash, setLayout);
+	for (const auto& range : key.pushConstantRanges)
+		HashValue(hash, range);
+
+	return hash;
+}
+
+void real::PipelineRegistry::CleanUp(const GameContext& context)
+{
+	for (const auto pipeline : m_Pipelines | std::views::values)
+		vkDestroyPipeline(context.vulkanContext.device, pipeline, nullptr);
+
+	for (const auto& sharedLayout : m_Layouts | std::views::values)
+		vkDestroyPipelineLayout(context.vulkanContext.device, sharedLayout.layout, nullptr);
+
+	m_Pipelines.clear();
+	m_Layouts.clear();
+	m_ReusedCount = 0;
+}
+
+VkPipeline real::PipelineRegistry::GetPipeline(VkDevice device, const PipelineDescription& description)
+{
+	{
+		std::lock_guard lock(m_Mutex);
+		if (const auto it = m_Pipelines.find(description); it != m_Pipelines.end())
+		{
+			++m_ReusedCount;
+			return it->second;
+		}
+	}
+
+	// Created outside of the lock, so different pipelines can be created at the same time
+	const auto pipeline = CreatePipeline(device, description);
+
+	std::lock_guard lock(m_Mutex);
+
+	// Another thread might have created the same pipeline in the meantime
+	if (const auto [it, inserted] = m_Pipelines.try_emplace(description, pipeline); inserted == false)
+	{
+		vkDestroyPipeline(device, pipeline, nullptr);
+		++m_ReusedCount;
+		return it->second;
+	}
+
+	return pipeline;
+}
+
+VkPipelineLayout real::PipelineRegistry::GetPipelineLayout(VkDevice device, const std::vector<VkDescriptorSetLayout>& setLayouts,
+	const std::vector<VkPushConstantRange>& pushConstantRanges)
+{
+	std::lock_guard lock(m_Mutex);
+
+	auto& [layout, referenceCount] = m_Layouts[LayoutKey{ setLayouts, pushConstantRanges }];
+	++referenceCount;
+
+	if (layout != nullptr)
+		return layout;
+
+	VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+	pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+	pipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(setLayouts.size());
+	pipelineLayoutInfo.pSetLayouts = setLayouts.data();
+	pipelineLayoutInfo.pushConstantRangeCount = static_cast<uint32_t>(pushConstantRanges.size());
+	pipelineLayoutInfo.pPushConstantRanges = pushConstantRanges.data();
+
+	if (vkCreatePipelineLayout(device, &pipelineLayoutInfo, nullptr, &layout) != VK_SUCCESS)
+	{
+		m_Layouts.erase(LayoutKey{ setLayouts, pushConstantRanges });
+		throw std::runtime_error("failed to create pipeline layout!");
+	}
+
+	return layout;
+}
+
+void real::PipelineRegistry::ReleasePipelineLayout(VkDevice device, VkPipelineLayout layout)
+{
+	std::lock_guard lock(m_Mutex);
+
+	const auto it = std::ranges::find_if(m_Layouts, [layout](const auto& entry) { return entry.second.layout == layout; });
+	if (it == m_Layouts.end() || --it->second.referenceCount > 0)
+		return;
+
+	// The descriptions key on the layout, a new layout might get the same handle
+	std::erase_if(m_Pipelines, [device, layout](const auto& entry)
+		{
+			if (entry.first.layout != layout)
+				return false;
+
+			vkDestroyPipeline(device, entry.second, nullptr);
+			return true;
+		});
+
+	vkDestroyPipelineLayout(device, layout, nullptr);
+	m_Layouts.erase(it);
+}
+
+VkPipeline real::PipelineRegistry::CreatePipeline(VkDevice device, const PipelineDescription& description)
+{
+	std::vector<VkPipelineShaderStageCreateInfo> shaderStages{};
+	for (const auto& stage : description.shaderStages)
+	{
+		VkPipelineShaderStageCreateInfo stageInfo{};
+		stageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+		stageInfo.stage = stage.stage;
+		stageInfo.module = stage.module;
+		stageInfo.pName = stage.entryPoint.c_str();
+
+		shaderStages.push_back(stageInfo);
+	}
+
+	VkPipelineVertexInputStateCreateInfo vertexInput{};
+	vertexInput.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+	vertexInput.vertexBindingDescriptionCount = static_cast<uint32_t>(description.vertexBindings.size());
+	vertexInput.pVertexBindingDescriptions = description.vertexBindings.data();
+	vertexInput.vertexAttributeDescriptionCount = static_cast<uint32_t>(description.vertexAttributes.size());
+	vertexInput.pVertexAttributeDescriptions = description.vertexAttributes.data();
+
+	VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
+	inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+	inputAssembly.topology = description.topology;
+	inputAssembly.primitiveRestartEnable = description.primitiveRestart ? VK_TRUE : VK_FALSE;
+
+	VkPipelineViewportStateCreateInfo viewportState{};
+	viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+	viewportState.viewportCount = 1;
+	viewportState.scissorCount = 1;
+
+	VkPipelineRasterizationStateCreateInfo rasterizer{};
+	rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+	rasterizer.depthClampEnable = VK_FALSE;
+	rasterizer.rasterizerDiscardEnable = VK_FALSE;
+	rasterizer.polygonMode = description.polygonMode;
+	rasterizer.lineWidth = description.lineWidth;
+	rasterizer.cullMode = description.cullMode;
+	rasterizer.frontFace = description.frontFace;
+	rasterizer.depthBiasEnable = VK_FALSE;
+
+	VkPipelineMultisampleStateCreateInfo multisampling{};
+	multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+	multisampling.sampleShadingEnable = VK_FALSE;
+	multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+	VkPipelineColorBlendStateCreateInfo colorBlending{};
+	colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+	colorBlending.logicOpEnable = VK_FALSE;
+	colorBlending.logicOp = VK_LOGIC_OP_COPY;
+	colorBlending.attachmentCount = static_cast<uint32_t>(description.blendAttachments.size());
+	colorBlending.pAttachments = description.blendAttachments.data();
+
+	VkPipelineDepthStencilStateCreateInfo depthStencil{};
+	depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+	depthStencil.depthTestEnable = description.depthTest ? VK_TRUE : VK_FALSE;
+	depthStencil.depthWriteEnable = description.depthWrite ? VK_TRUE : VK_FALSE;
+	depthStencil.depthCompareOp = description.depthCompareOp;
+	depthStencil.depthBoundsTestEnable = VK_FALSE;
+
+	constexpr std::array dynamicStates = {
+		VK_DYNAMIC_STATE_VIEWPORT,
+		VK_DYNAMIC_STATE_SCISSOR
+	};
+	VkPipelineDynamicStateCreateInfo dynamicState{};
+	dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+	dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
+	dynamicState.pDynamicStates = dynamicStates.data();
+
+	VkGraphicsPipelineCreateInfo pipelineInfo{};
+	pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+	pipelineInfo.stageCount = static_cast<uint32_t>(shaderStages.size());
+	pipelineInfo.pStages = shaderStages.data();
+	pipelineInfo.pVertexInputState = &vertexInput;
+	pipelineInfo.pInputAssemblyState = &inputAssembly;
+	pipelineInfo.pViewportState = &viewportState;
+	pipelineInfo.pRasterizationState = &rasterizer;
+	pipelineInfo.pMultisampleState = &multisampling;
+	pipelineInfo.pColorBlendState = &colorBlending;
+	pipelineInfo.pDynamicState = &dynamicState;
+	pipelineInfo.pDepthStencilState = &depthStencil;
+	pipelineInfo.layout = description.layout;
+	pipelineInfo.renderPass = description.renderPass;
+	pipelineInfo.subpass = description.subpass;
+	pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
+
+	VkPipeline pipeline;
+	const auto result = PipelineCache::GetInstance().CreateGraphicsPipeline(device, pipelineInfo, &pipeline);
+	if (result != VK_SUCCESS)
+	{
+		throw std::runtime_error("failed to create graphics pipeline!");
+	}
+
+	return pipeline;
+}
@@ -0,0 +1,75 @@
+#ifndef PIPELINEREGISTRY_H
+#define PIPELINEREGISTRY_H
+
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include <real_core/Singleton.h>
+
+#include "PipelineBuilder.h"
+#include "Util/Structs.h"
+
+namespace real
+{
+	// Owns every pipeline made by a PipelineBuilder, a description that was requested before returns the existing pipeline.
+	// The material pipeline layouts are shared the same way, a layout and its pipelines live until the last material released it.
+	class PipelineRegistry final : public Singleton<PipelineRegistry>
+	{
+	public:
+		virtual ~PipelineRegistry() override = default;
+
+		PipelineRegistry(const PipelineRegistry&) = delete;
+		PipelineRegistry& operator=(const PipelineRegistry&) = delete;
+		PipelineRegistry(PipelineRegistry&&) = delete;
+		PipelineRegistry& operator=(PipelineRegistry&&) = delete;
+
+		void CleanUp(const GameContext& context);
+
+		// Thread safe, the materials build their pipelines in parallel
+		VkPipeline GetPipeline(VkDevice device, const PipelineDescription& description);
+
+		// Thread safe, every call has to be matched by a ReleasePipelineLayout
+		VkPipelineLayout GetPipelineLayout(VkDevice device, const std::vector<VkDescriptorSetLayout>& setLayouts,
+			const std::vector<VkPushConstantRange>& pushConstantRanges);
+		// Destroys the layout and every pipeline built with it once nothing uses it anymore
+		void ReleasePipelineLayout(VkDevice device, VkPipelineLayout layout);
+
+		uint32_t GetPipelineCount() const { return static_cast<uint32_t>(m_Pipelines.size()); }
+		uint32_t GetPipelineLayoutCount() const { return static_cast<uint32_t>(m_Layouts.size()); }
+		uint32_t GetReusedCount() const { return m_ReusedCount; }
+
+	private:
+		friend class Singleton<PipelineRegistry>;
+		PipelineRegistry() = default;
+
+		struct LayoutKey
+		{
+			std::vector<VkDescriptorSetLayout> setLayouts{};
+			std::vector<VkPushConstantRange> pushConstantRanges{};
+
+			bool operator==(const LayoutKey& other) const;
+		};
+
+		struct LayoutKeyHash
+		{
+			size_t operator()(const LayoutKey& key) const;
+		};
+
+		struct SharedLayout
+		{
+			VkPipelineLayout layout{ nullptr };
+			uint32_t referenceCount{ 0 };
+		};
+
+		std::mutex m_Mutex{};
+		std::unordered_map<PipelineDescription, VkPipeline, PipelineDescriptionHash> m_Pipelines{};
+		std::unordered_map<LayoutKey, SharedLayout, LayoutKeyHash> m_Layouts{};
+		uint32_t m_ReusedCount{ 0 };
+
+		static VkPipeline CreatePipeline(VkDevice device, const PipelineDescription& description);
+	};
+}
+
+#endif // PIPELINEREGISTRY_H
@@ -1,5 +1,6 @@
 #include "PosCol2DPipeline.h"
 
+#include "Graphics/PipelineCache.h"
 #include "Graphics/ShaderManager.h"
 #include "Util/VulkanUtil.h"
 
@@ -104,7 +105,7 @@ void real::PosCol2DPipeline::CreatePipeline(const VulkanContext& vulkan)
 	pipelineInfo.subpass = 0;
 	pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
 
-	const auto result = vkCreateGraphicsPipelines(vulkan.device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_Pipeline);
+	const auto result = PipelineCache::GetInstance().CreateGraphicsPipeline(vulkan.device, pipelineInfo, &m_Pipeline);
 	if (result != VK_SUCCESS)
 	{
 		throw std::runtime_error("failed to create graphics pipeline!");
@@ -5,6 +5,7 @@
 
 #include "Pipeline.h"
 #include "Util/Structs.h"
+#include "Graphics/PipelineCache.h"
 #include "Graphics/ShaderManager.h"
 
 namespace real
@@ -138,7 +139,7 @@ void real::PosNormBase<V>::CreatePipeline(const VulkanContext& vulkan)
 	pipelineInfo.subpass = 0;
 	pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
 
-	const auto result = vkCreateGraphicsPipelines(vulkan.device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_Pipeline);
+	const auto result = PipelineCache::GetInstance().CreateGraphicsPipeline(vulkan.device, pipelineInfo, &m_Pipeline);
 	if (result != VK_SUCCESS)
 	{
 		throw std::runtime_error("failed to create graphics pipeline!");
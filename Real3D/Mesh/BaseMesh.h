@@ -5,6 +5,8 @@
 
 #include <real_core/DrawableComponent.h>
 
+#include "BufferArena.h"
+#include "Graphics/RenderQueue.h"
 #include "Material/Material.h"
 
 namespace real
@@ -16,14 +18,15 @@ namespace real
 		uint32_t vertexCapacity = 0, indexCapacity = 0;
 		Texture2D* texture = nullptr;
 		bool usesUbo = false;
+		bool drawIndirect = false;	// => the ranges are drawn by an IndirectBatch instead of the mesh itself
+		RenderPassType renderPass = RenderPassType::opaque;
 	};
 
 	template <typename T>
 	struct BufferContext
 	{
 		bool isDirty = false;
-		VkBuffer buffer{ nullptr };
-		VmaAllocation allocation{ nullptr };
+		BufferRange range{};
 		std::vector<T> data{};
 	};
 
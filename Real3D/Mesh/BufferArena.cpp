@@ -0,0 +1,131 @@
+#include "BufferArena.h"
+
+#include <stdexcept>
+
+#include "Core/UploadManager.h"
+#include "Util/vk_mem_alloc.h"
+
+real::BufferArena::BufferArena(uint32_t elementSize, VkBufferUsageFlags usage)
+	: m_ElementSize(elementSize)
+	, m_BlockCapacity(static_cast<uint32_t>(block_size / elementSize))
+	, m_Usage(usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT)
+{
+}
+
+void real::BufferArena::CleanUp(const GameContext& context)
+{
+	for (auto& block : m_Blocks)
+	{
+		DestroyBuffer(context.vulkanContext.allocator, block.buffer, block.allocation);
+	}
+
+	m_Blocks.clear();
+	m_UsedElements = 0;
+}
+
+real::BufferRange real::BufferArena::Allocate(const GameContext& context, uint32_t count)
+{
+	if (count == 0)
+		return {};
+
+	if (count > m_BlockCapacity)
+	{
+		throw std::runtime_error("failed to allocate a range bigger than an arena block!");
+	}
+
+	BufferRange range{};
+	range.count = count;
+
+	for (uint32_t i = 0; i < m_Blocks.size(); ++i)
+	{
+		if (AllocateFromBlock(m_Blocks[i], count, range.offset))
+		{
+			range.block = i;
+			m_UsedElements += count;
+			return range;
+		}
+	}
+
+	CreateBlock(context);
+	range.block = static_cast<uint32_t>(m_Blocks.size()) - 1;
+	AllocateFromBlock(m_Blocks.back(), count, range.offset);
+	m_UsedElements += count;
+
+	return range;
+}
+
+void real::BufferArena::Free(const BufferRange& range)
+{
+	if (range.count == 0)
+		return;
+
+	auto& freeRanges = m_Blocks[range.block].freeRanges;
+	auto [it, inserted] = freeRanges.emplace(range.offset, range.count);
+	m_UsedElements -= range.count;
+
+	// Merge with the following range
+	if (const auto next = std::next(it); next != freeRanges.end() && it->first + it->second == next->first)
+	{
+		it->second += next->second;
+		freeRanges.erase(next);
+	}
+
+	// Merge with the preceding range
+	if (it != freeRanges.begin())
+	{
+		if (const auto prev = std::prev(it); prev->first + prev->second == it->first)
+		{
+			prev->second += it->second;
+			freeRanges.erase(it);
+		}
+	}
+}
+
+void real::BufferArena::CreateBlock(const GameContext& context)
+{
+	// Shared with the transfer queue, so ranges can be uploaded while others are being drawn
+	const auto queueFamilies = UploadManager::GetInstance().GetSharedQueueFamilies();
+
+	VkBufferCreateInfo bufferInfo{};
+	bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+	bufferInfo.size = static_cast<VkDeviceSize>(m_BlockCapacity) * m_ElementSize;
+	bufferInfo.usage = m_Usage;
+	bufferInfo.sharingMode = queueFamilies.empty() ? VK_SHARING_MODE_EXCLUSIVE : VK_SHARING_MODE_CONCURRENT;
+	bufferInfo.queueFamilyIndexCount = static_cast<uint32_t>(queueFamilies.size());
+	bufferInfo.pQueueFamilyIndices = queueFamilies.data();
+
+	VmaAllocationCreateInfo allocInfo{};
+	allocInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+	allocInfo.requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+
+	Block block{};
+	if (vmaCreateBuffer(context.vulkanContext.allocator, &bufferInfo, &allocInfo, &block.buffer, &block.allocation, nullptr) != VK_SUCCESS)
+	{
+		throw std::runtime_error("failed to create arena block!");
+	}
+
+	MemoryTracker::GetInstance().Track(context.vulkanContext.allocator, block.allocation, EMemoryCategory::mesh);
+
+	block.freeRanges.emplace(0, m_BlockCapacity);
+	m_Blocks.push_back(std::move(block));
+}
+
+bool real::BufferArena::AllocateFromBlock(Block& block, uint32_t count, uint32_t& offset)
+{
+	for (auto it = block.freeRanges.begin(); it != block.freeRanges.end(); ++it)
+	{
+		if (it->second < count)
+			continue;
+
+		offset = it->first;
+
+		const uint32_t remaining = it->second - count;
+		block.freeRanges.erase(it);
+		if (remaining > 0)
+			block.freeRanges.emplace(offset + count, remaining);
+
+		return true;
+	}
+
+	return false;
+}
@@ -0,0 +1,64 @@
+#ifndef BUFFERARENA_H
+#define BUFFERARENA_H
+
+#include <map>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+
+#include "Util/Structs.h"
+
+namespace real
+{
+	// A range of elements inside one of the blocks of an arena, a count of 0 means nothing is allocated
+	struct BufferRange
+	{
+		uint32_t block{ 0 };
+		uint32_t offset{ 0 };
+		uint32_t count{ 0 };
+	};
+
+	// Sub-allocates ranges of equally sized elements from large device local buffers, using a first fit free list
+	class BufferArena final
+	{
+	public:
+		explicit BufferArena(uint32_t elementSize, VkBufferUsageFlags usage);
+		~BufferArena() = default;
+
+		BufferArena(const BufferArena&) = delete;
+		BufferArena& operator=(const BufferArena&) = delete;
+		BufferArena(BufferArena&&) = delete;
+		BufferArena& operator=(BufferArena&&) = delete;
+
+		void CleanUp(const GameContext& context);
+
+		BufferRange Allocate(const GameContext& context, uint32_t count);
+		void Free(const BufferRange& range);
+
+		VkBuffer GetBuffer(uint32_t block) const { return m_Blocks[block].buffer; }
+		uint32_t GetElementSize() const { return m_ElementSize; }
+		uint32_t GetBlockCount() const { return static_cast<uint32_t>(m_Blocks.size()); }
+		VkDeviceSize GetUsedBytes() const { return static_cast<VkDeviceSize>(m_UsedElements) * m_ElementSize; }
+
+		static constexpr VkDeviceSize block_size = 64 * 1024 * 1024;
+
+	private:
+		struct Block
+		{
+			VkBuffer buffer{ nullptr };
+			VmaAllocation allocation{ nullptr };
+			std::map<uint32_t, uint32_t> freeRanges{};	// => offset, count
+		};
+
+		uint32_t m_ElementSize;
+		uint32_t m_BlockCapacity;
+		VkBufferUsageFlags m_Usage;
+
+		std::vector<Block> m_Blocks{};
+		uint64_t m_UsedElements{ 0 };
+
+		void CreateBlock(const GameContext& context);
+		static bool AllocateFromBlock(Block& block, uint32_t count, uint32_t& offset);
+	};
+}
+
+#endif // BUFFERARENA_H
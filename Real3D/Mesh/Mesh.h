@@ -9,6 +9,7 @@
 #include <real_core/GameObject.h>
 
 #include "Core/CommandPool.h"
+#include "Core/UploadManager.h"
 #include "Content/ContentManager.h"
 #include "Util/Concepts.h"
 #include "Util/Structs.h"
@@ -18,10 +19,11 @@
 #include "Util/vk_mem_alloc.h"
 
 #include "BaseMesh.h"
+#include "MeshBufferManager.h"
 
 namespace real
 {
-	template <vertex_type V, typename Ubo>
+	template <vertex_type V, typename PushConstants>
 	class Mesh : public BaseMesh
 	{
 	public:
@@ -33,15 +35,10 @@ namespace real
 
 		virtual ~Mesh() override
 		{
-			const auto context = RealEngine::GetGameContext();
-
 			for (auto& vertexBuffer : m_VertexBuffers)
 			{
-				if (vertexBuffer.buffer != nullptr)
-				{
-					vmaDestroyBuffer(context.vulkanContext.allocator, vertexBuffer.buffer, vertexBuffer.allocation);
-					vertexBuffer.buffer = nullptr;
-				}
+				MeshBufferManager::GetInstance().FreeVertices(sizeof(V), vertexBuffer.range);
+				vertexBuffer.range = {};
 			}
 		}
 
@@ -60,46 +57,35 @@ namespace real
 			if (m_VertexBufferIsDirty == false)
 				return;
 
-			for (auto& [isDirty, buffer, memory, data] : m_VertexBuffers)
+			const auto context = RealEngine::GetGameContext();
+
+			for (size_t i = 0; i < m_VertexBuffers.size(); ++i)
 			{
-				if (isDirty && data.empty() == false)
-				{
-					UpdateVertexBuffer(data, buffer);
-					isDirty = false;
-				}
+				if (m_VertexBuffers[i].isDirty)
+					CreateVertexBuffer(context, i);
 			}
 
 			m_VertexBufferIsDirty = false;
 		}
 		virtual void Render() override
 		{
-			const auto commandBuffer = CommandPool::GetInstance().GetActiveCommandBuffer();
-
-			m_pMaterial->Bind(commandBuffer, m_Reference);
-			m_pMaterial->UpdateShaderVariables(this, m_Reference);
+			// Resolved here, the draw might get recorded on a worker thread
+			const auto& world = GetOwner()->GetTransform()->GetWorldMatrix();
 
-			const auto buffers = GetAllVertexBuffers();
-			const std::vector<VkDeviceSize> offsets(buffers.size(), 0);
-			vkCmdBindVertexBuffers(commandBuffer, 0, static_cast<uint32_t>(buffers.size()), buffers.data(), offsets.data());
-
-			const auto vertices = GetAllVertices();
-			vkCmdDraw(commandBuffer, static_cast<uint32_t>(vertices.size()), 1, 0, 0);
+			RenderQueue::GetInstance().Submit(m_Info.renderPass, m_pMaterial, world[3],
+				[this](VkCommandBuffer commandBuffer) { Draw(commandBuffer); });
 		}
 
 		virtual void Kill() override
 		{
-			const auto context = RealEngine::GetGameContext();
-
-			m_pMaterial->CleanUpUbo(m_Reference);
-
 			for (auto& vertexBuffer : m_VertexBuffers)
 			{
-				vmaDestroyBuffer(context.vulkanContext.allocator, vertexBuffer.buffer, vertexBuffer.allocation);
-				vertexBuffer.buffer = nullptr;
+				MeshBufferManager::GetInstance().FreeVertices(sizeof(V), vertexBuffer.range);
+				vertexBuffer.range = {};
 			}
 		}
 
-		void SetMaterial(Material<Ubo>* material);
+		void SetMaterial(Material<PushConstants>* material);
 
 		void AddVertex(V vertex)
 		{
@@ -112,7 +98,7 @@ namespace real
 			{
 				m_VertexBuffers.push_back({});
 				m_VertexBuffers.back().data.push_back(vertex);
-				CreateVertexBuffer(RealEngine::GetGameContext(), m_VertexBuffers.size() - 1);
+				m_VertexBuffers.back().isDirty = true;
 			}
 
 			m_VertexBufferIsDirty = true;
@@ -126,7 +112,6 @@ namespace real
 				{
 					m_VertexBuffers.push_back({});
 					FillUntilSize(v, m_VertexBuffers.back().data, m_Info.vertexCapacity);
-					CreateVertexBuffer(RealEngine::GetGameContext(), m_VertexBuffers.size() - 1);
 					m_VertexBuffers.back().isDirty = true;
 				}
 				};
@@ -152,18 +137,12 @@ namespace real
 
 			while (v.empty() == false)
 			{
-				bool createNewBuffer = false;
 				if (counter >= m_VertexBuffers.size())
-				{
 					m_VertexBuffers.push_back({});
-					createNewBuffer = true;
-				}
 
 				m_VertexBuffers[counter].data.clear();
 
 				FillUntilSize(v, m_VertexBuffers[counter].data, m_Info.vertexCapacity);
-				if (createNewBuffer)
-					CreateVertexBuffer(RealEngine::GetGameContext(), counter);
 				m_VertexBuffers[counter].isDirty = true;
 
 				++counter;
@@ -171,94 +150,70 @@ namespace real
 
 			if (counter < m_VertexBuffers.size() - 1)
 			{
-				m_VertexBuffers.erase(m_VertexBuffers.begin() + counter, m_VertexBuffers.end());
+				EraseVertexBuffers(counter);
 			}
 
 			m_VertexBufferIsDirty = true;
 		}
 		void ClearVertices()
 		{
-			m_VertexBuffers.erase(m_VertexBuffers.begin() + 1, m_VertexBuffers.end());
+			EraseVertexBuffers(1);
 			m_VertexBuffers.front().data.clear();
+			m_VertexBuffers.front().isDirty = true;
 			
 			m_VertexBufferIsDirty = true;
 		}
 
 	protected:
-		Material<Ubo>* m_pMaterial{ nullptr };
-		uint32_t m_Reference{ 0 };
+		Material<PushConstants>* m_pMaterial{ nullptr };
 
 		bool m_VertexBufferIsDirty{ false };
 		std::vector<BufferContext<V>> m_VertexBuffers;
 
-		void CreateVertexBuffer(const GameContext& context, size_t index)
+		// Recorded by the render queue, the material is already bound
+		virtual void Draw(VkCommandBuffer commandBuffer)
 		{
-			const VkDeviceSize bufferSize = sizeof(V) * m_Info.vertexCapacity;
-
-			VkBuffer stagingBuffer;
-			VmaAllocation stagingBufferAllocation;
-			CreateBuffer(context, bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-				VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-				stagingBuffer, stagingBufferAllocation);
+			m_pMaterial->UpdateShaderVariables(this);
 
-			UpdateBuffer<V>(stagingBufferAllocation, m_VertexBuffers[index].data);
+			const auto& arena = MeshBufferManager::GetInstance().GetVertexArena(sizeof(V));
+			uint32_t boundBlock = UINT32_MAX;
 
-			VkBuffer vertexBuffer;
-			VmaAllocation bufferAllocation;
-			CreateBuffer(context, bufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-				VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, vertexBuffer,
-				bufferAllocation);
-
-			CopyBuffer(context, stagingBuffer, vertexBuffer, bufferSize);
-
-			m_VertexBuffers[index].buffer = vertexBuffer;
-			m_VertexBuffers[index].allocation = bufferAllocation;
+			for (const auto& [isDirty, range, data] : m_VertexBuffers)
+			{
+				if (range.count == 0)
+					continue;
 
-			vmaDestroyBuffer(context.vulkanContext.allocator, stagingBuffer, stagingBufferAllocation);
-		}
+				if (range.block != boundBlock)
+				{
+					const VkBuffer vertexBuffers[] = { arena.GetBuffer(range.block) };
+					constexpr VkDeviceSize offsets[] = { 0 };
+					vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
+					boundBlock = range.block;
+				}
 
-		template <typename T>
-		static void UpdateBuffer(VmaAllocation allocation, const std::vector<T>& v)
-		{
-			void* data;
-			const auto context = RealEngine::GetGameContext();
-			vmaMapMemory(context.vulkanContext.allocator, allocation, &data);
-			memcpy(data, v.data(), sizeof(T) * v.size());
-			vmaUnmapMemory(context.vulkanContext.allocator, allocation);
+				vkCmdDraw(commandBuffer, range.count, 1, range.offset, 0);
+			}
 		}
 
-		void UpdateVertexBuffer(const std::vector<V>& data, VkBuffer buffer)
+		void CreateVertexBuffer(const GameContext& context, size_t index)
 		{
-			const VkDeviceSize bufferSize = sizeof(V) * m_Info.vertexCapacity;
-			const auto context = RealEngine::GetGameContext();
+			auto& [isDirty, range, data] = m_VertexBuffers[index];
 
-			VkBuffer stagingBuffer;
-			VmaAllocation stagingBufferAllocation;
-			CreateBuffer(context, bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-				VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-				stagingBuffer, stagingBufferAllocation);
-
-			UpdateBuffer<V>(stagingBufferAllocation, data);
-
-			CopyBuffer(context, stagingBuffer, buffer, bufferSize);
-
-			vmaDestroyBuffer(context.vulkanContext.allocator, stagingBuffer, stagingBufferAllocation);
+			// Frames in flight might still read from the current range, upload into a fresh one
+			MeshBufferManager::GetInstance().FreeVertices(sizeof(V), range);
+			range = MeshBufferManager::GetInstance().UploadVertices(context, data.data(), sizeof(V), static_cast<uint32_t>(data.size()));
+			isDirty = false;
 		}
-
-		static void CopyBuffer(const GameContext& context, VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size);
-
-		std::vector<VkBuffer> GetAllVertexBuffers()
+		void EraseVertexBuffers(size_t first)
 		{
-			std::vector<VkBuffer> v(m_VertexBuffers.size());
-
-			std::ranges::transform(m_VertexBuffers, v.begin(),
-				[](const BufferContext<V>& vertexBuffer)
-				{
-					return vertexBuffer.buffer;
-				});
+			for (size_t i = first; i < m_VertexBuffers.size(); ++i)
+			{
+				MeshBufferManager::GetInstance().FreeVertices(sizeof(V), m_VertexBuffers[i].range);
+			}
 
-			return v;
+			m_VertexBuffers.erase(m_VertexBuffers.begin() + first, m_VertexBuffers.end());
 		}
+
 		std::vector<V> GetAllVertices()
 		{
 			std::vector<V> v;
@@ -287,23 +242,10 @@ namespace real
 		}
 	};
 
-	template <vertex_type V, typename Ubo>
-	void Mesh<V, Ubo>::SetMaterial(Material<Ubo>* material)
+	template <vertex_type V, typename PushConstants>
+	void Mesh<V, PushConstants>::SetMaterial(Material<PushConstants>* material)
 	{
 		m_pMaterial = material;
-		m_Reference = m_pMaterial->AddReference();
-	}
-
-	template <vertex_type V, typename Ubo>
-	void Mesh<V, Ubo>::CopyBuffer(const GameContext& context, VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size)
-	{
-		const auto commandBuffer = CommandBuffer::StartSingleTimeCommands(context);
-
-		VkBufferCopy copyRegion{};
-		copyRegion.size = size;
-		vkCmdCopyBuffer(commandBuffer, srcBuffer, dstBuffer, 1, &copyRegion);
-
-		CommandBuffer::StopSingleTimeCommands(context, commandBuffer);
 	}
 }
 
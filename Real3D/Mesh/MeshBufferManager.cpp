@@ -0,0 +1,78 @@
+#include "MeshBufferManager.h"
+
+#include <ranges>
+
+#include "Core/UploadManager.h"
+
+void real::MeshBufferManager::CleanUp(const GameContext& context)
+{
+	for (const auto& pArena : m_VertexArenas | std::views::values)
+	{
+		pArena->CleanUp(context);
+	}
+	m_VertexArenas.clear();
+
+	m_IndexArena.CleanUp(context);
+}
+
+real::BufferArena& real::MeshBufferManager::GetVertexArena(uint32_t vertexSize)
+{
+	// Recording only looks the arena up, which may happen on several threads at once
+	if (const auto it = m_VertexArenas.find(vertexSize); it != m_VertexArenas.end())
+		return *it->second;
+
+	auto& pArena = m_VertexArenas[vertexSize];
+	if (pArena == nullptr)
+		pArena = std::make_unique<BufferArena>(vertexSize, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+
+	return *pArena;
+}
+
+real::BufferRange real::MeshBufferManager::UploadVertices(const GameContext& context, const void* data, uint32_t vertexSize, uint32_t count)
+{
+	auto& arena = GetVertexArena(vertexSize);
+	const BufferRange range = arena.Allocate(context, count);
+
+	if (range.count > 0)
+	{
+		UploadManager::GetInstance().UploadSharedBuffer(arena.GetBuffer(range.block), data,
+			static_cast<VkDeviceSize>(count) * vertexSize, static_cast<VkDeviceSize>(range.offset) * vertexSize);
+	}
+
+	return range;
+}
+
+real::BufferRange real::MeshBufferManager::UploadIndices(const GameContext& context, const uint32_t* data, uint32_t count)
+{
+	const BufferRange range = m_IndexArena.Allocate(context, count);
+
+	if (range.count > 0)
+	{
+		UploadManager::GetInstance().UploadSharedBuffer(m_IndexArena.GetBuffer(range.block), data,
+			sizeof(uint32_t) * count, sizeof(uint32_t) * range.offset);
+	}
+
+	return range;
+}
+
+void real::MeshBufferManager::FreeVertices(uint32_t vertexSize, const BufferRange& range)
+{
+	if (range.count == 0)
+		return;
+
+	UploadManager::GetInstance().Release([this, vertexSize, range](const GameContext&)
+		{
+			GetVertexArena(vertexSize).Free(range);
+		});
+}
+
+void real::MeshBufferManager::FreeIndices(const BufferRange& range)
+{
+	if (range.count == 0)
+		return;
+
+	UploadManager::GetInstance().Release([this, range](const GameContext&)
+		{
+			m_IndexArena.Free(range);
+		});
+}
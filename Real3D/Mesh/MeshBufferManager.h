@@ -0,0 +1,47 @@
+#ifndef MESHBUFFERMANAGER_H
+#define MESHBUFFERMANAGER_H
+
+#include <map>
+#include <memory>
+
+#include <real_core/Singleton.h>
+
+#include "BufferArena.h"
+#include "Util/Structs.h"
+
+namespace real
+{
+	// Owns the vertex arenas, one per vertex size, and the index arena every mesh allocates its geometry from
+	class MeshBufferManager final : public Singleton<MeshBufferManager>
+	{
+	public:
+		virtual ~MeshBufferManager() override = default;
+
+		MeshBufferManager(const MeshBufferManager&) = delete;
+		MeshBufferManager& operator=(const MeshBufferManager&) = delete;
+		MeshBufferManager(MeshBufferManager&&) = delete;
+		MeshBufferManager& operator=(MeshBufferManager&&) = delete;
+
+		void CleanUp(const GameContext& context);
+
+		BufferArena& GetVertexArena(uint32_t vertexSize);
+		BufferArena& GetIndexArena() { return m_IndexArena; }
+
+		// Allocates the range and uploads the data into it
+		BufferRange UploadVertices(const GameContext& context, const void* data, uint32_t vertexSize, uint32_t count);
+		BufferRange UploadIndices(const GameContext& context, const uint32_t* data, uint32_t count);
+
+		// The range is only handed out again once the frames that might still read it are finished
+		void FreeVertices(uint32_t vertexSize, const BufferRange& range);
+		void FreeIndices(const BufferRange& range);
+
+	private:
+		friend class Singleton<MeshBufferManager>;
+		MeshBufferManager() = default;
+
+		std::map<uint32_t, std::unique_ptr<BufferArena>> m_VertexArenas{};
+		BufferArena m_IndexArena{ sizeof(uint32_t), VK_BUFFER_USAGE_INDEX_BUFFER_BIT };
+	};
+}
+
+#endif // MESHBUFFERMANAGER_H
@@ -3,34 +3,29 @@
 
 #include <vulkan/vulkan_core.h>
 
+#include "Graphics/IndirectBatch.h"
 #include "Util/Concepts.h"
 
 #include "Mesh.h"
 
 namespace real
 {
-	template <vertex_type V, typename Ubo>
-	class MeshIndexed final : public Mesh<V, Ubo>
+	template <vertex_type V, typename PushConstants>
+	class MeshIndexed final : public Mesh<V, PushConstants>
 	{
 	public:
 		explicit MeshIndexed(GameObject* pOwner, MeshInfo info)
-			: Mesh<V, Ubo>(pOwner, info)
+			: Mesh<V, PushConstants>(pOwner, info)
 		{
 			m_IndexBuffers.push_back({});
 		}
 		virtual ~MeshIndexed() override
 		{
-			const auto context = RealEngine::GetGameContext();
-
-			for (auto& [isDirty, buffer, allocation, data] : m_IndexBuffers)
+			for (auto& indexBuffer : m_IndexBuffers)
 			{
-				if (buffer == nullptr)
-					continue;
-
-				vmaDestroyBuffer(context.vulkanContext.allocator, buffer, allocation);
-				buffer = nullptr;
+				MeshBufferManager::GetInstance().FreeIndices(indexBuffer.range);
+				indexBuffer.range = {};
 			}
-
 		}
 
 		MeshIndexed(const MeshIndexed&) = delete;
@@ -41,66 +36,82 @@ namespace real
 		virtual void Init(const GameContext& context) override
 		{
 			CreateIndexBuffer(context, 0);
-			Mesh<V, Ubo>::Init(context);
+			Mesh<V, PushConstants>::Init(context);
 		}
 
 		virtual void Update() override
 		{
-			Mesh<V, Ubo>::Update();
+			Mesh<V, PushConstants>::Update();
 
 			if (m_IndexBufferIsDirty == false)
 				return;
 
-			for (auto& [isDirty, buffer, memory, data] : m_IndexBuffers)
-			{
-				if (isDirty && data.empty() == false)
-				{
-					uint32_t offset = data.front();
-					std::transform(data.begin(), data.end(), data.begin(), [offset](uint32_t& i) { return i - offset; });
+			const auto context = RealEngine::GetGameContext();
 
-					UpdateIndexBuffer(data, buffer);
-					isDirty = false;
-				}
+			for (size_t i = 0; i < m_IndexBuffers.size(); ++i)
+			{
+				if (m_IndexBuffers[i].isDirty)
+					CreateIndexBuffer(context, i);
 			}
 
 			m_IndexBufferIsDirty = false;
 		}
 		virtual void Render() override
 		{
-			const auto commandBuffer = CommandPool::GetInstance().GetActiveCommandBuffer();
+			if (Mesh<V, PushConstants>::m_Info.drawIndirect)
+				return;
 
-			Mesh<V, Ubo>::m_pMaterial->Bind(commandBuffer, Mesh<V, Ubo>::m_Reference);
-			Mesh<V, Ubo>::m_pMaterial->UpdateShaderVariables(this, Mesh<V, Ubo>::m_Reference);
+			Mesh<V, PushConstants>::Render();
+		}
 
-			for (size_t i = 0; i < m_IndexBuffers.size(); ++i)
+		void AddToBatch(IndirectBatch& batch, const AABB& bounds) const
+		{
+			const auto transform = Mesh<V, PushConstants>::GetOwner()->GetTransform()->GetWorldMatrix();
+
+			const size_t count = std::min(m_IndexBuffers.size(), Mesh<V, PushConstants>::m_VertexBuffers.size());
+			for (size_t i = 0; i < count; ++i)
 			{
-				// Bind the vertex buffer
-				const VkBuffer vertexBuffers[] = { Mesh<V, Ubo>::m_VertexBuffers[i].buffer };
-				VkDeviceSize offsets[] = { 0 };
-				vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
-
-				// Bind the index buffer
-				vkCmdBindIndexBuffer(commandBuffer, m_IndexBuffers[i].buffer, 0, VK_INDEX_TYPE_UINT32);
-				vkCmdDrawIndexed(commandBuffer, static_cast<uint32_t>(m_IndexBuffers[i].data.size()), 1, 0, 0, 0);
+				batch.Add(Mesh<V, PushConstants>::m_VertexBuffers[i].range, m_IndexBuffers[i].range, transform, bounds);
 			}
 		}
 
-		virtual void Kill() override
+		// Only the indices [firstIndex, firstIndex + indexCount) of the mesh, counted over all of its sub-buffers
+		void AddToBatch(IndirectBatch& batch, const AABB& bounds, uint32_t firstIndex, uint32_t indexCount) const
 		{
-			const auto context = RealEngine::GetGameContext();
+			const auto transform = Mesh<V, PushConstants>::GetOwner()->GetTransform()->GetWorldMatrix();
+
+			uint32_t bufferFirst = 0;
+			const size_t count = std::min(m_IndexBuffers.size(), Mesh<V, PushConstants>::m_VertexBuffers.size());
+			for (size_t i = 0; i < count; ++i)
+			{
+				const auto& indexRange = m_IndexBuffers[i].range;
+
+				const uint32_t first = std::max(firstIndex, bufferFirst);
+				const uint32_t last = std::min(firstIndex + indexCount, bufferFirst + indexRange.count);
+				if (first < last)
+				{
+					const BufferRange indices{ indexRange.block, indexRange.offset + first - bufferFirst, last - first };
+					batch.Add(Mesh<V, PushConstants>::m_VertexBuffers[i].range, indices, transform, bounds);
+				}
+
+				bufferFirst += indexRange.count;
+			}
+		}
 
-			for (auto& [isDirty, buffer, allocation, data] : m_IndexBuffers)
+		virtual void Kill() override
+		{
+			for (auto& indexBuffer : m_IndexBuffers)
 			{
-				vmaDestroyBuffer(context.vulkanContext.allocator, buffer, allocation);
-				buffer = nullptr;
+				MeshBufferManager::GetInstance().FreeIndices(indexBuffer.range);
+				indexBuffer.range = {};
 			}
 
-			Mesh<V, Ubo>::Kill();
+			Mesh<V, PushConstants>::Kill();
 		}
 
 		void AddIndex(uint32_t index)
 		{
-			if (m_IndexBuffers.back().data.size() == Mesh<V, Ubo>::m_Info.indexCapacity)
+			if (m_IndexBuffers.back().data.size() == Mesh<V, PushConstants>::m_Info.indexCapacity)
 			{
 				m_IndexBuffers.back().data.push_back(index);
 				m_IndexBuffers.back().isDirty = true;
@@ -109,7 +120,7 @@ namespace real
 			{
 				m_IndexBuffers.push_back({});
 				m_IndexBuffers.back().data.push_back(index);
-				CreateIndexBuffer(RealEngine::GetGameContext(), m_IndexBuffers.size() - 1);
+				m_IndexBuffers.back().isDirty = true;
 			}
 
 			m_IndexBufferIsDirty = true;
@@ -122,19 +133,18 @@ namespace real
 				while (!v.empty())
 				{
 					m_IndexBuffers.push_back({});
-					FillUntilSize(v, m_IndexBuffers.back().data, Mesh<V, Ubo>::m_Info.indexCapacity);
-					CreateIndexBuffer(RealEngine::GetGameContext(), m_IndexBuffers.size() - 1);
+					FillUntilSize(v, m_IndexBuffers.back().data, Mesh<V, PushConstants>::m_Info.indexCapacity);
 					m_IndexBuffers.back().isDirty = true;
 				}
 				};
 
-			if (m_IndexBuffers.back().data.size() == Mesh<V, Ubo>::m_Info.indexCapacity)
+			if (m_IndexBuffers.back().data.size() == Mesh<V, PushConstants>::m_Info.indexCapacity)
 			{
 				addIndexBuffers();
 			}
 			else
 			{
-				FillUntilSize(v, m_IndexBuffers.back().data, Mesh<V, Ubo>::m_Info.indexCapacity);
+				FillUntilSize(v, m_IndexBuffers.back().data, Mesh<V, PushConstants>::m_Info.indexCapacity);
 				m_IndexBuffers.back().isDirty = true;
 
 				addIndexBuffers();
@@ -149,17 +159,11 @@ namespace real
 
 			while (v.empty() == false)
 			{
-				bool createNewBuffer = false;
 				if (counter >= m_IndexBuffers.size())
-				{
 					m_IndexBuffers.push_back({});
-					createNewBuffer = true;
-				}
 
 				m_IndexBuffers[counter].data.clear();
-				FillUntilSize(v, m_IndexBuffers[counter].data, Mesh<V, Ubo>::m_Info.indexCapacity);
-				if (createNewBuffer)
-					CreateIndexBuffer(RealEngine::GetGameContext(), counter);
+				FillUntilSize(v, m_IndexBuffers[counter].data, Mesh<V, PushConstants>::m_Info.indexCapacity);
 				m_IndexBuffers[counter].isDirty = true;
 
 				++counter;
@@ -167,65 +171,84 @@ namespace real
 
 			if (counter < m_IndexBuffers.size() - 1)
 			{
-				m_IndexBuffers.erase(m_IndexBuffers.begin() + counter, m_IndexBuffers.end());
+				EraseIndexBuffers(counter);
 			}
 
 			m_IndexBufferIsDirty = true;
 		}
 		void ClearIndices()
 		{
-			m_IndexBuffers.erase(m_IndexBuffers.begin() + 1, m_IndexBuffers.end());
+			EraseIndexBuffers(1);
 			m_IndexBuffers.front().data.clear();
+			m_IndexBuffers.front().isDirty = true;
 
 			m_IndexBufferIsDirty = true;
 		}
 
-	private:
-		bool m_IndexBufferIsDirty{ false };
-
-		std::vector<BufferContext<uint32_t>> m_IndexBuffers{};
-
-		void CreateIndexBuffer(const GameContext& context, size_t index)
+	protected:
+		virtual void Draw(VkCommandBuffer commandBuffer) override
 		{
-			VkDeviceSize bufferSize = sizeof(uint32_t) * Mesh<V, Ubo>::m_Info.indexCapacity;
+			Mesh<V, PushConstants>::m_pMaterial->UpdateShaderVariables(this);
 
-			VkBuffer stagingBuffer;
-			VmaAllocation stagingBufferAllocation;
-			CreateBuffer(context, bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-				VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer,
-				stagingBufferAllocation);
+			auto& meshBufferManager = MeshBufferManager::GetInstance();
+			const auto& vertexArena = meshBufferManager.GetVertexArena(sizeof(V));
+			const auto& indexArena = meshBufferManager.GetIndexArena();
+			uint32_t boundVertexBlock = UINT32_MAX, boundIndexBlock = UINT32_MAX;
 
-			Mesh<V, Ubo>::UpdateBuffer<uint32_t>(stagingBufferAllocation, m_IndexBuffers[index].data);
+			const size_t count = std::min(m_IndexBuffers.size(), Mesh<V, PushConstants>::m_VertexBuffers.size());
+			for (size_t i = 0; i < count; ++i)
+			{
+				const auto& vertexRange = Mesh<V, PushConstants>::m_VertexBuffers[i].range;
+				const auto& indexRange = m_IndexBuffers[i].range;
+				if (vertexRange.count == 0 || indexRange.count == 0)
+					continue;
 
-			VkBuffer indexBuffer;
-			VmaAllocation bufferAllocation;
-			CreateBuffer(context, bufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
-				VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, indexBuffer, bufferAllocation);
+				// Every sub-buffer lives in the same arena blocks, only bind when the block changes
+				if (vertexRange.block != boundVertexBlock)
+				{
+					const VkBuffer vertexBuffers[] = { vertexArena.GetBuffer(vertexRange.block) };
+					constexpr VkDeviceSize offsets[] = { 0 };
+					vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
+					boundVertexBlock = vertexRange.block;
+				}
+				if (indexRange.block != boundIndexBlock)
+				{
+					vkCmdBindIndexBuffer(commandBuffer, indexArena.GetBuffer(indexRange.block), 0, VK_INDEX_TYPE_UINT32);
+					boundIndexBlock = indexRange.block;
+				}
 
-			Mesh<V, Ubo>::CopyBuffer(context, stagingBuffer, indexBuffer, bufferSize);
+				vkCmdDrawIndexed(commandBuffer, indexRange.count, 1, indexRange.offset, static_cast<int32_t>(vertexRange.offset), 0);
+			}
+		}
 
-			m_IndexBuffers[index].buffer = indexBuffer;
-			m_IndexBuffers[index].allocation = bufferAllocation;
+	private:
+		bool m_IndexBufferIsDirty{ false };
 
-			vmaDestroyBuffer(context.vulkanContext.allocator, stagingBuffer, stagingBufferAllocation);
-		}
+		std::vector<BufferContext<uint32_t>> m_IndexBuffers{};
 
-		void UpdateIndexBuffer(const std::vector<uint32_t>& data, VkBuffer buffer)
+		void CreateIndexBuffer(const GameContext& context, size_t index)
 		{
-			const VkDeviceSize bufferSize = sizeof(uint32_t) * Mesh<V, Ubo>::m_Info.indexCapacity;
-			const auto context = RealEngine::GetGameContext();
+			auto& [isDirty, range, data] = m_IndexBuffers[index];
 
-			VkBuffer stagingBuffer;
-			VmaAllocation stagingBufferAllocation;
-			CreateBuffer(context, bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-				VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-				stagingBuffer, stagingBufferAllocation);
-
-			Mesh<V, Ubo>::UpdateBuffer<uint32_t>(stagingBufferAllocation, data);
+			if (data.empty() == false)
+			{
+				uint32_t offset = data.front();
+				std::transform(data.begin(), data.end(), data.begin(), [offset](uint32_t& i) { return i - offset; });
+			}
 
-			Mesh<V, Ubo>::CopyBuffer(context, stagingBuffer, buffer, bufferSize);
+			// Frames in flight might still read from the current range, upload into a fresh one
+			MeshBufferManager::GetInstance().FreeIndices(range);
+			range = MeshBufferManager::GetInstance().UploadIndices(context, data.data(), static_cast<uint32_t>(data.size()));
+			isDirty = false;
+		}
+		void EraseIndexBuffers(size_t first)
+		{
+			for (size_t i = first; i < m_IndexBuffers.size(); ++i)
+			{
+				MeshBufferManager::GetInstance().FreeIndices(m_IndexBuffers[i].range);
+			}
 
-			vmaDestroyBuffer(context.vulkanContext.allocator, stagingBuffer, stagingBufferAllocation);
+			m_IndexBuffers.erase(m_IndexBuffers.begin() + first, m_IndexBuffers.end());
 		}
 
 		std::vector<uint32_t> GetAllIndices()
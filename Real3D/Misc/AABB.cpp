@@ -2,7 +2,12 @@
 
 bool real::FrustumAABB::IsBoxInFrustum(const glm::mat4& viewProjMatrix, const AABB& box)
 {
-    for (const auto& plane : ExtractFrustumPlanes(viewProjMatrix))
+    return IsBoxInFrustum(ExtractFrustumPlanes(viewProjMatrix, false), box);
+}
+
+bool real::FrustumAABB::IsBoxInFrustum(const std::array<FrustumPlane, 6>& planes, const AABB& box)
+{
+    for (const auto& plane : planes)
     {
         glm::vec3 positiveVertex = box.min;
 
@@ -17,7 +22,7 @@ bool real::FrustumAABB::IsBoxInFrustum(const glm::mat4& viewProjMatrix, const AA
     return true;
 }
 
-std::array<real::FrustumPlane, 6> real::FrustumAABB::ExtractFrustumPlanes(const glm::mat4& viewProjMatrix)
+std::array<real::FrustumPlane, 6> real::FrustumAABB::ExtractFrustumPlanes(const glm::mat4& viewProjMatrix, bool normalize)
 {
     std::array<FrustumPlane, 6> planes;
 
@@ -57,6 +62,9 @@ std::array<real::FrustumPlane, 6> real::FrustumAABB::ExtractFrustumPlanes(const
     planes[5].normal.z = viewProjMatrix[2][3] - viewProjMatrix[2][2];
     planes[5].distance = viewProjMatrix[3][3] - viewProjMatrix[3][2];
 
+    if (normalize == false)
+        return planes;
+
     // Normalize planes
     for (auto& plane : planes) 
     {
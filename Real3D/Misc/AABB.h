@@ -31,8 +31,10 @@ namespace real
     {
     public:
         static bool IsBoxInFrustum(const glm::mat4& viewProjMatrix, const AABB& box);
-    private:
-    	static std::array<FrustumPlane, 6> ExtractFrustumPlanes(const glm::mat4& viewProjMatrix);
+        // For testing many boxes against the same planes, see FrustumCuller for a whole array at once
+        static bool IsBoxInFrustum(const std::array<FrustumPlane, 6>& planes, const AABB& box);
+        // Only the sign of a distance is needed to test a box, which does not require normalized planes
+        static std::array<FrustumPlane, 6> ExtractFrustumPlanes(const glm::mat4& viewProjMatrix, bool normalize = true);
     };
 }
 
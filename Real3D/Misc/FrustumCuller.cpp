@@ -0,0 +1,117 @@
+#include "FrustumCuller.h"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define REAL_FRUSTUM_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace
+{
+#if defined(__AVX__)
+	constexpr uint32_t lane_count = 8;
+#elif defined(REAL_FRUSTUM_SSE)
+	constexpr uint32_t lane_count = 4;
+#else
+	constexpr uint32_t lane_count = 1;
+#endif
+}
+
+void real::FrustumCuller::SetViewProjection(const glm::mat4& viewProjection)
+{
+	m_Planes = FrustumAABB::ExtractFrustumPlanes(viewProjection, false);
+}
+
+void real::FrustumCuller::Clear()
+{
+	m_MinX.clear();
+	m_MinY.clear();
+	m_MinZ.clear();
+	m_MaxX.clear();
+	m_MaxY.clear();
+	m_MaxZ.clear();
+	m_Visibility.clear();
+}
+
+uint32_t real::FrustumCuller::Add(const AABB& box)
+{
+	m_MinX.push_back(box.min.x);
+	m_MinY.push_back(box.min.y);
+	m_MinZ.push_back(box.min.z);
+	m_MaxX.push_back(box.max.x);
+	m_MaxY.push_back(box.max.y);
+	m_MaxZ.push_back(box.max.z);
+
+	return GetBoxCount() - 1;
+}
+
+void real::FrustumCuller::Cull()
+{
+	const uint32_t count = GetBoxCount();
+	const uint32_t paddedCount = (count + lane_padding - 1) / lane_padding * lane_padding;
+
+	for (auto* pBounds : { &m_MinX, &m_MinY, &m_MinZ, &m_MaxX, &m_MaxY, &m_MaxZ })
+		pBounds->resize(paddedCount, 0.f);
+
+	m_Visibility.assign((paddedCount + 63) / 64, 0);
+
+	for (uint32_t first = 0; first < paddedCount; first += lane_count)
+		m_Visibility[first / 64] |= static_cast<uint64_t>(TestBoxes(first)) << (first % 64);
+
+	// The padding is never visible
+	if (count % 64 != 0)
+		m_Visibility.back() &= (uint64_t{ 1 } << (count % 64)) - 1;
+
+	for (auto* pBounds : { &m_MinX, &m_MinY, &m_MinZ, &m_MaxX, &m_MaxY, &m_MaxZ })
+		pBounds->resize(count);
+}
+
+uint32_t real::FrustumCuller::TestBoxes(uint32_t first) const
+{
+	// The normal of a plane is the same for every box, so its positive vertex is picked per array instead of per box
+#if defined(__AVX__)
+	const __m256 zero = _mm256_setzero_ps();
+	__m256 visible = _mm256_cmp_ps(zero, zero, _CMP_EQ_OQ);
+
+	for (const auto& [normal, distance] : m_Planes)
+	{
+		const __m256 x = _mm256_loadu_ps(&(normal.x >= 0 ? m_MaxX : m_MinX)[first]);
+		const __m256 y = _mm256_loadu_ps(&(normal.y >= 0 ? m_MaxY : m_MinY)[first]);
+		const __m256 z = _mm256_loadu_ps(&(normal.z >= 0 ? m_MaxZ : m_MinZ)[first]);
+
+		__m256 dot = _mm256_add_ps(_mm256_mul_ps(x, _mm256_set1_ps(normal.x)), _mm256_set1_ps(distance));
+		dot = _mm256_add_ps(dot, _mm256_mul_ps(y, _mm256_set1_ps(normal.y)));
+		dot = _mm256_add_ps(dot, _mm256_mul_ps(z, _mm256_set1_ps(normal.z)));
+
+		visible = _mm256_and_ps(visible, _mm256_cmp_ps(dot, zero, _CMP_GE_OQ));
+		if (_mm256_movemask_ps(visible) == 0)
+			return 0;
+	}
+
+	return static_cast<uint32_t>(_mm256_movemask_ps(visible));
+#elif defined(REAL_FRUSTUM_SSE)
+	const __m128 zero = _mm_setzero_ps();
+	__m128 visible = _mm_cmpeq_ps(zero, zero);
+
+	for (const auto& [normal, distance] : m_Planes)
+	{
+		const __m128 x = _mm_loadu_ps(&(normal.x >= 0 ? m_MaxX : m_MinX)[first]);
+		const __m128 y = _mm_loadu_ps(&(normal.y >= 0 ? m_MaxY : m_MinY)[first]);
+		const __m128 z = _mm_loadu_ps(&(normal.z >= 0 ? m_MaxZ : m_MinZ)[first]);
+
+		__m128 dot = _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(normal.x)), _mm_set1_ps(distance));
+		dot = _mm_add_ps(dot, _mm_mul_ps(y, _mm_set1_ps(normal.y)));
+		dot = _mm_add_ps(dot, _mm_mul_ps(z, _mm_set1_ps(normal.z)));
+
+		visible = _mm_and_ps(visible, _mm_cmpge_ps(dot, zero));
+		if (_mm_movemask_ps(visible) == 0)
+			return 0;
+	}
+
+	return static_cast<uint32_t>(_mm_movemask_ps(visible));
+#else
+	const AABB box{ { m_MinX[first], m_MinY[first], m_MinZ[first] }, { m_MaxX[first], m_MaxY[first], m_MaxZ[first] } };
+	return FrustumAABB::IsBoxInFrustum(m_Planes, box) ? 1 : 0;
+#endif
+}
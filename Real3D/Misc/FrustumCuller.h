@@ -0,0 +1,53 @@
+#ifndef FRUSTUMCULLER_H
+#define FRUSTUMCULLER_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "AABB.h"
+
+namespace real
+{
+	// Tests an array of boxes against the frustum of a frame, the planes are only extracted once.
+	// The boxes are stored as a structure of arrays, so 8 (AVX) or 4 (SSE) of them are tested at once.
+	class FrustumCuller final
+	{
+	public:
+		explicit FrustumCuller() = default;
+		~FrustumCuller() = default;
+
+		FrustumCuller(const FrustumCuller&) = delete;
+		FrustumCuller& operator=(const FrustumCuller&) = delete;
+		FrustumCuller(FrustumCuller&&) = delete;
+		FrustumCuller& operator=(FrustumCuller&&) = delete;
+
+		void SetViewProjection(const glm::mat4& viewProjection);
+
+		void Clear();
+		// Returns the index of the box in the visibility mask
+		uint32_t Add(const AABB& box);
+
+		void Cull();
+
+		bool IsVisible(uint32_t index) const { return (m_Visibility[index / 64] >> (index % 64)) & 1; }
+		// One bit per box, in the order they were added
+		const std::vector<uint64_t>& GetVisibility() const { return m_Visibility; }
+		uint32_t GetBoxCount() const { return static_cast<uint32_t>(m_MinX.size()); }
+
+	private:
+		// The arrays are padded to a multiple of the widest lane count while culling
+		static constexpr uint32_t lane_padding = 8;
+
+		std::array<FrustumPlane, 6> m_Planes{};
+
+		std::vector<float> m_MinX{}, m_MinY{}, m_MinZ{};
+		std::vector<float> m_MaxX{}, m_MaxY{}, m_MaxZ{};
+		std::vector<uint64_t> m_Visibility{};
+
+		// A bit for every box in [first, first + lane count)
+		uint32_t TestBoxes(uint32_t first) const;
+	};
+}
+
+#endif // FRUSTUMCULLER_H
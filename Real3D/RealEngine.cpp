@@ -1,21 +1,35 @@
 #include "RealEngine.h"
 
+#include <algorithm>
 #include <set>
+#include <string_view>
 
 #include <SDL2/SDL_vulkan.h>
 #include <SDL_image.h>
 
+#include <real_core/Benchmark.h>
+#include <real_core/CpuProfiler.h>
 #include <real_core/GameTime.h>
 #include <real_core/InputManager.h>
 #include <real_core/imgui_impl_sdl2.h>
+#include <real_core/implot.h>
 #include <real_core/SceneManager.h>
 
 #include "Core/DepthBuffer/DepthBufferManager.h"
 #include "Content/ContentManager.h"
 #include "Core/CommandPool.h"
+#include "Core/MemoryTracker.h"
+#include "Core/UploadManager.h"
+#include "Graphics/GpuProfiler.h"
+#include "Graphics/PipelineCache.h"
 #include "Graphics/ShaderManager.h"
+#include "Material/CameraBuffer.h"
 #include "Material/MaterialManager.h"
+#include "Material/PipelineRegistry.h"
+#include "Mesh/MeshBufferManager.h"
 #include "Graphics/Renderer.h"
+#include "Graphics/RenderPass.h"
+#include "Graphics/RenderQueue.h"
 #include "ImGui/imgui_impl_vulkan.h"
 
 #define VK_USE_PLATFORM_WIN32_KHR
@@ -23,8 +37,14 @@
 #include "Core/DescriptorPoolManager.h"
 #include "util/vk_mem_alloc.h"
 
-real::RealEngine::RealEngine()
+real::RealEngine::RealEngine(const GameContext& context)
 {
+	m_GameContext = context;
+
+	// Enabled before the scene is loaded, so the chunks generated while loading end up in the first frame
+	CpuProfiler::GetInstance().SetEnabled(m_GameContext.profiling);
+	REAL_PROFILE_THREAD("Main");
+
 	InitSDL();
 	InitVulkan();
 	InitVma();
@@ -35,6 +55,8 @@ real::RealEngine::RealEngine()
 void real::RealEngine::Run(const std::function<void()>& load)
 {
 	load();
+	MaterialManager::GetInstance().BuildPipelines();
+	PipelineCache::GetInstance().LogCreationTime();
 
 	MainLoop();
 	CleanUp();
@@ -42,6 +64,19 @@ void real::RealEngine::Run(const std::function<void()>& load)
 
 void real::RealEngine::InitSDL()
 {
+	if (m_GameContext.headless)
+	{
+		// Only the events are needed, a quit request still ends the run early
+		if (SDL_Init(SDL_INIT_EVENTS) != 0)
+		{
+			throw std::runtime_error(std::string("SDL_Init Error: ") + SDL_GetError());
+		}
+
+		m_GameContext.pWindow = nullptr;
+		InitSDLImage();
+		return;
+	}
+
 	InitWindow(m_GameContext.windowTitle, m_GameContext.windowWidth, m_GameContext.windowHeight, SDL_WINDOW_VULKAN);
 	m_GameContext.pWindow = GetWindow();
 
@@ -67,7 +102,8 @@ void real::RealEngine::InitVulkan()
 	SetupDebugMessenger();
 
 	// Create Surface
-	CreateSurface();
+	if (m_GameContext.headless == false)
+		CreateSurface();
 
 	// Pick PhysicalDevice
 	PickPhysicalDevice();
@@ -86,8 +122,10 @@ void real::RealEngine::InitVma() const
 	vulkanFunctions.vkGetDeviceProcAddr = &vkGetDeviceProcAddr;
 
 	VmaAllocatorCreateInfo allocatorCreateInfo = {};
-	//allocatorCreateInfo.flags = VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
-	allocatorCreateInfo.vulkanApiVersion = VK_API_VERSION_1_0;
+	if (m_IsMemoryBudgetSupported)
+		allocatorCreateInfo.flags = VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+	// The budget is queried through vkGetPhysicalDeviceMemoryProperties2, which is core since 1.1
+	allocatorCreateInfo.vulkanApiVersion = VK_API_VERSION_1_2;
 	allocatorCreateInfo.physicalDevice = m_GameContext.vulkanContext.physicalDevice;
 	allocatorCreateInfo.device = m_GameContext.vulkanContext.device;
 	allocatorCreateInfo.instance = m_Instance;
@@ -96,6 +134,8 @@ void real::RealEngine::InitVma() const
 	VmaAllocator allocator;
 	vmaCreateAllocator(&allocatorCreateInfo, &allocator);
 	m_GameContext.vulkanContext.allocator = allocator;
+
+	MemoryTracker::GetInstance().Init(m_GameContext, m_IsMemoryBudgetSupported);
 }
 
 void real::RealEngine::InitRenderer()
@@ -104,14 +144,25 @@ void real::RealEngine::InitRenderer()
 	auto& renderer = Renderer::GetInstance();
 
 	shaderManager.Init("resources/shaders");
+	PipelineCache::GetInstance().Init(m_GameContext);
 	renderer.Init(m_GameContext);
+
+	UploadManager::GetInstance().Init(m_GameContext);
+	CameraBuffer::GetInstance().Init(m_GameContext);
+	RenderQueue::GetInstance().Init(m_GameContext);
+	GpuProfiler::GetInstance().Init(m_GameContext);
 }
 
 void real::RealEngine::InitImGui()
 {
+	// There is no window to draw the overlay in
+	if (m_GameContext.headless)
+		return;
+
 	// Setup Dear ImGui context
 	IMGUI_CHECKVERSION();
 	ImGui::CreateContext();
+	ImPlot::CreateContext();
 	ImGuiIO& io = ImGui::GetIO();
 	io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;     // Enable Keyboard Controls
 	io.ConfigFlags |= ImGuiConfigFlags_NavEnableGamepad;      // Enable Gamepad Controls
@@ -140,6 +191,9 @@ void real::RealEngine::InitImGui()
 		vkCreateDescriptorPool(m_GameContext.vulkanContext.device, &poolInfo, nullptr, &m_ImGuiDescriptorPool);
 	}
 	initInfo.DescriptorPool = m_ImGuiDescriptorPool;
+	initInfo.PipelineCache = PipelineCache::GetInstance().GetCache();
+	// The only subpass that is always recorded inline when OIT is used
+	initInfo.Subpass = m_GameContext.weightedBlendedOit ? RenderPass::composite_subpass : RenderPass::opaque_subpass;
 	initInfo.MinImageCount = 2;
 	initInfo.ImageCount = 2;
 	initInfo.MSAASamples = VK_SAMPLE_COUNT_1_BIT;
@@ -152,28 +206,103 @@ void real::RealEngine::MainLoop()
 	auto& input = real::InputManager::GetInstance();
 	auto& renderer = Renderer::GetInstance();
 	auto& sceneManager = real::SceneManager::GetInstance();
+	auto& cpuProfiler = CpuProfiler::GetInstance();
+	auto& memoryTracker = MemoryTracker::GetInstance();
+	auto& benchmark = Benchmark::GetInstance();
+
+	if (m_GameContext.replayPath.empty() == false)
+	{
+		input.StartReplay(m_GameContext.replayPath);
+		time.SetFixedDeltaTime(input.GetRecordingDeltaTime());
+	}
+	else if (m_GameContext.recordPath.empty() == false)
+	{
+		input.StartRecording(m_GameContext.recordPath, replay_delta_time);
+		time.SetFixedDeltaTime(replay_delta_time);
+	}
+
+	// A fixed run keeps every frame time for the summary at the end
+	benchmark.SetEnabled(m_GameContext.frameCount > 0 || input.IsReplaying());
+	const auto uploadedBytes = UploadManager::GetInstance().GetUploadedBytes();
 
 	time.Init();
 
 	float timer = 0;
 	bool doContinue = true;
+	uint32_t frame = 0;
 
 	while (doContinue)
 	{
+		cpuProfiler.NewFrame();
+
 		time.Update();
 		const auto currentTime = std::chrono::high_resolution_clock::now();
 
 		doContinue = input.ProcessInput();
 
+		// Before the scene update, so the observers of the budget can react in the same frame
+		memoryTracker.Update(m_GameContext);
 		sceneManager.Update();
+
+		if (m_GameContext.profiling && m_GameContext.headless == false)
+		{
+			REAL_PROFILE_ZONE("Gui");
+
+			ImGui_ImplVulkan_NewFrame();
+			ImGui_ImplSDL2_NewFrame();
+			ImGui::NewFrame();
+
+			sceneManager.OnGui();
+			GpuProfiler::GetInstance().OnGui();
+			cpuProfiler.OnGui();
+			memoryTracker.OnGui();
+
+			ImGui::Render();
+		}
+
 		renderer.Draw(m_GameContext);
 
+		// The first frame also measures the loading, it is left out
+		if (frame > 0)
+			benchmark.AddFrameTime(time.GetFrameTime() * 1000.f);
+
+		if (++frame == m_GameContext.frameCount)
+			doContinue = false;
+
 		timer += time.GetElapsed();
 		if (constexpr float fpsPrintTime = 1.f; 
 			timer >= fpsPrintTime)
 		{
 			timer = 0;
 			std::cout << "\033[1;90mFPS: " << time.GetFPS_Unsigned() << "\033[0m\n";
+
+			// The statistics would bury the warnings in the console, they are only printed when profiling
+			if (m_GameContext.profiling)
+			{
+				const auto& stats = RenderQueue::GetInstance().GetStats();
+				std::cout << "\033[1;90mDraws: " << stats.packets
+					<< " | pipeline binds: " << stats.pipelineBinds
+					<< " | descriptor binds: " << stats.descriptorBinds
+					<< " | cached: " << stats.cachedPackets << "\033[0m\n";
+
+				const auto descriptorStats = DescriptorPoolManager::GetInstance().GetStats();
+				std::cout << "\033[1;90mDescriptors: " << descriptorStats.pools << " pools, " << descriptorStats.transientPools << " transient pools"
+					<< " | layouts: " << descriptorStats.layouts
+					<< " | allocations: " << descriptorStats.allocations << ", " << descriptorStats.transientAllocations << " transient"
+					<< " | cache hit rate: " << static_cast<int>(descriptorStats.GetHitRate() * 100) << "% ("
+					<< descriptorStats.cacheHits << "/" << descriptorStats.cacheHits + descriptorStats.cacheMisses << ")\033[0m\n";
+
+				const auto& budget = memoryTracker.GetBudget();
+				std::cout << "\033[1;90mMemory: " << budget.usage / (1024 * 1024) << "/" << budget.budget / (1024 * 1024) << " MB device local";
+				for (uint8_t i = 0; i < static_cast<uint8_t>(EMemoryCategory::count); ++i)
+				{
+					const auto category = static_cast<EMemoryCategory>(i);
+					const auto memoryStats = memoryTracker.GetStats(category);
+					if (memoryStats.allocations > 0)
+						std::cout << " | " << MemoryTracker::GetCategoryName(category) << ": " << memoryStats.bytes / (1024 * 1024) << " MB, " << memoryStats.allocations;
+				}
+				std::cout << "\033[0m\n";
+			}
 		}
 
 //#ifdef NDEBUG
@@ -184,6 +313,18 @@ void real::RealEngine::MainLoop()
 	}
 
 	vkDeviceWaitIdle(m_GameContext.vulkanContext.device);
+
+	input.StopRecording();
+
+	benchmark.Count("Uploaded bytes", UploadManager::GetInstance().GetUploadedBytes() - uploadedBytes);
+	benchmark.PrintReport();
+
+	// Nothing can be exported from the overlay without a window
+	if (m_GameContext.headless && m_GameContext.profiling)
+	{
+		GpuProfiler::GetInstance().ExportCsv("gpu_profile.csv");
+		cpuProfiler.ExportChromeTrace("cpu_trace.json");
+	}
 }
 
 void real::RealEngine::CleanUp()
@@ -194,15 +335,25 @@ void real::RealEngine::CleanUp()
 	Renderer::GetInstance().CleanUp(m_GameContext);
 	DepthBufferManager::GetInstance().CleanUp(m_GameContext);
 	MaterialManager::GetInstance().RemoveMaterials(m_GameContext);
+	PipelineRegistry::GetInstance().CleanUp(m_GameContext);
+	CameraBuffer::GetInstance().CleanUp(m_GameContext);
 	ContentManager::GetInstance().CleanUp(m_GameContext);
+	UploadManager::GetInstance().CleanUp(m_GameContext);
+	MeshBufferManager::GetInstance().CleanUp(m_GameContext);
 	ShaderManager::GetInstance().DestroyShaderModules(m_GameContext.vulkanContext.device);
+	PipelineCache::GetInstance().CleanUp(m_GameContext);
 	DescriptorPoolManager::GetInstance().CleanUp();
+	GpuProfiler::GetInstance().CleanUp(m_GameContext);
 
-	ImGui_ImplVulkan_Shutdown();
-	ImGui_ImplSDL2_Shutdown();
-	ImGui::DestroyContext();
+	if (m_GameContext.headless == false)
+	{
+		ImGui_ImplVulkan_Shutdown();
+		ImGui_ImplSDL2_Shutdown();
+		ImPlot::DestroyContext();
+		ImGui::DestroyContext();
 
-	vkDestroyDescriptorPool(m_GameContext.vulkanContext.device, m_ImGuiDescriptorPool, nullptr);
+		vkDestroyDescriptorPool(m_GameContext.vulkanContext.device, m_ImGuiDescriptorPool, nullptr);
+	}
 	vkDestroyRenderPass(m_GameContext.vulkanContext.device, m_GameContext.vulkanContext.renderPass, nullptr);
 
 	CommandPool::GetInstance().CleanUp(m_GameContext);
@@ -216,7 +367,8 @@ void real::RealEngine::CleanUp()
 
 	vkDestroyDevice(m_GameContext.vulkanContext.device, nullptr);
 
-	vkDestroySurfaceKHR(m_Instance, m_GameContext.vulkanContext.surface, nullptr);
+	if (m_GameContext.vulkanContext.surface != VK_NULL_HANDLE)
+		vkDestroySurfaceKHR(m_Instance, m_GameContext.vulkanContext.surface, nullptr);
 	vkDestroyInstance(m_Instance, nullptr);
 
 	SDL_DestroyWindow(m_GameContext.pWindow);
@@ -237,7 +389,7 @@ void real::RealEngine::CreateInstance()
 	appInfo.applicationVersion = VK_MAKE_VERSION(1, 0, 0);
 	appInfo.pEngineName = "TBD";
 	appInfo.engineVersion = VK_MAKE_VERSION(1, 0, 0);
-	appInfo.apiVersion = VK_API_VERSION_1_0;
+	appInfo.apiVersion = VK_API_VERSION_1_2;
 
 	VkInstanceCreateInfo createInfo{};
 	createInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
@@ -273,6 +425,15 @@ std::vector<const char*> real::RealEngine::GetRequiredExtensions()
 {
 	std::vector<const char*> extensions;
 
+	// Headless nothing is presented, the surface extensions are not needed
+	if (m_GameContext.headless)
+	{
+		if (enableValidationLayers)
+			extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
+
+		return extensions;
+	}
+
 	// SDL Vulkan extensions
 	unsigned int sdlExtensionCount = 0;
 	if (!SDL_Vulkan_GetInstanceExtensions(m_GameContext.pWindow, &sdlExtensionCount, nullptr)) {
@@ -392,7 +553,12 @@ bool real::RealEngine::IsDeviceSuitable(const VkPhysicalDevice& device)
 	VkPhysicalDeviceFeatures supportedFeatures;
 	vkGetPhysicalDeviceFeatures(device, &supportedFeatures);
 
-	return indices.isComplete() && extensionsSupported /*&& swapChainAdequate */&& supportedFeatures.samplerAnisotropy;
+	// Timeline semaphores are core since 1.2
+	VkPhysicalDeviceProperties properties;
+	vkGetPhysicalDeviceProperties(device, &properties);
+
+	return indices.isComplete() && extensionsSupported /*&& swapChainAdequate */&& supportedFeatures.samplerAnisotropy
+		&& supportedFeatures.drawIndirectFirstInstance && properties.apiVersion >= VK_API_VERSION_1_2;
 }
 
 bool real::RealEngine::CheckDeviceExtensionSupport(VkPhysicalDevice device)
@@ -403,7 +569,8 @@ bool real::RealEngine::CheckDeviceExtensionSupport(VkPhysicalDevice device)
 	std::vector<VkExtensionProperties> availableExtensions(extensionCount);
 	vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, availableExtensions.data());
 
-	std::set<std::string> requiredExtensions(m_DeviceExtensions.begin(), m_DeviceExtensions.end());
+	const auto deviceExtensions = GetDeviceExtensions();
+	std::set<std::string> requiredExtensions(deviceExtensions.begin(), deviceExtensions.end());
 
 	for (const auto& extension : availableExtensions) {
 		requiredExtensions.erase(extension.extensionName);
@@ -412,12 +579,35 @@ bool real::RealEngine::CheckDeviceExtensionSupport(VkPhysicalDevice device)
 	return requiredExtensions.empty();
 }
 
+std::vector<const char*> real::RealEngine::GetDeviceExtensions() const
+{
+	// The swap chain is all the required extensions are used for
+	if (m_GameContext.headless)
+		return {};
+
+	return m_DeviceExtensions;
+}
+
+bool real::RealEngine::IsDeviceExtensionSupported(VkPhysicalDevice device, const char* extension)
+{
+	uint32_t extensionCount;
+	vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, nullptr);
+
+	std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+	vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, availableExtensions.data());
+
+	return std::ranges::any_of(availableExtensions, [extension](const VkExtensionProperties& properties)
+		{
+			return std::string_view(properties.extensionName) == extension;
+		});
+}
+
 void real::RealEngine::CreateLogicalDevice()
 {
 	QueueFamilyIndices indices = FindQueueFamilies(m_GameContext.vulkanContext.physicalDevice, m_GameContext.vulkanContext.surface);
 
 	std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
-	std::set<uint32_t> uniqueQueueFamilies = { indices.graphicsFamily.value(), indices.presentFamily.value()/*, indices.transferFamily.value()*/ };
+	std::set<uint32_t> uniqueQueueFamilies = { indices.graphicsFamily.value(), indices.presentFamily.value(), indices.transferFamily.value() };
 
 	float queuePriority = 1.0f;
 	for (uint32_t queueFamily : uniqueQueueFamilies) {
@@ -434,19 +624,43 @@ void real::RealEngine::CreateLogicalDevice()
 	queueCreateInfo.queueFamilyIndex = indices.graphicsFamily.value();
 	queueCreateInfo.queueCount = 1;
 
+	VkPhysicalDeviceFeatures supportedFeatures;
+	vkGetPhysicalDeviceFeatures(m_GameContext.vulkanContext.physicalDevice, &supportedFeatures);
+
 	VkPhysicalDeviceFeatures deviceFeatures{};
 	deviceFeatures.samplerAnisotropy = VK_TRUE;
+	deviceFeatures.drawIndirectFirstInstance = VK_TRUE;
+	deviceFeatures.multiDrawIndirect = supportedFeatures.multiDrawIndirect;
+
+	VkPhysicalDeviceVulkan12Features supportedVulkan12Features{};
+	supportedVulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+	VkPhysicalDeviceFeatures2 supportedFeatures2{};
+	supportedFeatures2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+	supportedFeatures2.pNext = &supportedVulkan12Features;
+	vkGetPhysicalDeviceFeatures2(m_GameContext.vulkanContext.physicalDevice, &supportedFeatures2);
+
+	VkPhysicalDeviceVulkan12Features vulkan12Features{};
+	vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+	vulkan12Features.timelineSemaphore = VK_TRUE;
+	vulkan12Features.drawIndirectCount = supportedVulkan12Features.drawIndirectCount;
 
 	VkDeviceCreateInfo createInfo{};
 	createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+	createInfo.pNext = &vulkan12Features;
 
 	createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
 	createInfo.pQueueCreateInfos = queueCreateInfos.data();
 	
 	createInfo.pEnabledFeatures = &deviceFeatures;
 
-	createInfo.enabledExtensionCount = static_cast<uint32_t>(m_DeviceExtensions.size());
-	createInfo.ppEnabledExtensionNames = m_DeviceExtensions.data();
+	// Optional, without it VMA estimates the budget from the heap sizes
+	auto extensions = GetDeviceExtensions();
+	m_IsMemoryBudgetSupported = IsDeviceExtensionSupported(m_GameContext.vulkanContext.physicalDevice, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+	if (m_IsMemoryBudgetSupported)
+		extensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+
+	createInfo.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
+	createInfo.ppEnabledExtensionNames = extensions.data();
 
 	if (enableValidationLayers) 
 	{
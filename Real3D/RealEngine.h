@@ -18,7 +18,7 @@ namespace real
 	class RealEngine final : public EngineBase
 	{
 	public:
-		explicit RealEngine();
+		explicit RealEngine(const GameContext& context = {});
 		virtual ~RealEngine() override = default;
 
 		RealEngine(const RealEngine&) = delete;
@@ -31,11 +31,15 @@ namespace real
 		static GameContext GetGameContext() { return m_GameContext; }
 
 	private:
+		// Recordings and replays advance the game by this delta time every frame, so a replay follows the same path
+		static constexpr float replay_delta_time = 1.f / 60.f;
+
 		static inline GameContext m_GameContext{};
 
 		VkInstance m_Instance{ nullptr };
 		VkDebugUtilsMessengerEXT m_DebugMessenger{ nullptr };
 		VkDescriptorPool m_ImGuiDescriptorPool{ nullptr };
+		bool m_IsMemoryBudgetSupported{ false };
 
 		const std::vector<const char*> m_ValidationLayers =
 		{
@@ -68,6 +72,8 @@ namespace real
 		void PickPhysicalDevice();
 		bool IsDeviceSuitable(const VkPhysicalDevice& device);
 		bool CheckDeviceExtensionSupport(VkPhysicalDevice device);
+		static bool IsDeviceExtensionSupported(VkPhysicalDevice device, const char* extension);
+		std::vector<const char*> GetDeviceExtensions() const;
 
 		void CreateLogicalDevice();
 
@@ -20,6 +20,10 @@ namespace real
 	class Pipeline;
 	template <typename P>
 	concept pipeline_type = std::is_base_of_v<Pipeline, P>;
+
+	class BaseMaterial;
+	template <typename M>
+	concept material_type = std::is_base_of_v<BaseMaterial, M>;
 }
 
 #endif // CONCEPTS_H
\ No newline at end of file
@@ -31,6 +31,15 @@ namespace real
 		uint32_t windowWidth{ 800 }, windowHeight{ 600 };
 		std::string windowTitle{ "Vulkan Tutorial" };
 		float inputUpdateFrequency{ 0.016f };	// => one update every 16 milliseconds or 60 FPS
+		bool weightedBlendedOit{ false };		// => transparent geometry is resolved order independent, no sorting needed
+		uint32_t recordingThreads{ 0 };			// => the scene is recorded into secondary command buffers by this many threads, 0 records it inline
+		bool anisotropicFiltering{ false };		// => texture arrays are sampled with the maximum anisotropy of the device
+		bool profiling{ false };				// => the cpu zones, the gpu time of the passes and the memory usage are shown in an ImGui overlay
+		bool occlusionCulling{ false };			// => chunks hidden behind the depth of the previous frame are culled on the gpu
+		bool headless{ false };					// => rendered into offscreen images of the window size, without a window or presenting
+		uint32_t frameCount{ 0 };				// => the main loop stops after this many frames, 0 keeps running until the window is closed
+		std::string recordPath{};				// => the input of every frame is recorded to this file, played at a fixed delta time
+		std::string replayPath{};				// => the input is replayed from this recording and the frame times are reported when it ends
 		VulkanContext vulkanContext;
 		SDL_Window* pWindow;
 	};
@@ -39,12 +48,13 @@ namespace real
 	{
 		std::optional<uint32_t> graphicsFamily;
 		std::optional<uint32_t> presentFamily;
-	
-		// TODO: https://vulkan-tutorial.com/Vertex_buffers/Staging_buffer
-		//std::optional<uint32_t> transferFamily;
+		std::optional<uint32_t> transferFamily;	// => falls back to the graphics family without a dedicated one
 	
 		bool isComplete() {
-			return graphicsFamily.has_value() && presentFamily.has_value()/* && transferFamily.has_value()*/;
+			return graphicsFamily.has_value() && presentFamily.has_value() && transferFamily.has_value();
+		}
+		bool hasDedicatedTransfer() const {
+			return transferFamily.has_value() && transferFamily != graphicsFamily;
 		}
 	};
 	
@@ -181,12 +191,17 @@ namespace real
 	};
 #pragma endregion Vertex Structures
 #pragma region Uniform Buffer
-	struct alignas(16) UniformBufferObject
+	struct alignas(16) CameraUbo
 	{
-		glm::mat4 model;
 		glm::mat4 view;
 		glm::mat4 proj;
 	};
+
+	// Pushed per draw, the camera lives in the CameraBuffer
+	struct ObjectConstants
+	{
+		glm::mat4 model;
+	};
 #pragma endregion Uniform Buffer}
 }
 
@@ -49,17 +49,22 @@ real::QueueFamilyIndices real::FindQueueFamilies(const VkPhysicalDevice& device,
     int i = 0;
     for (const auto& queueFamily : queueFamilies)
     {
-        if (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT)
+        if (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT && indices.graphicsFamily.has_value() == false)
             indices.graphicsFamily = i;
 
+        // Headless there is no surface to present to, the graphics family stands in for the present family
         VkBool32 presentSupport = false;
-        vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface, &presentSupport);
+        if (surface == VK_NULL_HANDLE)
+            presentSupport = indices.graphicsFamily == static_cast<uint32_t>(i);
+        else
+            vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface, &presentSupport);
 
-        if (presentSupport)
+        if (presentSupport && indices.presentFamily.has_value() == false)
             indices.presentFamily = i;
 
-        //if (queueFamily.queueFlags & VK_QUEUE_TRANSFER_BIT)
-        //	indices.transferFamily = i;
+        // A transfer only family maps to the copy engines, these run next to the graphics work
+        if (queueFamily.queueFlags & VK_QUEUE_TRANSFER_BIT && (queueFamily.queueFlags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT)) == 0)
+            indices.transferFamily = i;
 
         if (indices.isComplete())
             break;
@@ -67,11 +72,15 @@ real::QueueFamilyIndices real::FindQueueFamilies(const VkPhysicalDevice& device,
         ++i;
     }
 
+    if (indices.transferFamily.has_value() == false)
+        indices.transferFamily = indices.graphicsFamily;
+
     return indices;
 }
 
 void real::CreateImage(const real::GameContext& context, uint32_t width, uint32_t height, VkFormat format, VkImageTiling tiling,
-                 VkImageUsageFlags usage, VkMemoryPropertyFlags properties, VkImage& image, VmaAllocation& imageAllocation)
+                 VkImageUsageFlags usage, VkMemoryPropertyFlags properties, VkImage& image, VmaAllocation& imageAllocation,
+                 uint32_t mipLevels, uint32_t arrayLayers, EMemoryCategory category)
 {
     VkImageCreateInfo imageInfo{};
     imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
@@ -79,8 +88,8 @@ void real::CreateImage(const real::GameContext& context, uint32_t width, uint32_
     imageInfo.extent.width = width;
     imageInfo.extent.height = height;
     imageInfo.extent.depth = 1;
-    imageInfo.mipLevels = 1;
-    imageInfo.arrayLayers = 1;
+    imageInfo.mipLevels = mipLevels;
+    imageInfo.arrayLayers = arrayLayers;
     imageInfo.format = format;
     imageInfo.tiling = tiling;
     imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
@@ -98,6 +107,8 @@ void real::CreateImage(const real::GameContext& context, uint32_t width, uint32_
         throw std::runtime_error("failed to create image with VMA!");
     }
 
+    MemoryTracker::GetInstance().Track(context.vulkanContext.allocator, imageAllocation, category);
+
     //if (vkCreateImage(context.vulkanContext.device, &imageInfo, nullptr, &image) != VK_SUCCESS) {
     //    throw std::runtime_error("failed to create image!");
     //}
@@ -117,6 +128,12 @@ void real::CreateImage(const real::GameContext& context, uint32_t width, uint32_
     //vkBindImageMemory(context.vulkanContext.device, image, imageMemory, 0);
 }
 
+void real::DestroyImage(VmaAllocator allocator, VkImage image, VmaAllocation imageAllocation)
+{
+    MemoryTracker::GetInstance().Untrack(allocator, imageAllocation);
+    vmaDestroyImage(allocator, image, imageAllocation);
+}
+
 VkImageView real::CreateImageView(const GameContext& context, VkImage image, VkFormat format,
 	VkImageAspectFlags aspectFlags)
 {
@@ -155,7 +172,7 @@ VkPipelineInputAssemblyStateCreateInfo real::CreateInputAssemblyStateInfo(VkPrim
 }
 
 void real::CreateBuffer(const real::GameContext& context, VkDeviceSize size, VkBufferUsageFlags usage,
-	VkMemoryPropertyFlags properties, VkBuffer& buffer, VmaAllocation& bufferAllocation)
+	VkMemoryPropertyFlags properties, VkBuffer& buffer, VmaAllocation& bufferAllocation, EMemoryCategory category)
 {
     // Create buffer
     VkBufferCreateInfo bufferInfo{};
@@ -172,6 +189,14 @@ void real::CreateBuffer(const real::GameContext& context, VkDeviceSize size, VkB
     if (vmaCreateBuffer(context.vulkanContext.allocator, &bufferInfo, &allocInfo, &buffer, &bufferAllocation, nullptr) != VK_SUCCESS) {
         throw std::runtime_error("failed to create buffer with VMA!");
     }
+
+    MemoryTracker::GetInstance().Track(context.vulkanContext.allocator, bufferAllocation, category);
+}
+
+void real::DestroyBuffer(VmaAllocator allocator, VkBuffer buffer, VmaAllocation bufferAllocation)
+{
+    MemoryTracker::GetInstance().Untrack(allocator, bufferAllocation);
+    vmaDestroyBuffer(allocator, buffer, bufferAllocation);
 }
 
 VkImageView real::CreateImageView(const real::GameContext& context, VkImage image, VkFormat format)
@@ -194,6 +219,27 @@ VkImageView real::CreateImageView(const real::GameContext& context, VkImage imag
     return imageView;
 }
 
+VkImageView real::CreateImageArrayView(const GameContext& context, VkImage image, VkFormat format, uint32_t mipLevels,
+    uint32_t layerCount)
+{
+    VkImageViewCreateInfo viewInfo{};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image = image;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
+    viewInfo.format = format;
+    viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    viewInfo.subresourceRange.baseMipLevel = 0;
+    viewInfo.subresourceRange.levelCount = mipLevels;
+    viewInfo.subresourceRange.baseArrayLayer = 0;
+    viewInfo.subresourceRange.layerCount = layerCount;
+
+    VkImageView imageView;
+    if (vkCreateImageView(context.vulkanContext.device, &viewInfo, nullptr, &imageView) != VK_SUCCESS)
+        throw std::runtime_error("failed to create texture array image view!");
+
+    return imageView;
+}
+
 std::vector<char> real::ReadFile(const std::string& filename) {
 	std::ifstream file(filename, std::ios::ate | std::ios::binary);
 
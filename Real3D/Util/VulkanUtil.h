@@ -9,6 +9,7 @@
 
 #include "Structs.h"
 #include "Concepts.h"
+#include "Core/MemoryTracker.h"
 
 namespace real
 {
@@ -27,9 +28,13 @@ namespace real
 	QueueFamilyIndices FindQueueFamilies(const VkPhysicalDevice& device, const VkSurfaceKHR& surface);
 
 	void CreateImage(const real::GameContext& context, uint32_t width, uint32_t height, VkFormat format, VkImageTiling tiling,
-		VkImageUsageFlags usage, VkMemoryPropertyFlags properties, VkImage& image, VmaAllocation& imageAllocation);
+		VkImageUsageFlags usage, VkMemoryPropertyFlags properties, VkImage& image, VmaAllocation& imageAllocation,
+		uint32_t mipLevels = 1, uint32_t arrayLayers = 1, EMemoryCategory category = EMemoryCategory::other);
+	void DestroyImage(VmaAllocator allocator, VkImage image, VmaAllocation imageAllocation);
 	VkImageView CreateImageView(const GameContext& context, VkImage image, VkFormat format, VkImageAspectFlags aspectFlags);
 	VkImageView CreateImageView(const GameContext& context, VkImage image, VkFormat format);
+	// Views every mip level and layer of a color image as a 2D array
+	VkImageView CreateImageArrayView(const GameContext& context, VkImage image, VkFormat format, uint32_t mipLevels, uint32_t layerCount);
 
 	template<vertex_type V>
 	VkPipelineVertexInputStateCreateInfo GetVertexInputInfo()
@@ -50,7 +55,10 @@ namespace real
 	VkPipelineInputAssemblyStateCreateInfo CreateInputAssemblyStateInfo(VkPrimitiveTopology topology);
 
 	void CreateBuffer(const real::GameContext& context, VkDeviceSize size, VkBufferUsageFlags usage,
-		VkMemoryPropertyFlags properties, VkBuffer& buffer, VmaAllocation& bufferAllocation);
+		VkMemoryPropertyFlags properties, VkBuffer& buffer, VmaAllocation& bufferAllocation,
+		EMemoryCategory category = EMemoryCategory::other);
+	// Removes the allocation from the MemoryTracker before it is destroyed
+	void DestroyBuffer(VmaAllocator allocator, VkBuffer buffer, VmaAllocation bufferAllocation);
 
 
 	std::vector<char> ReadFile(const std::string& filename);
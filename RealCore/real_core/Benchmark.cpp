@@ -0,0 +1,60 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+void real::Benchmark::AddFrameTime(float milliseconds)
+{
+	if (m_IsEnabled)
+		m_FrameTimes.push_back(milliseconds);
+}
+
+void real::Benchmark::Count(std::string_view name, uint64_t amount)
+{
+	if (m_IsEnabled == false)
+		return;
+
+	std::lock_guard lock(m_Mutex);
+
+	const auto it = std::ranges::find(m_Counters, name, &std::pair<std::string, uint64_t>::first);
+	if (it != m_Counters.end())
+		it->second += amount;
+	else
+		m_Counters.emplace_back(std::string(name), amount);
+}
+
+void real::Benchmark::PrintReport() const
+{
+	if (m_FrameTimes.empty())
+		return;
+
+	auto sortedTimes = m_FrameTimes;
+	std::ranges::sort(sortedTimes);
+
+	float sum = 0.f;
+	for (const auto frameTime : sortedTimes)
+		sum += frameTime;
+
+	std::cout << "\033[1;90mBenchmark: " << sortedTimes.size() << " frames"
+		<< " | average: " << sum / static_cast<float>(sortedTimes.size()) << " ms"
+		<< " | p50: " << GetPercentile(sortedTimes, 0.50f) << " ms"
+		<< " | p95: " << GetPercentile(sortedTimes, 0.95f) << " ms"
+		<< " | p99: " << GetPercentile(sortedTimes, 0.99f) << " ms"
+		<< " | max: " << sortedTimes.back() << " ms\033[0m\n";
+
+	std::lock_guard lock(m_Mutex);
+	if (m_Counters.empty())
+		return;
+
+	std::cout << "\033[1;90mBenchmark:";
+	for (size_t i = 0; i < m_Counters.size(); ++i)
+		std::cout << (i == 0 ? " " : " | ") << m_Counters[i].first << ": " << m_Counters[i].second;
+	std::cout << "\033[0m\n";
+}
+
+float real::Benchmark::GetPercentile(const std::vector<float>& sortedTimes, float percentile)
+{
+	const auto rank = static_cast<size_t>(std::ceil(percentile * static_cast<float>(sortedTimes.size())));
+	return sortedTimes[std::clamp<size_t>(rank, 1, sortedTimes.size()) - 1];
+}
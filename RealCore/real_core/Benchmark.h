@@ -0,0 +1,53 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "Singleton.h"
+
+namespace real
+{
+	// Collects the frame times and the counters of a fixed run, so two builds can be compared on the same input.
+	// Nothing is collected unless it is enabled.
+	class Benchmark final : public Singleton<Benchmark>
+	{
+	public:
+		virtual ~Benchmark() override = default;
+
+		Benchmark(const Benchmark& other) = delete;
+		Benchmark& operator=(const Benchmark& rhs) = delete;
+		Benchmark(Benchmark&& other) = delete;
+		Benchmark& operator=(Benchmark&& rhs) = delete;
+
+		void SetEnabled(bool isEnabled) { m_IsEnabled = isEnabled; }
+		bool IsEnabled() const { return m_IsEnabled; }
+
+		void AddFrameTime(float milliseconds);
+		// Thread safe, the name is only copied the first time it is counted
+		void Count(std::string_view name, uint64_t amount = 1);
+
+		// The frame time percentiles and every counter
+		void PrintReport() const;
+
+	private:
+		friend class Singleton<Benchmark>;
+		Benchmark() = default;
+
+		bool m_IsEnabled{ false };
+		std::vector<float> m_FrameTimes{};
+
+		mutable std::mutex m_Mutex{};
+		// In the order they were first counted
+		std::vector<std::pair<std::string, uint64_t>> m_Counters{};
+
+		// Nearest rank of the sorted frame times
+		static float GetPercentile(const std::vector<float>& sortedTimes, float percentile);
+	};
+}
+
+#endif // BENCHMARK_H
@@ -0,0 +1,307 @@
+#include "CpuProfiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+
+#include "imgui.h"
+#include "implot.h"
+
+namespace
+{
+	// Registered on the first zone a thread finishes
+	thread_local void* t_pThreadData = nullptr;
+	thread_local uint32_t t_Depth = 0;
+
+	ImU32 GetZoneColor(const char* name)
+	{
+		// FNV-1a over the name, so a zone keeps its color between frames
+		uint32_t hash = 2166136261u;
+		for (const char* c = name; *c != '\0'; ++c)
+			hash = (hash ^ static_cast<uint8_t>(*c)) * 16777619u;
+
+		const float hue = static_cast<float>(hash % 360) / 360.f;
+		float r, g, b;
+		ImGui::ColorConvertHSVtoRGB(hue, 0.5f, 0.8f, r, g, b);
+		return ImGui::GetColorU32(ImVec4(r, g, b, 1.f));
+	}
+}
+
+void real::CpuProfiler::NewFrame()
+{
+	const auto now = GetTime();
+	if (m_IsEnabled == false || m_IsPaused)
+	{
+		// Zones of a paused frame are thrown away
+		std::lock_guard lock(m_Mutex);
+		for (const auto& pThread : m_Threads)
+		{
+			std::lock_guard threadLock(pThread->mutex);
+			pThread->zones.clear();
+		}
+
+		m_FrameStart = now;
+		return;
+	}
+
+	auto& frame = m_Frames[m_FrameIndex];
+	frame.start = m_FrameStart;
+	frame.end = now;
+	frame.zones.clear();
+
+	{
+		std::lock_guard lock(m_Mutex);
+		for (const auto& pThread : m_Threads)
+		{
+			std::lock_guard threadLock(pThread->mutex);
+			frame.zones.insert(frame.zones.end(), pThread->zones.begin(), pThread->zones.end());
+			pThread->zones.clear();
+		}
+	}
+
+	// Parents before their children, which is the order the flame graph and the trace want
+	std::ranges::sort(frame.zones, [](const CpuZone& a, const CpuZone& b)
+		{
+			if (a.thread != b.thread)
+				return a.thread < b.thread;
+			return a.start != b.start ? a.start < b.start : a.depth < b.depth;
+		});
+
+	m_FrameIndex = (m_FrameIndex + 1) % frame_count;
+	m_FrameCount = std::min(m_FrameCount + 1, frame_count);
+	m_FrameStart = now;
+}
+
+void real::CpuProfiler::SetThreadName(const std::string& name)
+{
+	auto& thread = GetThreadData();
+
+	std::lock_guard lock(m_Mutex);
+	thread.name = name;
+}
+
+void real::CpuProfiler::OnGui()
+{
+	if (m_IsEnabled == false)
+		return;
+
+	ImGui::SetNextWindowSize(ImVec2(640, 420), ImGuiCond_FirstUseEver);
+	ImGui::Begin("CPU profiler");
+
+	if (ImGui::Button("Export trace"))
+		ExportChromeTrace("cpu_trace.json");
+	ImGui::SameLine();
+	ImGui::Checkbox("Pause", &m_IsPaused);
+
+	if (m_FrameCount == 0)
+	{
+		ImGui::TextUnformatted("No frames recorded yet");
+		ImGui::End();
+		return;
+	}
+
+	// Age 0 is the last frame that was closed
+	m_SelectedFrame = std::clamp(m_SelectedFrame, 0, static_cast<int>(m_FrameCount) - 1);
+
+	std::array<float, frame_count> frameTimes{};
+	for (uint32_t i = 0; i < m_FrameCount; ++i)
+	{
+		const auto& frame = GetFrame(m_FrameCount - 1 - i);
+		frameTimes[i] = static_cast<float>(frame.end - frame.start) / 1000.f;
+	}
+
+	if (ImPlot::BeginPlot("##CpuFrames", ImVec2(-1, 120)))
+	{
+		ImPlot::SetupAxes("frame", "ms", ImPlotAxisFlags_NoTickLabels, ImPlotAxisFlags_AutoFit);
+		ImPlot::SetupAxisLimits(ImAxis_X1, -1, frame_count, ImGuiCond_Always);
+
+		ImPlot::PlotBars("Frame time", frameTimes.data(), static_cast<int>(m_FrameCount), 0.67);
+
+		// Clicking a bar selects its frame
+		if (ImPlot::IsPlotHovered() && ImGui::IsMouseClicked(ImGuiMouseButton_Left))
+		{
+			const auto index = static_cast<int>(std::round(ImPlot::GetPlotMousePos().x));
+			if (index >= 0 && index < static_cast<int>(m_FrameCount))
+				m_SelectedFrame = static_cast<int>(m_FrameCount) - 1 - index;
+		}
+
+		const double selected = static_cast<double>(m_FrameCount - 1 - m_SelectedFrame);
+		ImPlot::PlotInfLines("##Selected", &selected, 1);
+
+		ImPlot::EndPlot();
+	}
+
+	ImGui::SliderInt("Frames ago", &m_SelectedFrame, 0, static_cast<int>(m_FrameCount) - 1);
+
+	const auto& frame = GetFrame(static_cast<uint32_t>(m_SelectedFrame));
+	ImGui::Text("%.3f ms, %zu zones", static_cast<float>(frame.end - frame.start) / 1000.f, frame.zones.size());
+
+	DrawFlameGraph(frame);
+
+	ImGui::End();
+}
+
+bool real::CpuProfiler::ExportChromeTrace(const std::string& path) const
+{
+	std::ofstream file(path, std::ios::trunc);
+	if (file.is_open() == false)
+		return false;
+
+	file << "{\"traceEvents\":[\n";
+
+	bool isFirst = true;
+	auto separate = [&]()
+		{
+			if (isFirst == false)
+				file << ",\n";
+			isFirst = false;
+		};
+
+	{
+		std::lock_guard lock(m_Mutex);
+		for (const auto& pThread : m_Threads)
+		{
+			separate();
+			file << R"({"name":"thread_name","ph":"M","pid":0,"tid":)" << pThread->index
+				<< R"(,"args":{"name":")" << pThread->name << "\"}}";
+		}
+	}
+
+	// Oldest frame first, names are literals and are not escaped
+	size_t zoneCount = 0;
+	for (uint32_t age = m_FrameCount; age-- > 0;)
+	{
+		for (const auto& zone : GetFrame(age).zones)
+		{
+			separate();
+			file << R"({"name":")" << zone.name << R"(","cat":"cpu","ph":"X","ts":)" << zone.start
+				<< R"(,"dur":)" << zone.end - zone.start << R"(,"pid":0,"tid":)" << zone.thread << '}';
+		}
+
+		zoneCount += GetFrame(age).zones.size();
+	}
+
+	file << "\n]}\n";
+
+	std::cout << "\033[1;90mCPU profiler: " << zoneCount << " zones of " << m_FrameCount << " frames written to " << path << "\033[0m\n";
+	return true;
+}
+
+int64_t real::CpuProfiler::GetTime() const
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_Epoch).count();
+}
+
+void real::CpuProfiler::AddZone(const char* name, int64_t start, int64_t end, uint32_t depth)
+{
+	auto& thread = GetThreadData();
+
+	std::lock_guard lock(thread.mutex);
+	thread.zones.push_back({ name, start, end, thread.index, depth });
+}
+
+real::CpuProfiler::ThreadData& real::CpuProfiler::GetThreadData()
+{
+	if (t_pThreadData == nullptr)
+	{
+		std::lock_guard lock(m_Mutex);
+
+		auto pThread = std::make_unique<ThreadData>();
+		pThread->index = static_cast<uint32_t>(m_Threads.size());
+		pThread->name = "Thread " + std::to_string(pThread->index);
+
+		t_pThreadData = pThread.get();
+		m_Threads.push_back(std::move(pThread));
+	}
+
+	return *static_cast<ThreadData*>(t_pThreadData);
+}
+
+const real::CpuProfiler::Frame& real::CpuProfiler::GetFrame(uint32_t age) const
+{
+	return m_Frames[(m_FrameIndex + frame_count - 1 - age) % frame_count];
+}
+
+void real::CpuProfiler::DrawFlameGraph(const Frame& frame) const
+{
+	constexpr float row_height = 18.f;
+	constexpr float label_width = 90.f;
+
+	ImGui::BeginChild("##FlameGraph", ImVec2(0, 0), true, ImGuiWindowFlags_HorizontalScrollbar);
+
+	auto* pDrawList = ImGui::GetWindowDrawList();
+	const auto origin = ImGui::GetCursorScreenPos();
+	const float width = std::max(ImGui::GetContentRegionAvail().x - label_width, 1.f);
+	const double scale = width / static_cast<double>(std::max<int64_t>(frame.end - frame.start, 1));
+
+	std::lock_guard lock(m_Mutex);
+
+	// One lane per thread, as deep as its deepest zone
+	float laneY = origin.y;
+	for (const auto& pThread : m_Threads)
+	{
+		uint32_t depthCount = 0;
+		for (const auto& zone : frame.zones)
+		{
+			if (zone.thread == pThread->index)
+				depthCount = std::max(depthCount, zone.depth + 1);
+		}
+
+		if (depthCount == 0)
+			continue;
+
+		pDrawList->AddText(ImVec2(origin.x, laneY), ImGui::GetColorU32(ImGuiCol_Text), pThread->name.c_str());
+
+		for (const auto& zone : frame.zones)
+		{
+			if (zone.thread != pThread->index)
+				continue;
+
+			// Zones of other threads can start before the frame did
+			const auto start = std::max(zone.start, frame.start);
+			const float x0 = origin.x + label_width + static_cast<float>(static_cast<double>(start - frame.start) * scale);
+			const float x1 = std::max(origin.x + label_width + static_cast<float>(static_cast<double>(zone.end - frame.start) * scale), x0 + 1.f);
+			const float y0 = laneY + static_cast<float>(zone.depth) * row_height;
+			const ImVec2 min{ x0, y0 };
+			const ImVec2 max{ x1, y0 + row_height - 1.f };
+
+			pDrawList->AddRectFilled(min, max, GetZoneColor(zone.name));
+			if (x1 - x0 > 20.f)
+			{
+				const ImVec4 clip{ x0 + 2.f, y0, x1 - 2.f, y0 + row_height };
+				pDrawList->AddText(nullptr, 0.f, ImVec2(x0 + 2.f, y0 + 1.f), IM_COL32_BLACK, zone.name, nullptr, 0.f, &clip);
+			}
+
+			if (ImGui::IsMouseHoveringRect(min, max))
+				ImGui::SetTooltip("%s\n%.3f ms", zone.name, static_cast<float>(zone.end - zone.start) / 1000.f);
+		}
+
+		laneY += static_cast<float>(depthCount) * row_height + 4.f;
+	}
+
+	ImGui::Dummy(ImVec2(width + label_width, laneY - origin.y));
+	ImGui::EndChild();
+}
+
+real::CpuZoneScope::CpuZoneScope(const char* name)
+	: m_Name(name)
+{
+	if (CpuProfiler::GetInstance().IsEnabled() == false)
+		return;
+
+	m_Depth = t_Depth++;
+	m_Start = CpuProfiler::GetInstance().GetTime();
+}
+
+real::CpuZoneScope::~CpuZoneScope()
+{
+	// The profiler was disabled when the zone was opened
+	if (m_Start < 0)
+		return;
+
+	--t_Depth;
+
+	auto& profiler = CpuProfiler::GetInstance();
+	profiler.AddZone(m_Name, m_Start, profiler.GetTime(), m_Depth);
+}
@@ -0,0 +1,128 @@
+#ifndef CPUPROFILER_H
+#define CPUPROFILER_H
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "Singleton.h"
+
+namespace real
+{
+	// Times are in microseconds since the profiler was created
+	struct CpuZone
+	{
+		const char* name{ nullptr };
+		int64_t start{};
+		int64_t end{};
+		uint32_t thread{};
+		uint32_t depth{};
+	};
+
+	// Collects the zones every thread finished, grouped per frame in a ring of the last frame_count frames.
+	// Zones are only recorded when the profiler is enabled and REAL_PROFILER is defined, see REAL_PROFILE_ZONE.
+	class CpuProfiler final : public Singleton<CpuProfiler>
+	{
+	public:
+		virtual ~CpuProfiler() override = default;
+
+		CpuProfiler(const CpuProfiler& other) = delete;
+		CpuProfiler& operator=(const CpuProfiler& rhs) = delete;
+		CpuProfiler(CpuProfiler&& other) = delete;
+		CpuProfiler& operator=(CpuProfiler&& rhs) = delete;
+
+		void SetEnabled(bool isEnabled) { m_IsEnabled = isEnabled; }
+		bool IsEnabled() const { return m_IsEnabled; }
+
+		// Closes the current frame, the zones that were finished during it are moved into the ring
+		void NewFrame();
+		// Names the lane of the calling thread in the flame graph and the trace
+		void SetThreadName(const std::string& name);
+
+		void OnGui();
+		// Every frame in the ring as complete events of the Chrome trace_event format
+		bool ExportChromeTrace(const std::string& path) const;
+
+		int64_t GetTime() const;
+		// Thread safe, called by CpuZoneScope
+		void AddZone(const char* name, int64_t start, int64_t end, uint32_t depth);
+
+	private:
+		friend class Singleton<CpuProfiler>;
+		CpuProfiler() = default;
+
+		static constexpr uint32_t frame_count = 128;
+
+		// The zones of one thread, only locked against NewFrame
+		struct ThreadData
+		{
+			std::string name{};
+			uint32_t index{};
+			std::mutex mutex{};
+			std::vector<CpuZone> zones{};
+		};
+
+		struct Frame
+		{
+			int64_t start{};
+			int64_t end{};
+			std::vector<CpuZone> zones{};
+		};
+
+		bool m_IsEnabled{ false };
+		const std::chrono::steady_clock::time_point m_Epoch{ std::chrono::steady_clock::now() };
+
+		mutable std::mutex m_Mutex{};
+		std::vector<std::unique_ptr<ThreadData>> m_Threads{};
+
+		std::array<Frame, frame_count> m_Frames{};
+		// The slot the next frame is written to
+		uint32_t m_FrameIndex{ 0 };
+		uint32_t m_FrameCount{ 0 };
+		int64_t m_FrameStart{ 0 };
+
+		bool m_IsPaused{ false };
+		int m_SelectedFrame{ 0 };
+
+		ThreadData& GetThreadData();
+		const Frame& GetFrame(uint32_t age) const;
+		void DrawFlameGraph(const Frame& frame) const;
+	};
+
+	// Measures the scope it lives in
+	class CpuZoneScope final
+	{
+	public:
+		explicit CpuZoneScope(const char* name);
+		~CpuZoneScope();
+
+		CpuZoneScope(const CpuZoneScope& other) = delete;
+		CpuZoneScope& operator=(const CpuZoneScope& rhs) = delete;
+		CpuZoneScope(CpuZoneScope&& other) = delete;
+		CpuZoneScope& operator=(CpuZoneScope&& rhs) = delete;
+
+	private:
+		const char* m_Name;
+		int64_t m_Start{ -1 };
+		uint32_t m_Depth{ 0 };
+	};
+}
+
+// The name has to outlive the profiler, use string literals
+#ifdef REAL_PROFILER
+#define REAL_PROFILE_CONCAT_IMPL(a, b) a##b
+#define REAL_PROFILE_CONCAT(a, b) REAL_PROFILE_CONCAT_IMPL(a, b)
+#define REAL_PROFILE_ZONE(name) const real::CpuZoneScope REAL_PROFILE_CONCAT(profileZone, __LINE__){ name }
+#define REAL_PROFILE_FUNCTION() REAL_PROFILE_ZONE(__func__)
+#define REAL_PROFILE_THREAD(name) real::CpuProfiler::GetInstance().SetThreadName(name)
+#else
+#define REAL_PROFILE_ZONE(name) ((void)0)
+#define REAL_PROFILE_FUNCTION() ((void)0)
+#define REAL_PROFILE_THREAD(name) ((void)0)
+#endif // REAL_PROFILER
+
+#endif // CPUPROFILER_H
@@ -16,6 +16,8 @@ namespace real
 		DrawableComponent(DrawableComponent&& other) = delete;
 		DrawableComponent& operator=(DrawableComponent&& rhs) = delete;
 
+		// Recorded before the render pass begins, for compute work the draws depend on
+		virtual void PreRender() {}
 		virtual void Render() {}
 		virtual void DebugRender() {}
 
@@ -96,7 +96,11 @@ void real::GameObject::Update()
 void real::GameObject::LateUpdate()
 {
 	MoveUniqueData(m_pChildrenToAdd, m_pChildren);
-	MoveUniqueData(m_pComponentsToAdd, m_pComponents);
+	if (m_pComponentsToAdd.empty() == false)
+	{
+		MoveUniqueData(m_pComponentsToAdd, m_pComponents);
+		CacheDrawables();
+	}
 
 	if (m_TimeForDestruction > 0)
 	{
@@ -115,6 +119,7 @@ void real::GameObject::LateUpdate()
 		}
 
 		m_pComponents.clear();
+		m_pDrawables.clear();
 
 		if (m_pParent == nullptr)
 			m_pScene->Remove(this);
@@ -152,52 +157,49 @@ void real::GameObject::LateUpdate()
 	}
 }
 
+void real::GameObject::PreRender() const
+{
+	ForEachDrawable([](DrawableComponent& drawable) { drawable.PreRender(); });
+}
+
 void real::GameObject::Render() const
+{
+	ForEachDrawable([](DrawableComponent& drawable) { drawable.Render(); });
+}
+
+void real::GameObject::DebugRender() const
+{
+	ForEachDrawable([](DrawableComponent& drawable) { drawable.DebugRender(); });
+}
+
+void real::GameObject::ForEachDrawable(const std::function<void(DrawableComponent&)>& render) const
 {
 	if (IsActive() == false)
 		return;
 
-	if (m_pChildren.empty() == false)
-	{
-		std::ranges::for_each(m_pChildren, [](const auto& go)
-			{
-				go->Render();
-			});
-	}
+	std::ranges::for_each(m_pChildren, [&render](const auto& go)
+		{
+			go->ForEachDrawable(render);
+		});
 
-	std::ranges::for_each(m_pComponents, [](const std::unique_ptr<Component>& c)
+	std::ranges::for_each(m_pDrawables, [&render](DrawableComponent* drawable)
 		{
-			if (const auto drawable = dynamic_cast<DrawableComponent*>(c.get());
-				drawable != nullptr)
-			{
-				if (drawable->IsActive())
-					drawable->Render();
-			}
+			if (drawable->IsActive())
+				render(*drawable);
 		});
 }
 
-void real::GameObject::DebugRender() const
+void real::GameObject::CacheDrawables()
 {
-	if (IsActive() == false)
-		return;
-
-	if (m_pChildren.empty() == false)
+	m_pDrawables.clear();
+	for (const auto& c : m_pComponents)
 	{
-		std::ranges::for_each(m_pChildren, [](const auto& go)
-			{
-				go->DebugRender();
-			});
-	}
-
-	std::ranges::for_each(m_pComponents, [](const std::unique_ptr<Component>& c)
+		if (const auto drawable = dynamic_cast<DrawableComponent*>(c.get());
+			drawable != nullptr)
 		{
-			if (const auto drawable = dynamic_cast<DrawableComponent*>(c.get());
-				drawable != nullptr)
-			{
-				if (drawable->IsActive())
-					drawable->DebugRender();
-			}
-		});
+			m_pDrawables.push_back(drawable);
+		}
+	}
 }
 
 void real::GameObject::OnGui()
@@ -6,11 +6,13 @@
 #include <memory>
 #include <string>
 #include <algorithm>
+#include <functional>
 
 #include "Transform.h"
 
 namespace real
 {
+	class DrawableComponent;
 	class Scene;
 	class Texture2D;
 
@@ -40,6 +42,7 @@ namespace real
 		void FixedUpdate();
 		void Update();
 		void LateUpdate();
+		void PreRender() const;
 		void Render() const;
 		void DebugRender() const;
 		void OnGui();
@@ -122,6 +125,8 @@ namespace real
 		std::unique_ptr<Transform> m_pTransform{ nullptr };
 		std::vector<std::unique_ptr<Component>> m_pComponents{};
 		std::vector<std::unique_ptr<Component>> m_pComponentsToAdd{};
+		// Rebuilt whenever the components change, so rendering does not have to cast every component each frame
+		std::vector<DrawableComponent*> m_pDrawables{};
 
 		GameObject* m_pParent{ nullptr };
 		std::vector<std::unique_ptr<GameObject>> m_pChildren{};
@@ -134,6 +139,10 @@ namespace real
 		T* GetComponentHelper(const std::vector<std::unique_ptr<Component>>& v);
 #pragma endregion Component Logic
 
+		void CacheDrawables();
+		// Children first, then the active drawables of this object
+		void ForEachDrawable(const std::function<void(DrawableComponent&)>& render) const;
+
 		static std::vector<GameObject*> GetGameObjectsWithTagHelper(const std::vector<std::unique_ptr<GameObject>>& objects, const std::string& tag);
 
 		template <typename T>
@@ -235,6 +244,7 @@ namespace real
 		if (it != m_pComponents.end())
 		{
 			std::erase(m_pComponents, it);
+			CacheDrawables();
 			return true;
 		}
 
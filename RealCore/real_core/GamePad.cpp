@@ -29,12 +29,20 @@ public:
 		ZeroMemory(&m_CurrentState, sizeof XINPUT_STATE);
 		XInputGetState(m_ControllerIndex, &m_CurrentState);
 
-		const auto buttonChanges = m_CurrentState.Gamepad.wButtons ^ m_PreviousState.Gamepad.wButtons;
-		m_ButtonsPressedThisFrame = buttonChanges & m_CurrentState.Gamepad.wButtons;
-		m_ButtonsReleasedThisFrame = buttonChanges & (~m_CurrentState.Gamepad.wButtons);
+		UpdateButtonChanges();
+	}
+
+	void Update(WORD buttons)
+	{
+		CopyMemory(&m_PreviousState, &m_CurrentState, sizeof XINPUT_STATE);
+		ZeroMemory(&m_CurrentState, sizeof XINPUT_STATE);
+		m_CurrentState.Gamepad.wButtons = buttons;
+
+		UpdateButtonChanges();
 	}
 
 	uint8_t GetIndex() const { return m_ControllerIndex; }
+	WORD GetButtons() const { return m_CurrentState.Gamepad.wButtons; }
 
 	bool IsDown(unsigned int button) const { return m_ButtonsPressedThisFrame & button; }
 	bool IsUp(unsigned int button) const { return m_ButtonsReleasedThisFrame & button; }
@@ -48,6 +56,13 @@ private:
 	WORD m_ButtonsReleasedThisFrame{};
 
 	uint8_t m_ControllerIndex{};
+
+	void UpdateButtonChanges()
+	{
+		const auto buttonChanges = m_CurrentState.Gamepad.wButtons ^ m_PreviousState.Gamepad.wButtons;
+		m_ButtonsPressedThisFrame = buttonChanges & m_CurrentState.Gamepad.wButtons;
+		m_ButtonsReleasedThisFrame = buttonChanges & (~m_CurrentState.Gamepad.wButtons);
+	}
 };
 
 real::GamePad::GamePad(uint8_t controllerIndex)
@@ -66,11 +81,21 @@ void real::GamePad::Update()
 	m_pImpl->Update();
 }
 
+void real::GamePad::Update(uint16_t buttons)
+{
+	m_pImpl->Update(buttons);
+}
+
 uint8_t real::GamePad::GetIndex() const
 {
 	return m_pImpl->GetIndex();
 }
 
+uint16_t real::GamePad::GetButtons() const
+{
+	return m_pImpl->GetButtons();
+}
+
 bool real::GamePad::IsDown(Button button) const
 {
 	return m_pImpl->IsDown(static_cast<unsigned>(button));
@@ -35,8 +35,11 @@ namespace real
 		GamePad& operator=(GamePad&& rhs) = delete;
 
 		void Update();
+		// Replaces the state XInput would report, used to replay a recording
+		void Update(uint16_t buttons);
 
 		uint8_t GetIndex() const;
+		uint16_t GetButtons() const;
 
 		bool IsDown(Button button) const;
 		bool IsUp(Button button) const;
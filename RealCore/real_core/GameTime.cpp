@@ -2,20 +2,21 @@
 
 void real::GameTime::Init()
 {
-	m_PrevTime = std::chrono::high_resolution_clock::now();
+	m_PrevTime = std::chrono::steady_clock::now();
 }
 
 void real::GameTime::Update()
 {
-	const auto currentTime = std::chrono::high_resolution_clock::now();
+	const auto currentTime = std::chrono::steady_clock::now();
 
-	m_DeltaTime = std::chrono::duration<float>(currentTime - m_PrevTime).count();
+	m_FrameTime = std::chrono::duration<float>(currentTime - m_PrevTime).count();
+	m_DeltaTime = m_FixedDeltaTime > 0.f ? m_FixedDeltaTime : m_FrameTime;
 	m_TotalTime += m_DeltaTime;
 
 	m_PrevTime = currentTime;
 
 	//FPS LOGIC
-	m_FPSTimer += m_DeltaTime;
+	m_FPSTimer += m_FrameTime;
 	++m_FPSCount;
 	if (m_FPSTimer >= 1.0f)
 	{
@@ -38,7 +39,7 @@ float real::GameTime::GetTotal() const
 
 uint32_t real::GameTime::StartTimer()
 {
-	const auto id = m_Timers.size();
-	m_Timers.push_back(std::chrono::high_resolution_clock::now());
-	return static_cast<uint32_t>(id);
+	const auto id = m_NextTimerId++;
+	m_Timers.emplace(id, std::chrono::steady_clock::now());
+	return id;
 }
\ No newline at end of file
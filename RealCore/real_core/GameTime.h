@@ -4,6 +4,7 @@
 #include "Singleton.h"
 
 #include <chrono>
+#include <unordered_map>
 
 namespace real
 {
@@ -22,7 +23,12 @@ namespace real
 		virtual void Update() override;
 
 		float GetElapsed() const;
+		// The measured time of the last frame, also when the delta time is fixed
+		float GetFrameTime() const { return m_FrameTime; }
 		float GetTotal() const;
+
+		// Every update advances the game by this delta time instead of the measured one, 0 measures it again
+		void SetFixedDeltaTime(float deltaTime) { m_FixedDeltaTime = deltaTime; }
 		uint32_t GetFPS_Unsigned() const { return m_FPS; };
 		float GetFPS_Float() const { return m_fFPS; }
 
@@ -36,6 +42,8 @@ namespace real
 	private:
 		std::chrono::steady_clock::time_point m_PrevTime{};
 		float m_DeltaTime{};
+		float m_FrameTime{};
+		float m_FixedDeltaTime{ 0.f };
 		float m_TotalTime{};
 
 		uint32_t m_FPS = 0;
@@ -43,7 +51,9 @@ namespace real
 		uint32_t m_FPSCount = 0;
 		float m_FPSTimer = 0.0f;
 
-		std::vector<std::chrono::steady_clock::time_point> m_Timers{};
+		// Keyed by id, so ending a timer does not shift the ids of the others
+		std::unordered_map<uint32_t, std::chrono::steady_clock::time_point> m_Timers{};
+		uint32_t m_NextTimerId{ 0 };
 
 	};
 }
@@ -51,8 +61,8 @@ namespace real
 template <typename DurationType>
 float real::GameTime::GetTime(uint32_t id)
 {
-	const auto endTime = std::chrono::high_resolution_clock::now();
-	const auto duration = endTime - m_Timers[id];
+	const auto endTime = std::chrono::steady_clock::now();
+	const auto duration = endTime - m_Timers.at(id);
 
 	const float time = static_cast<float>(std::chrono::duration_cast<DurationType>(duration).count());
 	return time;
@@ -63,7 +73,7 @@ float real::GameTime::EndTimer(uint32_t id)
 {
 	const auto time = GetTime<DurationType>(id);
 
-	m_Timers.erase(m_Timers.begin() + id);
+	m_Timers.erase(id);
 
 	return static_cast<float>(time);
 }
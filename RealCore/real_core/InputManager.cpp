@@ -25,7 +25,9 @@ bool real::InputManager::ProcessInput()
 
 	while (SDL_PollEvent(&e))
 	{
-		ImGui_ImplSDL2_ProcessEvent(&e);
+		// Headless there is no overlay to feed
+		if (ImGui::GetCurrentContext() != nullptr)
+			ImGui_ImplSDL2_ProcessEvent(&e);
 		if (e.type == SDL_QUIT) 
 		{
 			return false;
@@ -35,13 +37,16 @@ bool real::InputManager::ProcessInput()
 	if (m_pActiveInputMap == nullptr)
 		return true;
 
-	if (m_GamePadEnabled && m_pGamePads.empty() == false)
+	if (m_IsReplaying && m_Recording.Read(m_ReplayFrame) == false)
 	{
-		std::ranges::for_each(m_pGamePads, [](const auto& gp)
-			{
-				gp->Update();
-			});
+		m_IsReplaying = false;
+		m_Recording.Close();
+		return false;
+	}
 
+	if (m_GamePadEnabled && m_pGamePads.empty() == false)
+	{
+		UpdateGamePadStates();
 		ProcessGamePadInput();
 	}
 
@@ -55,6 +60,9 @@ bool real::InputManager::ProcessInput()
 		ProcessKeyboardInput();
 	}
 
+	if (m_IsRecording)
+		RecordFrame();
+
 	return true;
 }
 
@@ -152,10 +160,41 @@ void real::InputManager::RemoveGameObjectCommands(const GameObject* pGo)
 	}
 }
 
+void real::InputManager::StartRecording(const std::string& path, float deltaTime)
+{
+	m_Recording.OpenWrite(path, deltaTime);
+	m_IsRecording = true;
+	m_IsReplaying = false;
+}
+
+void real::InputManager::StopRecording()
+{
+	if (m_IsRecording == false)
+		return;
+
+	Logger::LogInfo({ "Recorded {} frames of input" }, m_Recording.GetFrameCount());
+
+	m_Recording.Close();
+	m_IsRecording = false;
+}
+
+void real::InputManager::StartReplay(const std::string& path)
+{
+	m_Recording.OpenRead(path);
+	m_IsReplaying = true;
+	m_IsRecording = false;
+}
+
 void real::InputManager::UpdateKeyboardStates()
 {
 	// TODO: Faster than SDL_PollEvent??
 	std::ranges::copy(m_pCurrentKeyboardState, m_pOldKeyboardState.begin());
+	if (m_IsReplaying)
+	{
+		std::ranges::copy(m_ReplayFrame.keyboard, m_pCurrentKeyboardState.begin());
+		return;
+	}
+
 	const Uint8* currentState = SDL_GetKeyboardState(nullptr);
 	std::copy(currentState, currentState + SDL_NUM_SCANCODES, m_pCurrentKeyboardState.begin());
 }
@@ -165,23 +204,32 @@ void real::InputManager::UpdateMouseStates()
 	m_OldMouseState = m_CurrentMouseState;
 	m_OldMousePosition = m_CurrentMousePosition;
 
-	// SDL_GetMouseState gets the current mouse position and button states
-	int mouseX, mouseY;
-	m_CurrentMouseState = SDL_GetMouseState(&mouseX, &mouseY);
+	if (m_IsReplaying)
+	{
+		// Recorded after the window check
+		m_CurrentMouseState = m_ReplayFrame.mouseState;
+		m_CurrentMousePosition = m_ReplayFrame.mousePosition;
+	}
+	else
+	{
+		// SDL_GetMouseState gets the current mouse position and button states
+		int mouseX, mouseY;
+		m_CurrentMouseState = SDL_GetMouseState(&mouseX, &mouseY);
 
-	m_CurrentMousePosition.x = mouseX;
-	m_CurrentMousePosition.y = mouseY;
+		m_CurrentMousePosition.x = mouseX;
+		m_CurrentMousePosition.y = mouseY;
 
-	// Check if mouse pos is in window
-	SDL_Point clientPos;
-	clientPos.x = mouseX;
-	clientPos.y = mouseY;
+		// Check if mouse pos is in window
+		SDL_Point clientPos;
+		clientPos.x = mouseX;
+		clientPos.y = mouseY;
 
-	const auto rect = SDL_GetWindowMouseRect(EngineBase::GetWindow());
-	if (rect != nullptr && SDL_PointInRect(&clientPos, rect) == SDL_FALSE)
-	{
-		m_CurrentMousePosition = m_OldMousePosition;
-		m_CurrentMouseState = m_OldMouseState;
+		const auto rect = SDL_GetWindowMouseRect(EngineBase::GetWindow());
+		if (rect != nullptr && SDL_PointInRect(&clientPos, rect) == SDL_FALSE)
+		{
+			m_CurrentMousePosition = m_OldMousePosition;
+			m_CurrentMouseState = m_OldMouseState;
+		}
 	}
 
 	m_MouseMovement.x = m_CurrentMousePosition.x - m_OldMousePosition.x;
@@ -193,6 +241,42 @@ void real::InputManager::UpdateMouseStates()
 		m_NormalizedMouseMovement = glm::normalize(glm::vec2(m_MouseMovement));
 }
 
+void real::InputManager::UpdateGamePadStates() const
+{
+	for (const auto& gp : m_pGamePads)
+	{
+		if (m_IsReplaying == false)
+		{
+			gp->Update();
+			continue;
+		}
+
+		// A game pad that was not connected while recording has no buttons down
+		const auto it = std::ranges::find_if(m_ReplayFrame.gamePads, [&gp](const auto& recorded)
+			{
+				return recorded.first == gp->GetIndex();
+			});
+
+		gp->Update(it != m_ReplayFrame.gamePads.end() ? it->second : uint16_t{ 0 });
+	}
+}
+
+void real::InputManager::RecordFrame()
+{
+	InputFrame frame{};
+	std::ranges::copy(m_pCurrentKeyboardState, frame.keyboard.begin());
+	frame.mouseState = m_CurrentMouseState;
+	frame.mousePosition = m_CurrentMousePosition;
+
+	if (m_GamePadEnabled)
+	{
+		for (const auto& gp : m_pGamePads)
+			frame.gamePads.emplace_back(gp->GetIndex(), gp->GetButtons());
+	}
+
+	m_Recording.Write(frame);
+}
+
 bool real::InputManager::IsKeyboardKeyDown(int key, bool previousFrame) const
 {
 	if (previousFrame)
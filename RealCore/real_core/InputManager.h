@@ -9,6 +9,7 @@
 #include <glm/vec2.hpp>
 
 #include "InputMap.h"
+#include "InputRecording.h"
 #include "Singleton.h"
 
 namespace real
@@ -45,6 +46,15 @@ namespace real
 
 		void RemoveGameObjectCommands(const GameObject* pGo);
 
+		// Every processed frame is written to the file, the delta time is stored so the replay can use the same one
+		void StartRecording(const std::string& path, float deltaTime);
+		void StopRecording();
+		// The input is read from the recording instead of SDL and XInput, ProcessInput returns false once it ran out
+		void StartReplay(const std::string& path);
+		bool IsRecording() const { return m_IsRecording; }
+		bool IsReplaying() const { return m_IsReplaying; }
+		float GetRecordingDeltaTime() const { return m_Recording.GetDeltaTime(); }
+
 	private:
 		friend class Singleton<InputManager>;
 		InputManager();
@@ -62,6 +72,10 @@ namespace real
 		glm::ivec2 m_CurrentMousePosition{ 0,0 }, m_OldMousePosition{ 0,0 }, m_MouseMovement{ 0,0 };
 		glm::vec2 m_NormalizedMouseMovement{ 0,0 };
 
+		InputRecording m_Recording{};
+		bool m_IsRecording{ false }, m_IsReplaying{ false };
+		InputFrame m_ReplayFrame{};
+
 		std::vector<uint8_t>RegisterGamePadsHelper(bool one);
 
 		void ProcessKeyboardInput();
@@ -70,6 +84,8 @@ namespace real
 
 		void UpdateKeyboardStates();
 		void UpdateMouseStates();
+		void UpdateGamePadStates() const;
+		void RecordFrame();
 
 		bool IsKeyboardKeyDown(int key, bool previousFrame = false) const;
 		bool IsMouseButtonDown(MouseButton button, bool previousFrame = false) const;
@@ -0,0 +1,134 @@
+#include "InputRecording.h"
+
+#include <stdexcept>
+
+real::InputRecording::~InputRecording()
+{
+	Close();
+}
+
+void real::InputRecording::OpenWrite(const std::string& path, float deltaTime)
+{
+	Close();
+
+	m_File.open(path, std::ios::out | std::ios::binary | std::ios::trunc);
+	if (m_File.is_open() == false)
+	{
+		throw std::runtime_error("failed to open input recording " + path + "!");
+	}
+
+	m_IsWriting = true;
+	m_DeltaTime = deltaTime;
+	m_FrameCount = 0;
+	m_Keyboard.fill(0);
+
+	// The frame count is filled in when the recording is closed
+	m_File.write(magic.data(), magic.size());
+	WriteValue(version);
+	WriteValue(m_DeltaTime);
+	WriteValue(m_FrameCount);
+}
+
+void real::InputRecording::OpenRead(const std::string& path)
+{
+	Close();
+
+	m_File.open(path, std::ios::in | std::ios::binary);
+	if (m_File.is_open() == false)
+	{
+		throw std::runtime_error("failed to open input recording " + path + "!");
+	}
+
+	std::array<char, 4> fileMagic{};
+	m_File.read(fileMagic.data(), fileMagic.size());
+	if (fileMagic != magic || ReadValue<uint32_t>() != version)
+	{
+		m_File.close();
+		throw std::runtime_error("failed to read input recording " + path + ", the format is not supported!");
+	}
+
+	m_IsWriting = false;
+	m_DeltaTime = ReadValue<float>();
+	m_FrameCount = ReadValue<uint32_t>();
+	m_FrameIndex = 0;
+	m_Keyboard.fill(0);
+}
+
+void real::InputRecording::Close()
+{
+	if (m_File.is_open() == false)
+		return;
+
+	if (m_IsWriting)
+	{
+		m_File.seekp(magic.size() + sizeof(version) + sizeof(m_DeltaTime));
+		WriteValue(m_FrameCount);
+	}
+
+	m_File.close();
+}
+
+void real::InputRecording::Write(const InputFrame& frame)
+{
+	std::vector<uint16_t> changedKeys;
+	for (uint16_t key = 0; key < SDL_NUM_SCANCODES; ++key)
+	{
+		if (frame.keyboard[key] != m_Keyboard[key])
+			changedKeys.push_back(key);
+	}
+
+	WriteValue(static_cast<uint16_t>(changedKeys.size()));
+	for (const auto key : changedKeys)
+	{
+		WriteValue(key);
+		WriteValue(frame.keyboard[key]);
+	}
+	m_Keyboard = frame.keyboard;
+
+	WriteValue(frame.mouseState);
+	WriteValue(frame.mousePosition.x);
+	WriteValue(frame.mousePosition.y);
+
+	WriteValue(static_cast<uint8_t>(frame.gamePads.size()));
+	for (const auto& [index, buttons] : frame.gamePads)
+	{
+		WriteValue(index);
+		WriteValue(buttons);
+	}
+
+	++m_FrameCount;
+}
+
+bool real::InputRecording::Read(InputFrame& frame)
+{
+	if (m_FrameIndex >= m_FrameCount)
+		return false;
+
+	const auto changedKeyCount = ReadValue<uint16_t>();
+	for (uint16_t i = 0; i < changedKeyCount; ++i)
+	{
+		const auto key = ReadValue<uint16_t>();
+		const auto state = ReadValue<uint8_t>();
+		if (key < SDL_NUM_SCANCODES)
+			m_Keyboard[key] = state;
+	}
+	frame.keyboard = m_Keyboard;
+
+	frame.mouseState = ReadValue<uint32_t>();
+	frame.mousePosition.x = ReadValue<int>();
+	frame.mousePosition.y = ReadValue<int>();
+
+	frame.gamePads.resize(ReadValue<uint8_t>());
+	for (auto& [index, buttons] : frame.gamePads)
+	{
+		index = ReadValue<uint8_t>();
+		buttons = ReadValue<uint16_t>();
+	}
+
+	// A truncated file ends the replay early
+	if (m_File.fail())
+		return false;
+
+	++m_FrameIndex;
+	return true;
+}
@@ -0,0 +1,85 @@
+#ifndef INPUTRECORDING_H
+#define INPUTRECORDING_H
+
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <SDL_scancode.h>
+#include <glm/vec2.hpp>
+
+namespace real
+{
+	// The input state the InputManager reads in one frame
+	struct InputFrame
+	{
+		std::array<uint8_t, SDL_NUM_SCANCODES> keyboard{};
+		uint32_t mouseState{};
+		glm::ivec2 mousePosition{ 0,0 };
+		// Index and buttons of every registered game pad
+		std::vector<std::pair<uint8_t, uint16_t>> gamePads{};
+	};
+
+	// Streams frames of input to or from a binary file.
+	// Only the keys that changed since the previous frame are written, the header holds the delta time the frames were recorded with.
+	class InputRecording final
+	{
+	public:
+		explicit InputRecording() = default;
+		~InputRecording();
+
+		InputRecording(const InputRecording& other) = delete;
+		InputRecording& operator=(const InputRecording& rhs) = delete;
+		InputRecording(InputRecording&& other) = delete;
+		InputRecording& operator=(InputRecording&& rhs) = delete;
+
+		void OpenWrite(const std::string& path, float deltaTime);
+		void OpenRead(const std::string& path);
+		void Close();
+
+		void Write(const InputFrame& frame);
+		// False once every frame has been read
+		bool Read(InputFrame& frame);
+
+		bool IsOpen() const { return m_File.is_open(); }
+		float GetDeltaTime() const { return m_DeltaTime; }
+		uint32_t GetFrameCount() const { return m_FrameCount; }
+
+	private:
+		static constexpr std::array<char, 4> magic{ 'R', 'I', 'N', 'P' };
+		static constexpr uint32_t version = 1;
+
+		std::fstream m_File{};
+		bool m_IsWriting{ false };
+		float m_DeltaTime{ 0.f };
+		uint32_t m_FrameCount{ 0 };
+		uint32_t m_FrameIndex{ 0 };
+
+		// The keyboard of the previous frame, the keys are stored relative to it
+		std::array<uint8_t, SDL_NUM_SCANCODES> m_Keyboard{};
+
+		template <typename T>
+		void WriteValue(const T& value);
+		template <typename T>
+		T ReadValue();
+	};
+}
+
+template <typename T>
+void real::InputRecording::WriteValue(const T& value)
+{
+	m_File.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+T real::InputRecording::ReadValue()
+{
+	T value{};
+	m_File.read(reinterpret_cast<char*>(&value), sizeof(T));
+	return value;
+}
+
+#endif // INPUTRECORDING_H
@@ -158,6 +158,14 @@ void Scene::Update()
 	}
 }
 
+void Scene::PreRender() const
+{
+	std::ranges::for_each(m_GameObjects, [](const auto& go)
+		{
+			go->PreRender();
+		});
+}
+
 void Scene::Render() const
 {
 	std::ranges::for_each(m_GameObjects, [](const auto& go)
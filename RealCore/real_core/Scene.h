@@ -22,6 +22,7 @@ namespace real
 
 		void FixedUpdate();
 		void Update();
+		void PreRender() const;
 		void Render() const;
 		void OnGui();
 
@@ -1,5 +1,6 @@
 #include "SceneManager.h"
 
+#include "CpuProfiler.h"
 #include "GameTime.h"
 #include "InputManager.h"
 #include "Scene.h"
@@ -56,6 +57,8 @@ void real::SceneManager::FixedUpdate()
 
 void real::SceneManager::Update()
 {
+	REAL_PROFILE_ZONE("SceneManager::Update");
+
 	if (m_pSceneToLoad != nullptr)
 	{
 		m_LoadTimer -= GameTime::GetInstance().GetElapsed();
@@ -68,6 +71,13 @@ void real::SceneManager::Update()
 	m_pActiveScene->Update();
 }
 
+void real::SceneManager::PreRender() const
+{
+	REAL_PROFILE_ZONE("SceneManager::PreRender");
+
+	m_pActiveScene->PreRender();
+}
+
 void real::SceneManager::Render() const
 {
 	m_pActiveScene->Render();
@@ -32,6 +32,7 @@ namespace real
 
 		void FixedUpdate();
 		void Update();
+		void PreRender() const;
 		void Render() const;
 		void OnGui();
 
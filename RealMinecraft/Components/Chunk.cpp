@@ -1,8 +1,10 @@
 #include "Chunk.h"
 
 #include <random>
+#include <ranges>
+#include <real_core/Benchmark.h>
 #include <real_core/GameObject.h>
-#include <real_core/GameTime.h>
+#include <real_core/CpuProfiler.h>
 #include <real_core/Utils.h>
 
 #include <Material/MaterialManager.h>
@@ -24,7 +26,8 @@ Chunk::Chunk(real::GameObject* pOwner, const std::vector<std::pair<glm::ivec3, E
 {
 	m_pWorldComponent = GetOwner()->GetParent()->GetComponent<World>();
 
-	//const auto id = real::GameTime::GetInstance().StartTimer();
+	REAL_PROFILE_ZONE("Generate chunk");
+	real::Benchmark::GetInstance().Count("Chunks generated");
 
 	const auto worldPos = GetOwner()->GetTransform()->GetWorldPosition();
 	const auto chunkPos = glm::ivec2(worldPos.x, worldPos.z);
@@ -129,13 +132,7 @@ Chunk::Chunk(real::GameObject* pOwner, const std::vector<std::pair<glm::ivec3, E
 		}
 	}
 
-	real::AABB aabb;
-	aabb.min = worldPos;
-	aabb.max = worldPos + glm::vec3{ CHUNK_SIZE, m_HighestY, CHUNK_SIZE };
-	m_Aabb = aabb;
-
-	//const auto time = real::GameTime::GetInstance().EndTimer<std::chrono::microseconds>(id);
-	//std::cout << "Time to initialize chunk : " << time << " microseconds\n";
+	UpdateAabb();
 }
 
 void Chunk::Start()
@@ -144,31 +141,25 @@ void Chunk::Start()
 
 	InitSolidChunk(context);
 	InitTransparentChunk();
+
+	// Meshing drops the blocks without faces
+	UpdateAabb();
 }
 
 void Chunk::Update()
 {
 	const auto activeCamera = real::CameraManager::GetInstance().GetActiveCamera();
-	const auto worldPos= GetOwner()->GetTransform()->GetWorldPosition();
 
-	if (real::FrustumAABB::IsBoxInFrustum(activeCamera->GetViewProjection(), m_Aabb) == false)
-	{
+	// The solid mesh is culled on the gpu by the ChunkRenderer
+	if (m_IsInFrustum == false)
 		m_pTransparentMeshComponent->Disable();
-		m_pSolidMeshComponent->Disable();
-	}
 	else
-	{
 		m_pTransparentMeshComponent->Enable();
-		m_pSolidMeshComponent->Enable();
-	}
 
 	if (m_IsDirty == false)
 		return;
 
-	real::AABB aabb;
-	aabb.min = worldPos;
-	aabb.max = worldPos + glm::vec3{ CHUNK_SIZE, m_HighestY, CHUNK_SIZE };
-	m_Aabb = aabb;
+	REAL_PROFILE_ZONE("Remesh chunk");
 
 	auto [vertices, indices] = CalculateMeshData();
 	m_pSolidMeshComponent->SetIndices(indices);
@@ -178,6 +169,8 @@ void Chunk::Update()
 	m_pTransparentMeshComponent->SetFaces(faces);
 	m_pTransparentMeshComponent->SortFaces(activeCamera->GetOwner()->GetTransform()->GetWorldPosition(), m_ChunkIsCenter);
 
+	UpdateAabb();
+
 	//ChunkParser::GetInstance().SaveChunk(glm::ivec2(worldPos.x, worldPos.z), m_Blocks);
 
 	m_IsDirty = false;
@@ -330,10 +323,13 @@ void Chunk::SetBlock(const glm::ivec3& pos, EBlock block)
 
 std::pair<std::vector<real::PosTexNorm>, std::vector<uint32_t>> Chunk::CalculateMeshData()
 {
+	REAL_PROFILE_ZONE("Mesh chunk");
+	real::Benchmark::GetInstance().Count("Chunks meshed");
+
 	auto& blockParser = BlockParser::GetInstance();
 
 	std::vector<real::PosTexNorm> vertices;
-	std::vector<uint32_t> indices;
+	std::array<std::vector<uint32_t>, SECTION_COUNT> sectionIndices;
 
 	constexpr glm::vec3 dirs[6] = { {0,0,-1},{1,0,0},{0,0,1},{-1,0,0},{0,1,0},{0,-1,0} };
 
@@ -351,6 +347,8 @@ std::pair<std::vector<real::PosTexNorm>, std::vector<uint32_t>> Chunk::Calculate
 		if (blockParser.IsTransparent(block))
 			continue;
 
+		auto& indices = sectionIndices[static_cast<int>(pos.y) / SECTION_SIZE];
+
 		if (data.first)
 		{
 			data.second.clear();
@@ -396,11 +394,23 @@ std::pair<std::vector<real::PosTexNorm>, std::vector<uint32_t>> Chunk::Calculate
 
 	std::ranges::for_each(blocksToRemove, [this](const glm::vec3& pos) { m_RenderedBlocks.erase(pos); });
 
+	std::vector<uint32_t> indices;
+	for (int section = 0; section < SECTION_COUNT; ++section)
+	{
+		m_Sections[section].firstIndex = static_cast<uint32_t>(indices.size());
+		m_Sections[section].indexCount = static_cast<uint32_t>(sectionIndices[section].size());
+		indices.insert(indices.end(), sectionIndices[section].begin(), sectionIndices[section].end());
+	}
+
+	CalculateSectionVisibility();
+
 	return { vertices, indices };
 }
 
 std::vector<TransparentFace> Chunk::CalculateTransparentMeshData()
 {
+	REAL_PROFILE_ZONE("Mesh transparent chunk");
+
 	auto& blockParser = BlockParser::GetInstance();
 
 	std::vector<TransparentFace> faces;
@@ -532,20 +542,84 @@ bool Chunk::CanRenderFace(EBlock currentBlock, int x, int z, int y) const
 		|| blockParser.IsTransparent(currentBlock) && blockParser.IsTransparent(otherBlock) && (otherBlock != currentBlock || otherBlock == EBlock::oakLeaves && currentBlock ==EBlock::oakLeaves);
 }
 
+void Chunk::CalculateSectionVisibility()
+{
+	REAL_PROFILE_ZONE("Section visibility");
+
+	auto& blockParser = BlockParser::GetInstance();
+
+	for (int section = 0; section < SECTION_COUNT; ++section)
+	{
+		const int firstY = section * SECTION_SIZE;
+
+		// Above the terrain there is only air
+		if (firstY > m_HighestY)
+		{
+			m_Sections[section].visibility.ConnectAll();
+			continue;
+		}
+
+		SectionVisibility::opaque_blocks opaqueBlocks;
+		for (int x = 0; x < SECTION_SIZE; ++x)
+		{
+			for (int z = 0; z < SECTION_SIZE; ++z)
+			{
+				for (int y = 0; y < SECTION_SIZE; ++y)
+				{
+					const auto block = m_Blocks[x][z][firstY + y];
+					if (block != EBlock::air && blockParser.IsTransparent(block) == false)
+						opaqueBlocks[SectionVisibility::GetBlockIndex(x, y, z)] = true;
+				}
+			}
+		}
+
+		m_Sections[section].visibility.Calculate(opaqueBlocks);
+	}
+}
+
+void Chunk::UpdateAabb()
+{
+	const auto worldPos = GetOwner()->GetTransform()->GetWorldPosition();
+
+	// Only the blocks with a face are in the meshes, whatever is below them is never drawn
+	int lowestY = CHUNK_HEIGHT, highestY = -1;
+	for (const auto& pos : m_RenderedBlocks | std::views::keys)
+	{
+		lowestY = std::min(lowestY, static_cast<int>(pos.y));
+		highestY = std::max(highestY, static_cast<int>(pos.y));
+	}
+
+	if (highestY < lowestY)
+		lowestY = highestY = 0;
+	else
+		++highestY;
+
+	m_Aabb.min = worldPos + glm::vec3{ 0, lowestY, 0 };
+	m_Aabb.max = worldPos + glm::vec3{ CHUNK_SIZE, highestY, CHUNK_SIZE };
+}
+
+real::AABB Chunk::GetSectionAabb(int section) const
+{
+	const auto worldPos = GetOwner()->GetTransform()->GetWorldPosition();
+
+	real::AABB aabb;
+	aabb.min = worldPos + glm::vec3{ 0, section * SECTION_SIZE, 0 };
+	aabb.max = aabb.min + glm::vec3{ CHUNK_SIZE, SECTION_SIZE, CHUNK_SIZE };
+	return aabb;
+}
+
 void Chunk::InitSolidChunk(const real::GameContext& context)
 {
-	const auto id = real::GameTime::GetInstance().StartTimer();
 	auto [vertices, indices] = CalculateMeshData();
-	auto time = real::GameTime::GetInstance().EndTimer(id);
 
 	real::MeshInfo info;
 	info.vertexCapacity = static_cast<uint32_t>(vertices.size());
 	info.indexCapacity = static_cast<uint32_t>(indices.size());
 	info.usesUbo = true;
-	info.texture = real::ContentManager::GetInstance().LoadTexture(context, "Resources/textures/atlas.png");
+	info.drawIndirect = true;
 
 	auto& go = GetOwner()->CreateGameObject();
-	m_pSolidMeshComponent = go.AddComponent<real::MeshIndexed<real::PosTexNorm, real::UniformBufferObject>>(info);
+	m_pSolidMeshComponent = go.AddComponent<real::MeshIndexed<real::PosTexNorm, real::ObjectConstants>>(info);
 	const auto pMat = real::MaterialManager::GetInstance().GetMaterial<DiffuseMaterial>();
 	m_pSolidMeshComponent->SetMaterial(pMat);
 
@@ -556,9 +630,7 @@ void Chunk::InitSolidChunk(const real::GameContext& context)
 
 void Chunk::InitTransparentChunk()
 {
-	const auto id = real::GameTime::GetInstance().StartTimer();
 	const auto faces = CalculateTransparentMeshData();
-	auto time = real::GameTime::GetInstance().EndTimer(id);
 
 	auto& go = GetOwner()->CreateGameObject();
 	m_pTransparentMeshComponent = go.AddComponent<TransparentModel>(static_cast<uint32_t>((faces.size() * 4) * 2), static_cast<uint32_t>((faces.size() * 6) * 2));
@@ -2,6 +2,7 @@
 #define CHUNK_H
 
 #include <array>
+#include <bitset>
 #include <real_core/Component.h>
 
 #include "TransparentModel.h"
@@ -9,6 +10,7 @@
 #include "Mesh/MeshIndexed.h"
 #include "Misc/AABB.h"
 #include "Util/Macros.h"
+#include "Util/SectionVisibility.h"
 
 class World;
 enum class EDirection : char;
@@ -17,6 +19,13 @@ enum class EBlock;
 class Chunk final : public real::Component
 {
 public:
+	// The solid indices of a section are stored after each other, so every section can be drawn on its own
+	struct Section
+	{
+		uint32_t firstIndex{ 0 }, indexCount{ 0 };
+		SectionVisibility visibility{};
+	};
+
 	explicit Chunk(real::GameObject* pOwner, const std::vector<std::pair<glm::ivec3, EBlock>>& blocks = {});
 	~Chunk() override = default;
 
@@ -32,17 +41,32 @@ public:
 	void SortBlocks(const glm::ivec3& position) const;
 
 	void SetAsCenter(bool isCenter) { m_ChunkIsCenter = isCenter; }
+	real::MeshIndexed<real::PosTexNorm, real::ObjectConstants>* GetSolidMesh() const { return m_pSolidMeshComponent; }
+	// Spans the lowest to the highest block that is in a mesh
+	const real::AABB& GetAabb() const { return m_Aabb; }
+	// Written by World::CullChunks every frame
+	void SetInFrustum(bool isInFrustum) { m_IsInFrustum = isInFrustum; }
+
+	const std::array<Section, SECTION_COUNT>& GetSections() const { return m_Sections; }
+	real::AABB GetSectionAabb(int section) const;
+	// Written by World::CullSections every frame
+	bool IsSectionVisible(int section) const { return m_VisibleSections[section]; }
+	void SetSectionVisible(int section) { m_VisibleSections[section] = true; }
+	void SetAllSectionsVisible(bool isVisible) { isVisible ? m_VisibleSections.set() : m_VisibleSections.reset(); }
 
 	bool IsBlockAir(const glm::ivec3& pos) const;
 	bool IsBlockWater(const glm::ivec3& pos) const;
 	void SetBlock(const glm::ivec3& pos, EBlock block);
 
 private:
-	bool m_IsDirty{ false }, m_ChunkIsCenter{ false };
+	bool m_IsDirty{ false }, m_ChunkIsCenter{ false }, m_IsInFrustum{ true };
 
 	int m_LowestY{ CHUNK_HEIGHT }, m_HighestY{ 0 };
 	real::AABB m_Aabb{};
 
+	std::array<Section, SECTION_COUNT> m_Sections{};
+	std::bitset<SECTION_COUNT> m_VisibleSections{ ~0ull };
+
 	float m_BlockRemoveTime{ 2.f }, m_AccuTime{ 0.f };
 	size_t m_RemoveBlock{ 63 }, m_AddBlock{ 64 };
 
@@ -51,7 +75,7 @@ private:
 	std::map<glm::vec3, std::pair<bool, std::vector<real::PosTexNorm>>, VecComparator<3, float>> m_RenderedBlocks{};
 	//std::map < glm::vec3, std::pair<EBlock>> m_ChangedBlocks;
 
-	real::MeshIndexed<real::PosTexNorm, real::UniformBufferObject>* m_pSolidMeshComponent{ nullptr };
+	real::MeshIndexed<real::PosTexNorm, real::ObjectConstants>* m_pSolidMeshComponent{ nullptr };
 
 	TransparentModel* m_pTransparentMeshComponent{ nullptr };
 
@@ -61,6 +85,8 @@ private:
 	std::vector<TransparentFace> CalculateTransparentMeshData();
 
 	bool CanRenderFace(EBlock currentBlock, int x, int z, int y) const;
+	void CalculateSectionVisibility();
+	void UpdateAabb();
 
 	void InitSolidChunk(const real::GameContext& context);
 
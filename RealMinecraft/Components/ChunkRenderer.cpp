@@ -0,0 +1,135 @@
+#include "ChunkRenderer.h"
+
+#include <ranges>
+
+#include <real_core/Benchmark.h>
+#include <real_core/imgui.h>
+
+#include "Chunk.h"
+#include "World.h"
+#include "Core/CommandPool.h"
+#include "Graphics/Renderer.h"
+#include "Graphics/RenderQueue.h"
+#include "Material/MaterialManager.h"
+#include "Materials/ChunkMaterial.h"
+#include "Mesh/MeshBufferManager.h"
+#include "Misc/Camera.h"
+#include "Misc/CameraManager.h"
+#include "RealEngine.h"
+
+ChunkRenderer::ChunkRenderer(real::GameObject* pOwner, World* pWorld)
+	: DrawableComponent(pOwner)
+	, m_pWorld(pWorld)
+{
+	const auto context = real::RealEngine::GetGameContext();
+
+	m_pBatch = std::make_unique<real::IndirectBatch>(context);
+	m_pCachedCommands = std::make_unique<real::CachedCommandBuffer>(context);
+
+	m_pMaterial = real::MaterialManager::GetInstance().GetMaterial<ChunkMaterial>();
+}
+
+void ChunkRenderer::PreRender()
+{
+	const auto context = real::RealEngine::GetGameContext();
+	const auto commandBuffer = real::CommandPool::GetInstance().GetActiveCommandBuffer();
+	const auto frame = real::Renderer::GetInstance().GetCurrentFrame();
+	const auto pCamera = real::CameraManager::GetInstance().GetActiveCamera();
+
+	if (m_IsSectionCullingEnabled)
+		m_pWorld->CullSections(pCamera->GetOwner()->GetTransform()->GetWorldPosition(), pCamera->GetViewProjection());
+
+	// Every visible section is submitted, the cull pass decides which ones get drawn
+	m_pBatch->Clear();
+	m_TriangleCount = 0;
+	m_SubmittedTriangleCount = 0;
+	for (const auto pChunk : m_pWorld->GetChunks() | std::views::values)
+	{
+		const auto pMesh = pChunk->GetSolidMesh();
+		if (pMesh == nullptr || pMesh->IsActive() == false || pMesh->GetOwner()->IsActive() == false)
+			continue;
+
+		const auto& sections = pChunk->GetSections();
+		for (int section = 0; section < SECTION_COUNT; ++section)
+		{
+			const auto firstIndex = sections[section].firstIndex;
+			const auto indexCount = sections[section].indexCount;
+			if (indexCount == 0)
+				continue;
+
+			m_TriangleCount += indexCount / 3;
+			if (m_IsSectionCullingEnabled && pChunk->IsSectionVisible(section) == false)
+				continue;
+
+			m_SubmittedTriangleCount += indexCount / 3;
+			pMesh->AddToBatch(*m_pBatch, pChunk->GetSectionAabb(section), firstIndex, indexCount);
+		}
+	}
+
+	auto& benchmark = real::Benchmark::GetInstance();
+	benchmark.Count("Chunk triangles", m_TriangleCount);
+	benchmark.Count("Chunk triangles culled by section visibility", m_TriangleCount - m_SubmittedTriangleCount);
+
+	if (m_pBatch->GetDrawCount() == 0)
+		return;
+
+	m_pBatch->Prepare(context);
+
+	benchmark.Count("Draws culled by frustum", m_pBatch->GetFrustumCulledCount());
+	benchmark.Count("Draws culled by occlusion", m_pBatch->GetOcclusionCulledCount());
+
+	// The transform buffer of this frame gets replaced when the batch outgrows it
+	if (const auto transformBuffer = m_pBatch->GetTransformBuffer(frame); m_BoundTransformBuffers[frame] != transformBuffer)
+	{
+		m_pMaterial->SetTransformBuffer(frame, transformBuffer, m_pBatch->GetTransformBufferSize(frame));
+		m_BoundTransformBuffers[frame] = transformBuffer;
+
+		// Updating the descriptor set invalidates every command buffer it was recorded in
+		m_pCachedCommands->Invalidate(frame);
+	}
+
+	if (const auto drawVersion = m_pBatch->GetDrawVersion(frame); m_CachedDrawVersions[frame] != drawVersion)
+	{
+		m_pCachedCommands->Invalidate(frame);
+		m_CachedDrawVersions[frame] = drawVersion;
+	}
+
+	m_pBatch->Cull(commandBuffer, pCamera->GetViewProjection());
+}
+
+void ChunkRenderer::Render()
+{
+	if (m_pBatch->GetDrawCount() == 0)
+		return;
+
+	real::RenderQueue::GetInstance().Submit(real::RenderPassType::opaque, m_pMaterial, GetOwner()->GetTransform()->GetWorldPosition(),
+		[this](VkCommandBuffer commandBuffer)
+		{
+			auto& meshBufferManager = real::MeshBufferManager::GetInstance();
+			m_pBatch->Draw(commandBuffer, meshBufferManager.GetVertexArena(sizeof(real::PosTexNorm)), meshBufferManager.GetIndexArena());
+		}, m_pCachedCommands.get());
+}
+
+void ChunkRenderer::OnGui()
+{
+	// The counts of the cull pass are read back MAX_FRAMES_IN_FLIGHT frames late
+	ImGui::Begin("Chunk culling");
+	ImGui::Checkbox("Section visibility", &m_IsSectionCullingEnabled);
+	ImGui::Text("Triangles: %u / %u", m_SubmittedTriangleCount, m_TriangleCount);
+	if (m_TriangleCount > 0)
+		ImGui::Text("Culled by section visibility: %.1f%%", 100.f * static_cast<float>(m_TriangleCount - m_SubmittedTriangleCount) / static_cast<float>(m_TriangleCount));
+	ImGui::Text("Draws: %u", m_pBatch->GetDrawCount());
+	ImGui::Text("Visible: %u", m_pBatch->GetVisibleCount());
+	ImGui::Text("Culled by frustum: %u", m_pBatch->GetFrustumCulledCount());
+	ImGui::Text("Culled by occlusion: %u", m_pBatch->GetOcclusionCulledCount());
+	ImGui::Text("Draw calls: %u", m_pBatch->GetDrawCallCount());
+	ImGui::End();
+}
+
+void ChunkRenderer::Kill()
+{
+	const auto context = real::RealEngine::GetGameContext();
+
+	m_pBatch->CleanUp(context);
+	m_pCachedCommands->CleanUp(context);
+}
@@ -0,0 +1,49 @@
+#ifndef CHUNKRENDERER_H
+#define CHUNKRENDERER_H
+
+#include <array>
+#include <memory>
+#include <real_core/DrawableComponent.h>
+
+#include "Core/CommandBuffers/CachedCommandBuffer.h"
+#include "Graphics/IndirectBatch.h"
+#include "Util/VulkanUtil.h"
+
+class ChunkMaterial;
+class World;
+
+// Culls the opaque geometry of every chunk on the gpu and draws the survivors with a single indirect draw per arena block.
+// Every section of a chunk is its own draw, sections World::CullSections can not see into are not submitted at all.
+class ChunkRenderer final : public real::DrawableComponent
+{
+public:
+	explicit ChunkRenderer(real::GameObject* pOwner, World* pWorld);
+	virtual ~ChunkRenderer() override = default;
+
+	ChunkRenderer(const ChunkRenderer& other) = delete;
+	ChunkRenderer& operator=(const ChunkRenderer& rhs) = delete;
+	ChunkRenderer(ChunkRenderer&& other) = delete;
+	ChunkRenderer& operator=(ChunkRenderer&& rhs) = delete;
+
+	virtual void PreRender() override;
+	virtual void Render() override;
+	virtual void Kill() override;
+	virtual void OnGui() override;
+
+private:
+	World* m_pWorld;
+
+	ChunkMaterial* m_pMaterial{ nullptr };
+
+	bool m_IsSectionCullingEnabled{ true };
+	uint32_t m_TriangleCount{ 0 }, m_SubmittedTriangleCount{ 0 };
+
+	std::unique_ptr<real::IndirectBatch> m_pBatch{ nullptr };
+	std::array<VkBuffer, MAX_FRAMES_IN_FLIGHT> m_BoundTransformBuffers{};
+
+	// The draws only change when the batch does, the culling results are read from its buffers
+	std::unique_ptr<real::CachedCommandBuffer> m_pCachedCommands{ nullptr };
+	std::array<uint64_t, MAX_FRAMES_IN_FLIGHT> m_CachedDrawVersions{};
+};
+
+#endif // CHUNKRENDERER_H
@@ -16,7 +16,7 @@ OutlineBlock::OutlineBlock(real::GameObject* pOwner, real::GameObject* player, W
 
 void OutlineBlock::Start()
 {
-	m_pMeshComponent = GetOwner()->GetComponent<real::MeshIndexed<real::PosColNorm, real::UniformBufferObject>>();
+	m_pMeshComponent = GetOwner()->GetComponent<real::MeshIndexed<real::PosColNorm, real::ObjectConstants>>();
 }
 
 void OutlineBlock::Update()
@@ -39,7 +39,7 @@ private:
 	std::pair<glm::ivec2, glm::ivec3> m_SelectedBlock;
 	std::pair<glm::ivec2, glm::ivec3> m_CanPlaceAt;
 
-	real::MeshIndexed<real::PosColNorm, real::UniformBufferObject>* m_pMeshComponent{ nullptr };
+	real::MeshIndexed<real::PosColNorm, real::ObjectConstants>* m_pMeshComponent{ nullptr };
 };
 
 
@@ -2,8 +2,10 @@
 
 #include <algorithm>
 
-#include "Core/CommandBuffers/CommandBuffer.h"
+#include "Core/UploadManager.h"
 
+#include "Graphics/Renderer.h"
+#include "Graphics/RenderQueue.h"
 #include "Material/MaterialManager.h"
 #include "real_core/GameTime.h"
 #include "Util/GameInfo.h"
@@ -11,136 +13,109 @@
 TransparentModel::TransparentModel(real::GameObject* pOwner, uint32_t vertexCapacity, uint32_t indexCapacity)
 	: DrawableComponent(pOwner), m_VertexCapacity(vertexCapacity), m_IndexCapacity(indexCapacity)
 {
-	m_VertexBuffers.push_back({});
-	m_IndexBuffers.push_back({});
-
 	if (m_VertexCapacity == 0) m_VertexCapacity = 512;
 	if (m_IndexCapacity == 0) m_IndexCapacity = 512;
 
-	CreateBuffer<real::PosTexNorm>(m_VertexBuffers, 0, m_VertexCapacity, true);
-	CreateBuffer<uint32_t>(m_IndexBuffers, 0, m_IndexCapacity, false);
+	for (auto& vertexBuffer : m_VertexBuffers)
+		CreateVertexBuffer(vertexBuffer, m_VertexCapacity);
+	for (auto& indexBuffer : m_IndexBuffers)
+		CreateIndexBuffer(indexBuffer, m_IndexCapacity);
 
 	m_pTransparentMaterial = real::MaterialManager::GetInstance().GetMaterial<TransparentMaterial>();
 	m_pWaterMaterial = real::MaterialManager::GetInstance().GetMaterial<WaterMaterial>();
 	m_pTranspriteMaterial = real::MaterialManager::GetInstance().GetMaterial<TranspriteMaterial>();
-
-	m_TransparentReference = m_pTransparentMaterial->AddReference();
-	m_WaterReference = m_pWaterMaterial->AddReference();
-	m_TranspriteReference = m_pTranspriteMaterial->AddReference();
 }
 
 TransparentModel::~TransparentModel()
 {
-	const auto context = real::RealEngine::GetGameContext();
+	DestroyBuffers();
+}
 
-	for (auto& [isDirty, buffer, allocation, data] : m_IndexBuffers)
-	{
-		if (buffer == nullptr)
-			continue;
+void TransparentModel::Render()
+{
+	// The fence of the current frame has been waited on, so its vertex and index buffers are no longer in use
+	const uint32_t currentFrame = real::Renderer::GetInstance().GetCurrentFrame();
 
-		vmaDestroyBuffer(context.vulkanContext.allocator, buffer, allocation);
-		buffer = nullptr;
-	}
+	auto& vertexBuffer = m_VertexBuffers[currentFrame];
+	if (vertexBuffer.isDirty)
+		UploadVertices(vertexBuffer);
 
-	for (auto& [isDirty, buffer, allocation, data] : m_VertexBuffers)
+	auto& indexBuffer = m_IndexBuffers[currentFrame];
+	if (indexBuffer.isDirty)
+		WriteIndices(indexBuffer);
+
+	// The regions are submitted in their sorted order, the queue keeps it for the regions of a single model
+	auto& renderQueue = real::RenderQueue::GetInstance();
+	// Resolved here, the draws might get recorded on a worker thread
+	const glm::vec3 position = GetOwner()->GetTransform()->GetWorldMatrix()[3];
+	for (const auto& [begin, end, type] : m_Regions)
 	{
-		if (buffer == nullptr)
+		const auto pMaterial = GetMaterial(type);
+		if (pMaterial == nullptr || begin == end)
 			continue;
 
-		vmaDestroyBuffer(context.vulkanContext.allocator, buffer, allocation);
-		buffer = nullptr;
-	}
-}
+		renderQueue.Submit(real::RenderPassType::transparent, pMaterial, position,
+			[this, begin, end, type, vertices = vertexBuffer.buffer, indices = indexBuffer.buffer](VkCommandBuffer commandBuffer)
+			{
+				UpdateShaderVariables(type);
 
-void TransparentModel::Update()
-{
-	if (m_BuffersAreDirty == false)
-		return;
+				const VkBuffer vertexBuffers[] = { vertices };
+				const VkDeviceSize offsets[] = { 0 };
+				vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
 
-	for (auto& [isDirty, buffer, memory, data] : m_VertexBuffers)
-	{
-		//if (isDirty)
-		//{
-			UpdateBuffer<real::PosTexNorm>(m_Vertices, buffer, m_VertexCapacity);
-			isDirty = false;
-		//}
+				vkCmdBindIndexBuffer(commandBuffer, indices, 0, VK_INDEX_TYPE_UINT32);
+				vkCmdDrawIndexed(commandBuffer, end - begin, 1, begin, 0, 0);
+			});
 	}
+}
 
-	for (auto& [isDirty, buffer, memory, data] : m_IndexBuffers)
+real::BaseMaterial* TransparentModel::GetMaterial(TransparencyType type) const
+{
+	switch (type)
 	{
-		//if (isDirty)
-		//{
-			UpdateBuffer<uint32_t>(m_Indices, buffer, m_IndexCapacity);
-			isDirty = false;
-		//}
+	case TransparencyType::water:
+		return m_pWaterMaterial;
+	case TransparencyType::transparentTexture:
+		return m_pTransparentMaterial;
+	case TransparencyType::transparentSprite:
+		return m_pTranspriteMaterial;
+	default:
+		return nullptr;
 	}
-
-	m_BuffersAreDirty = false;
 }
 
-void TransparentModel::Render()
+void TransparentModel::UpdateShaderVariables(TransparencyType type) const
 {
-	const auto commandBuffer = real::CommandPool::GetInstance().GetActiveCommandBuffer();
-
-	m_pTransparentMaterial->UpdateShaderVariables(this, m_TransparentReference);
-	m_pWaterMaterial->UpdateShaderVariables(this, m_WaterReference);
-	m_pTranspriteMaterial->UpdateShaderVariables(this, m_TranspriteReference);
-
-	for (const auto& [begin, end, type] : m_Regions)
+	switch (type)
 	{
-		switch (type)
-		{
-		case TransparencyType::water:
-		{
-			m_pWaterMaterial->Bind(commandBuffer, m_WaterReference);
-			break;
-		}
-		case TransparencyType::transparentTexture:
-		{
-			m_pTransparentMaterial->Bind(commandBuffer, m_TransparentReference);
-			break;
-		}
-		case TransparencyType::transparentSprite:
-		{
-			m_pTranspriteMaterial->Bind(commandBuffer, m_TranspriteReference);
-			break;
-		}
-		}
-
-		const VkBuffer vertexBuffers[] = { m_VertexBuffers.front().buffer };
-		const VkDeviceSize offsets[] = { 0 };
-		vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
-		
-		vkCmdBindIndexBuffer(commandBuffer, m_IndexBuffers.front().buffer, 0, VK_INDEX_TYPE_UINT32);
-		vkCmdDrawIndexed(commandBuffer, end - begin, 1, begin, 0, 0);
+	case TransparencyType::water:
+		m_pWaterMaterial->UpdateShaderVariables(this);
+		break;
+	case TransparencyType::transparentTexture:
+		m_pTransparentMaterial->UpdateShaderVariables(this);
+		break;
+	case TransparencyType::transparentSprite:
+		m_pTranspriteMaterial->UpdateShaderVariables(this);
+		break;
+	default:
+		break;
 	}
 }
 
 void TransparentModel::Kill()
 {
-	const auto context = real::RealEngine::GetGameContext();
-
-	for (auto& [isDirty, buffer, allocation, data] : m_IndexBuffers)
-	{
-		vmaDestroyBuffer(context.vulkanContext.allocator, buffer, allocation);
-		buffer = nullptr;
-	}
-
-	for (auto& [isDirty, buffer, allocation, data] : m_VertexBuffers)
-	{
-		vmaDestroyBuffer(context.vulkanContext.allocator, buffer, allocation);
-		buffer = nullptr;
-	}
-
-	m_pTransparentMaterial->CleanUpUbo(m_TransparentReference);
-	m_pWaterMaterial->CleanUpUbo(m_WaterReference);
-	m_pTranspriteMaterial->CleanUpUbo(m_TranspriteReference);
+	DestroyBuffers();
 }
 
 void TransparentModel::AddFaces(const std::vector<TransparentFace>& faces)
 {
 	m_Faces.insert(m_Faces.end(), faces.begin(), faces.end());
-	m_BuffersAreDirty = true;
+
+	for (const auto& face : faces)
+		m_Vertices.insert(m_Vertices.end(), face.vertices.begin(), face.vertices.end());
+
+	for (auto& vertexBuffer : m_VertexBuffers)
+		vertexBuffer.isDirty = true;
 }
 
 void TransparentModel::SetFaces(const std::vector<TransparentFace>& faces)
@@ -152,21 +127,33 @@ void TransparentModel::SetFaces(const std::vector<TransparentFace>& faces)
 void TransparentModel::ClearFaces()
 {
 	m_Faces.clear();
-	m_BuffersAreDirty = true;
+	m_Vertices.clear();
+
+	for (auto& vertexBuffer : m_VertexBuffers)
+		vertexBuffer.isDirty = true;
 }
 
 void TransparentModel::SortFaces(const glm::ivec3& position, bool sortBlocks)
 {
-	m_Vertices.clear();
 	m_Indices.clear();
 	m_Regions.clear();
 
+	for (auto& indexBuffer : m_IndexBuffers)
+		indexBuffer.isDirty = true;
+
 	if (m_Faces.empty())
 		return;
 
+	// Order independent transparency only needs the faces grouped per material
+	if (real::RealEngine::GetGameContext().weightedBlendedOit)
+		sortBlocks = false;
+
+	m_FaceOrder.resize(m_Faces.size());
+	std::iota(m_FaceOrder.begin(), m_FaceOrder.end(), 0);
+
 	if (sortBlocks)
 	{
-		std::ranges::sort(m_Faces, [&position](const TransparentFace& a, const TransparentFace& b)
+		std::ranges::sort(m_FaceOrder, [this, &position](uint32_t a, uint32_t b)
 			{
 				auto distanceSquared = [](const glm::ivec2& p1, const glm::ivec2& p2)
 					{
@@ -174,22 +161,22 @@ void TransparentModel::SortFaces(const glm::ivec3& position, bool sortBlocks)
 						return diff.x * diff.x + diff.y * diff.y;
 					};
 
-				return distanceSquared(a.center, position) > distanceSquared(b.center, position);
+				return distanceSquared(m_Faces[a].center, position) > distanceSquared(m_Faces[b].center, position);
 			});
 	}
 	else
 	{
-		std::ranges::sort(m_Faces, [](const TransparentFace& a, const TransparentFace& b)
+		std::ranges::sort(m_FaceOrder, [this](uint32_t a, uint32_t b)
 			{
-				return a.type < b.type;
+				return m_Faces[a].type < m_Faces[b].type;
 			});
 	}
 
 	auto currentType = TransparencyType::none;
-	auto currentIdx = 0, prevIdx = 0;
-	auto offset = 0;
-	for (const auto& face : m_Faces)
+	uint32_t currentIdx = 0, prevIdx = 0;
+	for (const auto faceIdx : m_FaceOrder)
 	{
+		const auto& face = m_Faces[faceIdx];
 		if (currentType != face.type)
 		{
 			m_Regions.emplace_back(prevIdx, currentIdx, currentType);
@@ -198,26 +185,97 @@ void TransparentModel::SortFaces(const glm::ivec3& position, bool sortBlocks)
 			prevIdx = currentIdx;
 		}
 
-		m_Vertices.insert(m_Vertices.begin(), face.vertices.begin(), face.vertices.end());
-		m_Indices.insert(m_Indices.begin(), {
-							 (uint32_t)0 + offset, (uint32_t)1 + offset, (uint32_t)2 + offset, (uint32_t)2 + offset,
-							 (uint32_t)3 + offset, (uint32_t)0 + offset });
+		const uint32_t offset = faceIdx * static_cast<uint32_t>(face.vertices.size());
+		for (const auto idx : face.idcs)
+			m_Indices.push_back(idx + offset);
 
-		currentIdx += 6;
-		offset += 4;
+		currentIdx += static_cast<uint32_t>(face.idcs.size());
 	}
 
 	m_Regions.emplace_back(prevIdx, currentIdx, currentType);
-	m_BuffersAreDirty = true;
 }
 
-void TransparentModel::CopyBuffer(const real::GameContext& context, VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size)
+void TransparentModel::CreateVertexBuffer(FrameVertexBuffer& vertexBuffer, uint32_t capacity) const
+{
+	const auto context = real::RealEngine::GetGameContext();
+
+	real::CreateBuffer(context, sizeof(real::PosTexNorm) * capacity,
+		VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, vertexBuffer.buffer, vertexBuffer.allocation, real::EMemoryCategory::transparent);
+
+	vertexBuffer.capacity = capacity;
+}
+
+void TransparentModel::UploadVertices(FrameVertexBuffer& vertexBuffer)
 {
-	const auto commandBuffer = real::CommandBuffer::StartSingleTimeCommands(context);
+	vertexBuffer.isDirty = false;
 
-	VkBufferCopy copyRegion{};
-	copyRegion.size = size;
-	vkCmdCopyBuffer(commandBuffer, srcBuffer, dstBuffer, 1, &copyRegion);
+	if (m_Vertices.empty())
+		return;
 
-	real::CommandBuffer::StopSingleTimeCommands(context, commandBuffer);
-}
\ No newline at end of file
+	if (m_Vertices.size() > vertexBuffer.capacity)
+	{
+		const auto context = real::RealEngine::GetGameContext();
+		real::DestroyBuffer(context.vulkanContext.allocator, vertexBuffer.buffer, vertexBuffer.allocation);
+
+		m_VertexCapacity = std::max(m_VertexCapacity, static_cast<uint32_t>(m_Vertices.size()) * 2);
+		CreateVertexBuffer(vertexBuffer, m_VertexCapacity);
+	}
+
+	// The upload batch makes the copy visible to the vertex input of this frame's draws
+	real::UploadManager::GetInstance().UploadBuffer(vertexBuffer.buffer, m_Vertices.data(), sizeof(real::PosTexNorm) * m_Vertices.size());
+}
+
+void TransparentModel::CreateIndexBuffer(FrameIndexBuffer& indexBuffer, uint32_t capacity) const
+{
+	const auto context = real::RealEngine::GetGameContext();
+
+	real::CreateBuffer(context, sizeof(uint32_t) * capacity, VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+		VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+		indexBuffer.buffer, indexBuffer.allocation, real::EMemoryCategory::transparent);
+
+	vmaMapMemory(context.vulkanContext.allocator, indexBuffer.allocation, &indexBuffer.pMapped);
+	indexBuffer.capacity = capacity;
+}
+
+void TransparentModel::WriteIndices(FrameIndexBuffer& indexBuffer)
+{
+	if (m_Indices.size() > indexBuffer.capacity)
+	{
+		const auto context = real::RealEngine::GetGameContext();
+
+		vmaUnmapMemory(context.vulkanContext.allocator, indexBuffer.allocation);
+		real::DestroyBuffer(context.vulkanContext.allocator, indexBuffer.buffer, indexBuffer.allocation);
+
+		m_IndexCapacity = std::max(m_IndexCapacity, static_cast<uint32_t>(m_Indices.size()) * 2);
+		CreateIndexBuffer(indexBuffer, m_IndexCapacity);
+	}
+
+	memcpy(indexBuffer.pMapped, m_Indices.data(), sizeof(uint32_t) * m_Indices.size());
+	indexBuffer.isDirty = false;
+}
+
+void TransparentModel::DestroyBuffers()
+{
+	const auto context = real::RealEngine::GetGameContext();
+
+	for (auto& indexBuffer : m_IndexBuffers)
+	{
+		if (indexBuffer.buffer == nullptr)
+			continue;
+
+		vmaUnmapMemory(context.vulkanContext.allocator, indexBuffer.allocation);
+		real::DestroyBuffer(context.vulkanContext.allocator, indexBuffer.buffer, indexBuffer.allocation);
+		indexBuffer.buffer = nullptr;
+		indexBuffer.pMapped = nullptr;
+	}
+
+	for (auto& vertexBuffer : m_VertexBuffers)
+	{
+		if (vertexBuffer.buffer == nullptr)
+			continue;
+
+		real::DestroyBuffer(context.vulkanContext.allocator, vertexBuffer.buffer, vertexBuffer.allocation);
+		vertexBuffer.buffer = nullptr;
+	}
+}
@@ -54,7 +54,6 @@ public:
 	TransparentModel(TransparentModel&&) = delete;
 	TransparentModel& operator=(TransparentModel&&) = delete;
 
-	virtual void Update() override;
 	virtual void Render() override;
 
 	virtual void Kill() override;
@@ -66,90 +65,49 @@ public:
 	void SortFaces(const glm::ivec3& position, bool sortBlocks = true);
 
 private:
+	// One per frame in flight, a buffer is only rewritten once the frame that last read it has finished
+	struct FrameVertexBuffer
+	{
+		VkBuffer buffer{ nullptr };
+		VmaAllocation allocation{ nullptr };
+		uint32_t capacity{ 0 };
+		bool isDirty{ false };
+	};
+
+	struct FrameIndexBuffer
+	{
+		VkBuffer buffer{ nullptr };
+		VmaAllocation allocation{ nullptr };
+		void* pMapped{ nullptr };
+		uint32_t capacity{ 0 };
+		bool isDirty{ false };
+	};
+
 	uint32_t m_VertexCapacity, m_IndexCapacity;
 
-	real::BaseMaterial* m_pCurrentMaterial{ nullptr };
 	TransparentMaterial* m_pTransparentMaterial{ nullptr };
 	WaterMaterial* m_pWaterMaterial{ nullptr };
 	TranspriteMaterial* m_pTranspriteMaterial{ nullptr };
 
+	// Vertices are stored once in face order, sorting only permutes the indices
 	std::vector<real::PosTexNorm> m_Vertices{};
 	std::vector<uint32_t> m_Indices{};
+	std::vector<uint32_t> m_FaceOrder{};
 	std::vector<std::tuple<uint32_t, uint32_t, TransparencyType>> m_Regions;
 
-	uint32_t m_WaterReference{ 0 }, m_TransparentReference{ 0 }, m_TranspriteReference{ 0 };
-
-	bool m_BuffersAreDirty{ false };
-	std::vector<real::BufferContext<real::PosTexNorm>> m_VertexBuffers;
-	std::vector<real::BufferContext<uint32_t>> m_IndexBuffers;
+	std::array<FrameVertexBuffer, MAX_FRAMES_IN_FLIGHT> m_VertexBuffers{};
+	std::array<FrameIndexBuffer, MAX_FRAMES_IN_FLIGHT> m_IndexBuffers{};
 
 	std::vector<TransparentFace> m_Faces;
 
-	template <typename T>
-	void CreateBuffer(std::vector<real::BufferContext<T>>& buffers, size_t index, uint32_t capacity, bool isVertexBuffer);
-	template <typename T>
-	void UpdateBuffer(const std::vector<T>& data, VkBuffer buffer, uint32_t capacity);
-	template <typename T>
-	static void UpdateBufferHelper(VmaAllocation allocation, const std::vector<T>& v);
-	static void CopyBuffer(const real::GameContext& context, VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size);
-};
-
-template <typename T>
-void TransparentModel::CreateBuffer(std::vector<real::BufferContext<T>>& buffers, size_t index, uint32_t capacity, bool isVertexBuffer)
-{
-	const auto context = real::RealEngine::GetGameContext();
-
-	const VkDeviceSize bufferSize = sizeof(T) * capacity;
-
-	VkBuffer stagingBuffer;
-	VmaAllocation stagingBufferAllocation;
-	real::CreateBuffer(context, bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-		VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-		stagingBuffer, stagingBufferAllocation);
-
-	UpdateBufferHelper<T>(stagingBufferAllocation, buffers[index].data);
-
-	VkBuffer buffer;
-	VmaAllocation bufferAllocation;
-	real::CreateBuffer(context, bufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | (isVertexBuffer ? VK_BUFFER_USAGE_VERTEX_BUFFER_BIT : VK_BUFFER_USAGE_INDEX_BUFFER_BIT),
-		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, buffer,
-		bufferAllocation);
+	real::BaseMaterial* GetMaterial(TransparencyType type) const;
+	void UpdateShaderVariables(TransparencyType type) const;
 
-	CopyBuffer(context, stagingBuffer, buffer, bufferSize);
-
-	buffers[index].buffer = buffer;
-	buffers[index].allocation = bufferAllocation;
-
-	vmaDestroyBuffer(context.vulkanContext.allocator, stagingBuffer, stagingBufferAllocation);
-}
-
-template <typename T>
-void TransparentModel::UpdateBuffer(const std::vector<T>& data, VkBuffer buffer, uint32_t capacity)
-{
-	const VkDeviceSize bufferSize = sizeof(T) * capacity;
-	const auto context = real::RealEngine::GetGameContext();
-
-	VkBuffer stagingBuffer;
-	VmaAllocation stagingBufferAllocation;
-	real::CreateBuffer(context, bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-		VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-		stagingBuffer, stagingBufferAllocation);
-
-	UpdateBufferHelper<T>(stagingBufferAllocation, data);
-
-	CopyBuffer(context, stagingBuffer, buffer, bufferSize);
-
-	vmaDestroyBuffer(context.vulkanContext.allocator, stagingBuffer, stagingBufferAllocation);
-}
-
-template <typename T>
-void TransparentModel::UpdateBufferHelper(VmaAllocation allocation, const std::vector<T>& v)
-{
-	void* data;
-	const auto context = real::RealEngine::GetGameContext();
-	vmaMapMemory(context.vulkanContext.allocator, allocation, &data);
-	memcpy(data, v.data(), sizeof(T) * v.size());
-	vmaUnmapMemory(context.vulkanContext.allocator, allocation);
-}
+	void CreateVertexBuffer(FrameVertexBuffer& vertexBuffer, uint32_t capacity) const;
+	void UploadVertices(FrameVertexBuffer& vertexBuffer);
+	void CreateIndexBuffer(FrameIndexBuffer& indexBuffer, uint32_t capacity) const;
+	void WriteIndices(FrameIndexBuffer& indexBuffer);
+	void DestroyBuffers();
+};
 
 #endif // TRANSPARENTMODEL_H
@@ -1,10 +1,18 @@
 #include "World.h"
 
+#include <algorithm>
+#include <iostream>
 #include <ranges>
+#include <real_core/CpuProfiler.h>
 #include <real_core/GameObject.h>
 
+#include "RealEngine.h"
+#include "Misc/AABB.h"
+#include "Misc/Camera.h"
+#include "Misc/CameraManager.h"
 #include "Util/Macros.h"
 #include "Components/Chunk.h"
+#include "Components/ChunkRenderer.h"
 #include "real_core/GameTime.h"
 #include "real_core/SceneManager.h"
 
@@ -17,6 +25,9 @@ World::World(real::GameObject* pOwner, uint32_t seed)
 
 void World::Start()
 {
+	auto& rendererGo = GetOwner()->CreateGameObject();
+	rendererGo.AddComponent<ChunkRenderer>(this);
+
 #ifndef SINGLE_CHUNK
 	for (int x = -render_distance; x < render_distance + 1; ++x)
 	{
@@ -41,13 +52,19 @@ void World::Start()
 	real::SceneManager::GetInstance().GetActiveScene().GetGameObject(1)->GetComponent<Player>()->playerMovedBlock.AddObserver(this);
 
 	m_pChunks.at(m_CurrentChunkPos)->SetAsCenter(true);
+
+	real::MemoryTracker::GetInstance().budgetChanged.AddObserver(this);
 }
 
 void World::Update()
 {
+	CullChunks();
+
 	if (m_ChunksToAdd.empty())
 		return;
 
+	REAL_PROFILE_ZONE("Add chunk");
+
 	const auto [chunkPos, adjacentChunk, direction] = m_ChunksToAdd.front();
 	m_ChunksToAdd.pop_front();
 
@@ -84,7 +101,9 @@ void World::LateUpdate()
 	if (m_IsDirty == false)
 		return;
 
-	SortChunks(m_CurrentChunkPos);
+	// Chunks only need to be drawn back to front when transparency is sorted
+	if (real::RealEngine::GetGameContext().weightedBlendedOit == false)
+		SortChunks(m_CurrentChunkPos);
 
 	m_IsDirty = false;
 }
@@ -93,6 +112,7 @@ void World::Kill()
 {
 	real::SceneManager::GetInstance().GetActiveScene().GetGameObject(1)->GetComponent<Player>()->playerMovedChunk.RemoveObserver(this);
 	real::SceneManager::GetInstance().GetActiveScene().GetGameObject(1)->GetComponent<Player>()->playerMovedBlock.RemoveObserver(this);
+	real::MemoryTracker::GetInstance().budgetChanged.RemoveObserver(this);
 }
 
 void World::HandleEvent(Player::Events, const glm::ivec2& chunkPos)
@@ -106,11 +126,11 @@ void World::HandleEvent(Player::Events, const glm::ivec2& chunkPos)
 		m_pChunks.at(m_CurrentChunkPos)->SetAsCenter(true);
 		m_IsDirty = true;
 
-	const auto maxX = (chunkPos.x + render_distance) * CHUNK_SIZE;
-	const auto minX = (chunkPos.x - render_distance) * CHUNK_SIZE;
-	const auto maxY = (chunkPos.y + render_distance) * CHUNK_SIZE;
-	const auto minY = (chunkPos.y - render_distance) * CHUNK_SIZE;
-	constexpr int chunkShift = (render_distance * 2 + 1) * CHUNK_SIZE;
+	const auto maxX = (chunkPos.x + m_RenderDistance) * CHUNK_SIZE;
+	const auto minX = (chunkPos.x - m_RenderDistance) * CHUNK_SIZE;
+	const auto maxY = (chunkPos.y + m_RenderDistance) * CHUNK_SIZE;
+	const auto minY = (chunkPos.y - m_RenderDistance) * CHUNK_SIZE;
+	const int chunkShift = (m_RenderDistance * 2 + 1) * CHUNK_SIZE;
 
 	constexpr int add = 0, remove = 1;
 	std::map<int, std::vector<glm::ivec2>> dirtyChunks;
@@ -174,9 +194,19 @@ void World::HandleEvent(Player::Events, const glm::ivec2& chunkPos)
 
 void World::HandleEvent(Player::Events, const glm::ivec3& playerPos)
 {
+	if (real::RealEngine::GetGameContext().weightedBlendedOit)
+		return;
+
 	m_pChunks.at(m_CurrentChunkPos)->SortBlocks(playerPos);
 }
 
+void World::HandleEvent(real::MemoryTracker::Events event, const real::MemoryBudget&)
+{
+	// The render distance is not grown back, the chunks that would be added again could push it over once more
+	if (event == real::MemoryTracker::Events::overBudget)
+		ShrinkRenderDistance();
+}
+
 Chunk* World::GetChunkAt(const glm::ivec2& chunkPos) const
 {
 	if (m_pChunks.contains(chunkPos))
@@ -185,12 +215,98 @@ Chunk* World::GetChunkAt(const glm::ivec2& chunkPos) const
 	return nullptr;
 }
 
+void World::CullSections(const glm::vec3& cameraPosition, const glm::mat4& viewProjection)
+{
+	REAL_PROFILE_ZONE("Cull sections");
+
+	const auto startChunkPos = glm::ivec2{ glm::floor(glm::vec2{ cameraPosition.x, cameraPosition.z } / static_cast<float>(CHUNK_SIZE)) } * CHUNK_SIZE;
+	const auto pStartChunk = GetChunkAt(startChunkPos);
+
+	// Without a section to start from nothing can be culled
+	for (const auto pChunk : m_pChunks | std::views::values)
+		pChunk->SetAllSectionsVisible(pStartChunk == nullptr);
+
+	if (pStartChunk == nullptr)
+		return;
+
+	struct Step
+	{
+		Chunk* pChunk;
+		glm::ivec2 chunkPos;
+		int section;
+		// The face the section was entered through, -1 for the section of the camera
+		int entry;
+		// Every direction walked so far, walking back is never needed to see a section
+		uint8_t directions;
+	};
+
+	const auto planes = real::FrustumAABB::ExtractFrustumPlanes(viewProjection, false);
+	constexpr glm::ivec3 offsets[] = { {0,0,-1},{1,0,0},{0,0,1},{-1,0,0},{0,1,0},{0,-1,0} };
+
+	const int startSection = std::clamp(static_cast<int>(std::floor(cameraPosition.y / SECTION_SIZE)), 0, SECTION_COUNT - 1);
+	pStartChunk->SetSectionVisible(startSection);
+
+	std::deque<Step> steps;
+	steps.push_back({ pStartChunk, startChunkPos, startSection, -1, 0 });
+
+	while (steps.empty() == false)
+	{
+		const auto step = steps.front();
+		steps.pop_front();
+
+		const auto& visibility = step.pChunk->GetSections()[step.section].visibility;
+
+		for (int i = 0; i < static_cast<int>(EDirection::amountOfDirections); ++i)
+		{
+			const auto direction = static_cast<EDirection>(i);
+			const auto opposite = SectionVisibility::GetOpposite(direction);
+
+			if (step.directions & (1 << static_cast<int>(opposite)))
+				continue;
+
+			if (step.entry != -1 && visibility.IsConnected(static_cast<EDirection>(step.entry), direction) == false)
+				continue;
+
+			const int section = step.section + offsets[i].y;
+			if (section < 0 || section >= SECTION_COUNT)
+				continue;
+
+			const auto chunkPos = step.chunkPos + glm::ivec2{ offsets[i].x, offsets[i].z } * CHUNK_SIZE;
+			const auto pChunk = chunkPos == step.chunkPos ? step.pChunk : GetChunkAt(chunkPos);
+			if (pChunk == nullptr || pChunk->IsSectionVisible(section))
+				continue;
+
+			if (real::FrustumAABB::IsBoxInFrustum(planes, pChunk->GetSectionAabb(section)) == false)
+				continue;
+
+			pChunk->SetSectionVisible(section);
+			steps.push_back({ pChunk, chunkPos, section, static_cast<int>(opposite), static_cast<uint8_t>(step.directions | (1 << i)) });
+		}
+	}
+}
+
 void World::AddBlocksForFutureChunks(const glm::ivec2& chunkPos, const std::vector<std::pair<glm::ivec3, EBlock>>&
                                      blocks)
 {
 	m_BlocksForFutureChunks[chunkPos].insert(m_BlocksForFutureChunks[chunkPos].end(), blocks.begin(), blocks.end());
 }
 
+void World::CullChunks()
+{
+	REAL_PROFILE_ZONE("Cull chunks");
+
+	m_FrustumCuller.SetViewProjection(real::CameraManager::GetInstance().GetActiveCamera()->GetViewProjection());
+	m_FrustumCuller.Clear();
+	for (const auto pChunk : m_pChunks | std::views::values)
+		m_FrustumCuller.Add(pChunk->GetAabb());
+
+	m_FrustumCuller.Cull();
+
+	uint32_t index = 0;
+	for (const auto pChunk : m_pChunks | std::views::values)
+		pChunk->SetInFrustum(m_FrustumCuller.IsVisible(index++));
+}
+
 void World::SortChunks(const glm::ivec2& center)
 {
 	std::vector<std::pair<glm::ivec2, Chunk*>> vec(m_pChunks.begin(), m_pChunks.end());
@@ -210,4 +326,36 @@ void World::SortChunks(const glm::ivec2& center)
 	{
 		GetOwner()->MoveChildBack(chunk->GetOwner());
 	}
-}
\ No newline at end of file
+}
+
+void World::ShrinkRenderDistance()
+{
+	if (m_RenderDistance <= min_render_distance)
+		return;
+
+	--m_RenderDistance;
+
+	const auto maxOffset = m_RenderDistance * CHUNK_SIZE;
+	auto isOutside = [this, maxOffset](const glm::ivec2& pos)
+		{
+			const auto offset = glm::abs(pos - m_CurrentChunkPos);
+			return offset.x > maxOffset || offset.y > maxOffset;
+		};
+
+	std::erase_if(m_ChunksToAdd, [&isOutside](const auto& chunk) { return isOutside(std::get<0>(chunk)); });
+
+	// Their transparent buffers are freed and their mesh ranges return to the arenas once the gpu is done with them
+	for (auto it = m_pChunks.begin(); it != m_pChunks.end();)
+	{
+		if (isOutside(it->first))
+		{
+			it->second->GetOwner()->Destroy();
+			it = m_pChunks.erase(it);
+		}
+		else
+			++it;
+	}
+
+	m_IsDirty = true;
+	std::cout << "\033[1;90mWorld: over the memory budget, render distance lowered to " << m_RenderDistance << "\033[0m\n";
+}
@@ -6,12 +6,16 @@
 #include <set>
 #include <vector>
 
+#include <glm/mat4x4.hpp>
 #include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
 
 #include <real_core/Component.h>
 #include <real_core/Observer.h>
 
 #include "Player.h"
+#include "Core/MemoryTracker.h"
+#include "Misc/FrustumCuller.h"
 
 enum class EBlock;
 class Chunk;
@@ -34,6 +38,7 @@ class World final
 	: public real::Component
 	, public real::Observer<Player::Events, const glm::ivec2&>
 	, public real::Observer<Player::Events, const glm::ivec3&>
+	, public real::Observer<real::MemoryTracker::Events, const real::MemoryBudget&>
 {
 public:
 	explicit World(real::GameObject* pOwner, uint32_t seed);
@@ -51,15 +56,24 @@ public:
 
 	void HandleEvent(Player::Events, const glm::ivec2&) override;
 	void HandleEvent(Player::Events, const glm::ivec3&) override;
+	void HandleEvent(real::MemoryTracker::Events event, const real::MemoryBudget&) override;
 	void OnSubjectDestroy() override {}
 
 	Chunk* GetChunkAt(const glm::ivec2& chunkPos) const;
+	const auto& GetChunks() const { return m_pChunks; }
 	void AddBlocksForFutureChunks(const glm::ivec2& chunkPos, const std::vector<std::pair<glm::ivec3, EBlock>>& blocks);
 
+	// Walks from the section of the camera to every section it can see into, through the faces SectionVisibility connects.
+	// Every other section is marked hidden, it is either behind the camera or enclosed by opaque blocks.
+	void CullSections(const glm::vec3& cameraPosition, const glm::mat4& viewProjection);
+
 	uint32_t GetSeed() const { return m_Seed; }
 
 private:
 	static constexpr inline int render_distance{ 4 };
+	static constexpr inline int min_render_distance{ 1 };
+	// Lowered when the memory budget runs out
+	int m_RenderDistance{ render_distance };
 	uint32_t m_Seed;
 	bool m_IsDirty{ true }, m_FirstFrame{ true };
 	glm::ivec2 m_CurrentChunkPos{ 0,0 };
@@ -69,7 +83,12 @@ private:
 
 	std::deque<std::tuple<glm::ivec2, glm::ivec2, glm::ivec2>> m_ChunksToAdd{};
 
+	real::FrustumCuller m_FrustumCuller{};
+
+	// Tests the bounds of every chunk at once, the chunks read the result in their own Update
+	void CullChunks();
 	void SortChunks(const glm::ivec2& center);
+	void ShrinkRenderDistance();
 
 	//void AddingChunks();
 };
@@ -0,0 +1,108 @@
+#include "ChunkMaterial.h"
+
+#include "Content/ContentManager.h"
+#include "Core/DescriptorPoolManager.h"
+#include "Graphics/ShaderManager.h"
+#include "Material/PipelineBuilder.h"
+#include "Mesh/BaseMesh.h"
+#include "Util/GameInfo.h"
+
+void ChunkMaterial::UpdateShaderVariables(const real::DrawableComponent*)
+{
+	// The model matrices come from the transform buffer, the camera is bound at set 0
+}
+
+void ChunkMaterial::CreatePipeline()
+{
+	const auto context = real::RealEngine::GetGameContext();
+	const auto vulkan = context.vulkanContext;
+
+	auto& shaderManager = real::ShaderManager::GetInstance();
+	const auto vertShaderStageInfo = shaderManager.CreateShaderInfo(vulkan.device, real::ShaderType::vertex, "chunkindirect.vert.spv");
+	const auto fragShaderStageInfo = shaderManager.CreateShaderInfo(vulkan.device, real::ShaderType::fragment, "postexnorm.frag.spv");
+
+	CreatePipelineLayout(vulkan.device);
+
+	real::PipelineBuilder builder(vulkan.device);
+	builder.SetShaders({ vertShaderStageInfo, fragShaderStageInfo });
+	builder.SetInputType<real::PosTexNorm>();
+	builder.SetLayout(m_PipelineLayout);
+	builder.SetRenderPass(vulkan.renderPass);
+
+	m_Pipeline = builder.Build();
+}
+
+void ChunkMaterial::CreateDescriptorSetLayout()
+{
+	VkDescriptorSetLayoutBinding samplerLayoutBinding;
+	samplerLayoutBinding.binding = 0;
+	samplerLayoutBinding.descriptorCount = 1;
+	samplerLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+	samplerLayoutBinding.pImmutableSamplers = nullptr;
+	samplerLayoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+	VkDescriptorSetLayoutBinding transformLayoutBinding;
+	transformLayoutBinding.binding = 1;
+	transformLayoutBinding.descriptorCount = 1;
+	transformLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	transformLayoutBinding.pImmutableSamplers = nullptr;
+	transformLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+
+	const std::array bindings = { samplerLayoutBinding, transformLayoutBinding };
+	m_DescriptorSetLayout = real::DescriptorPoolManager::GetInstance().GetDescriptorSetLayout(bindings);
+}
+
+void ChunkMaterial::CreateDescriptorSets()
+{
+	const auto context = real::RealEngine::GetGameContext();
+	const auto texture = real::ContentManager::GetInstance().LoadTextureArray(context, Atlas::path, Atlas::tile_size, Atlas::tile_size);
+
+	// Not taken from the cache, SetTransformBuffer updates the sets of every frame on its own
+	for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+	{
+		m_DescriptorSets[i] = real::DescriptorPoolManager::GetInstance().AllocateDescriptorSet(m_DescriptorSetLayout);
+
+		VkDescriptorImageInfo imageInfo{};
+		imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		imageInfo.imageView = texture->GetTextureImageView();
+		imageInfo.sampler = texture->GetTextureSampler();
+
+		std::vector<VkWriteDescriptorSet> descriptorWrites{};
+		{
+			VkWriteDescriptorSet descriptorWrite{};
+			descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			descriptorWrite.dstSet = m_DescriptorSets[i];
+			descriptorWrite.dstBinding = 0;
+			descriptorWrite.dstArrayElement = 0;
+			descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+			descriptorWrite.descriptorCount = 1;
+			descriptorWrite.pImageInfo = &imageInfo;
+
+			descriptorWrites.push_back(descriptorWrite);
+		}
+
+		vkUpdateDescriptorSets(context.vulkanContext.device, static_cast<uint32_t>(descriptorWrites.size()),
+			descriptorWrites.data(), 0, nullptr);
+	}
+}
+
+void ChunkMaterial::SetTransformBuffer(uint32_t frame, VkBuffer buffer, VkDeviceSize size)
+{
+	const auto context = real::RealEngine::GetGameContext();
+
+	VkDescriptorBufferInfo bufferInfo{};
+	bufferInfo.buffer = buffer;
+	bufferInfo.offset = 0;
+	bufferInfo.range = size;
+
+	VkWriteDescriptorSet descriptorWrite{};
+	descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	descriptorWrite.dstSet = m_DescriptorSets[frame];
+	descriptorWrite.dstBinding = 1;
+	descriptorWrite.dstArrayElement = 0;
+	descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	descriptorWrite.descriptorCount = 1;
+	descriptorWrite.pBufferInfo = &bufferInfo;
+
+	vkUpdateDescriptorSets(context.vulkanContext.device, 1, &descriptorWrite, 0, nullptr);
+}
@@ -0,0 +1,29 @@
+#ifndef CHUNKMATERIAL_H
+#define CHUNKMATERIAL_H
+
+#include "Material/Material.h"
+#include "Util/Structs.h"
+
+// Draws every opaque chunk through an IndirectBatch, the transforms are read from a storage buffer
+class ChunkMaterial final : public real::Material<real::ObjectConstants>
+{
+public:
+	explicit ChunkMaterial() = default;
+	virtual ~ChunkMaterial() override = default;
+
+	ChunkMaterial(const ChunkMaterial&) = delete;
+	ChunkMaterial& operator=(const ChunkMaterial&) = delete;
+	ChunkMaterial(ChunkMaterial&&) = delete;
+	ChunkMaterial& operator=(ChunkMaterial&&) = delete;
+
+	const char* GetName() const override { return "ChunkMaterial"; }
+	void UpdateShaderVariables(const real::DrawableComponent* mesh) override;
+	void SetTransformBuffer(uint32_t frame, VkBuffer buffer, VkDeviceSize size);
+
+protected:
+	void CreatePipeline() override;
+	void CreateDescriptorSetLayout() override;
+	void CreateDescriptorSets() override;
+};
+
+#endif // CHUNKMATERIAL_H
\ No newline at end of file
@@ -4,7 +4,7 @@
 #include "Material/Material.h"
 #include "Util/Structs.h"
 
-class DiffuseMaterial final : public real::Material<real::UniformBufferObject>
+class DiffuseMaterial final : public real::Material<real::ObjectConstants>
 {
 public:
 	explicit DiffuseMaterial() = default;
@@ -15,12 +15,13 @@ public:
 	DiffuseMaterial(DiffuseMaterial&&) = delete;
 	DiffuseMaterial& operator=(DiffuseMaterial&&) = delete;
 
-	void UpdateShaderVariables(const real::DrawableComponent* mesh, uint32_t reference) override;
+	const char* GetName() const override { return "DiffuseMaterial"; }
+	void UpdateShaderVariables(const real::DrawableComponent* mesh) override;
 
 protected:
 	void CreatePipeline() override;
 	void CreateDescriptorSetLayout() override;
-	void CreateDescriptorSets(uint32_t reference, VkDescriptorSetLayout layout) override;
+	void CreateDescriptorSets() override;
 };
 
 #endif // DIFFUSEMATERIAL_H
\ No newline at end of file
@@ -2,17 +2,17 @@
 
 #include "Content/ContentManager.h"
 #include "Core/DescriptorPoolManager.h"
+#include "Graphics/RenderPass.h"
 #include "Graphics/ShaderManager.h"
-#include "Misc/CameraManager.h"
-#include "Misc/Camera.h"
+#include "Material/PipelineBuilder.h"
 #include "Mesh/BaseMesh.h"
 
-void GuiMaterial::UpdateShaderVariables(const real::DrawableComponent* mesh, uint32_t reference)
+void GuiMaterial::UpdateShaderVariables(const real::DrawableComponent* mesh)
 {
-	WorldMatrix ubo{};
-	ubo.model = mesh->GetOwner()->GetTransform()->GetWorldMatrix();
+	WorldMatrix constants{};
+	constants.model = mesh->GetOwner()->GetTransform()->GetWorldMatrix();
 
-	UpdateUniformBuffer(reference, ubo);
+	Push(constants);
 }
 
 void GuiMaterial::CreatePipeline()
@@ -20,197 +20,51 @@ void GuiMaterial::CreatePipeline()
 	const auto context = real::RealEngine::GetGameContext();
 	const auto vulkan = context.vulkanContext;
 
-	// Create Shaders
-	auto vertShaderStageInfo = real::ShaderManager::GetInstance().CreateShaderInfo(vulkan.device, real::ShaderType::vertex, "gui.vert.spv");
-	auto fragShaderStageInfo = real::ShaderManager::GetInstance().CreateShaderInfo(vulkan.device, real::ShaderType::fragment, "gui.frag.spv");
+	auto& shaderManager = real::ShaderManager::GetInstance();
+	const auto vertShaderStageInfo = shaderManager.CreateShaderInfo(vulkan.device, real::ShaderType::vertex, "gui.vert.spv");
+	const auto fragShaderStageInfo = shaderManager.CreateShaderInfo(vulkan.device, real::ShaderType::fragment, "gui.frag.spv");
 
-	std::vector shaderStages = { vertShaderStageInfo, fragShaderStageInfo };
+	CreatePipelineLayout(vulkan.device);
 
-	const auto assemblyStateInfo = real::CreateInputAssemblyStateInfo(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST);
+	real::PipelineBuilder builder(vulkan.device);
+	builder.SetShaders({ vertShaderStageInfo, fragShaderStageInfo });
+	builder.SetInputType<PosTex>();
+	builder.SetColorBlend(real::EBlendMode::alpha);
+	builder.SetDepth(false, true);
+	builder.SetLayout(m_PipelineLayout);
+	// With order independent transparency the overlay is drawn after the composite
+	builder.SetRenderPass(vulkan.renderPass, context.weightedBlendedOit ? real::RenderPass::composite_subpass : real::RenderPass::opaque_subpass);
 
-	VkPipelineVertexInputStateCreateInfo vertexInput{};
-	vertexInput.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-
-	auto attributeDescriptions = PosTex::GetAttributeDescriptions();
-	vertexInput.pVertexAttributeDescriptions = attributeDescriptions.data();
-	vertexInput.vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescriptions.size());
-
-	auto bindingDescriptions = PosTex::GetBindingDescription();
-	vertexInput.pVertexBindingDescriptions = bindingDescriptions.data();
-	vertexInput.vertexBindingDescriptionCount = static_cast<uint32_t>(bindingDescriptions.size());
-
-	VkPipelineViewportStateCreateInfo viewportState{};
-	viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
-	viewportState.viewportCount = 1;
-	viewportState.scissorCount = 1;
-
-	VkPipelineRasterizationStateCreateInfo rasterizer{};
-	rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
-	rasterizer.depthClampEnable = VK_FALSE;
-	rasterizer.rasterizerDiscardEnable = VK_FALSE;
-	rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
-	rasterizer.lineWidth = 1.0f;
-	rasterizer.cullMode = VK_CULL_MODE_BACK_BIT;
-	rasterizer.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
-	rasterizer.depthBiasEnable = VK_FALSE;
-
-	VkPipelineMultisampleStateCreateInfo multisampling{};
-	multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
-	multisampling.sampleShadingEnable = VK_FALSE;
-	multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
-
-	VkPipelineColorBlendAttachmentState colorBlendAttachment{};
-	colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
-	colorBlendAttachment.blendEnable = VK_TRUE;
-	colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA; // Use source alpha
-	colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA; // 1 - source alpha
-	colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
-	colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
-	colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
-	colorBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
-
-	VkPipelineColorBlendStateCreateInfo colorBlending{};
-	colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
-	colorBlending.logicOpEnable = VK_FALSE;
-	colorBlending.logicOp = VK_LOGIC_OP_COPY;
-	colorBlending.attachmentCount = 1;
-	colorBlending.pAttachments = &colorBlendAttachment;
-	colorBlending.blendConstants[0] = 0.0f;
-	colorBlending.blendConstants[1] = 0.0f;
-	colorBlending.blendConstants[2] = 0.0f;
-	colorBlending.blendConstants[3] = 0.0f;
-
-	VkPipelineDepthStencilStateCreateInfo depthStencil{};
-	depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
-	depthStencil.depthTestEnable = VK_FALSE;
-	depthStencil.depthWriteEnable = VK_TRUE;
-	depthStencil.depthCompareOp = VK_COMPARE_OP_LESS;
-	depthStencil.depthBoundsTestEnable = VK_FALSE;
-
-	std::vector<VkDynamicState> dynamicStates = {
-		VK_DYNAMIC_STATE_VIEWPORT,
-		VK_DYNAMIC_STATE_SCISSOR
-	};
-	VkPipelineDynamicStateCreateInfo dynamicState{};
-	dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
-	dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
-	dynamicState.pDynamicStates = dynamicStates.data();
-
-	VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
-	pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-	pipelineLayoutInfo.setLayoutCount = 1;
-	pipelineLayoutInfo.pSetLayouts = &m_DescriptorSetLayout;
-	pipelineLayoutInfo.pushConstantRangeCount = 0;
-
-	if (vkCreatePipelineLayout(vulkan.device, &pipelineLayoutInfo, nullptr, &m_PipelineLayout) != VK_SUCCESS) {
-		throw std::runtime_error("failed to create pipeline layout!");
-	}
-
-	VkGraphicsPipelineCreateInfo pipelineInfo{};
-	pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-	pipelineInfo.stageCount = static_cast<uint32_t>(shaderStages.size());
-	pipelineInfo.pStages = shaderStages.data();
-	pipelineInfo.pVertexInputState = &vertexInput;
-	pipelineInfo.pInputAssemblyState = &assemblyStateInfo;
-	pipelineInfo.pViewportState = &viewportState;
-	pipelineInfo.pRasterizationState = &rasterizer;
-	pipelineInfo.pMultisampleState = &multisampling;
-	pipelineInfo.pColorBlendState = &colorBlending;
-	pipelineInfo.pDynamicState = &dynamicState;
-	pipelineInfo.pDepthStencilState = &depthStencil;
-	pipelineInfo.layout = m_PipelineLayout;
-	pipelineInfo.renderPass = vulkan.renderPass;
-	pipelineInfo.subpass = 0;
-	pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
-
-	const auto result = vkCreateGraphicsPipelines(vulkan.device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_Pipeline);
-	if (result != VK_SUCCESS)
-	{
-		throw std::runtime_error("failed to create graphics pipeline!");
-	}
+	m_Pipeline = builder.Build();
 }
 
 void GuiMaterial::CreateDescriptorSetLayout()
 {
-	const auto context = real::RealEngine::GetGameContext();
-
-	VkDescriptorSetLayoutBinding uboLayoutBinding;
-	uboLayoutBinding.binding = 0;
-	uboLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-	uboLayoutBinding.descriptorCount = 1;
-	uboLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
-	uboLayoutBinding.pImmutableSamplers = nullptr;
-
 	VkDescriptorSetLayoutBinding samplerLayoutBinding;
-	samplerLayoutBinding.binding = 1;
+	samplerLayoutBinding.binding = 0;
 	samplerLayoutBinding.descriptorCount = 1;
 	samplerLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
 	samplerLayoutBinding.pImmutableSamplers = nullptr;
 	samplerLayoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
 
-	const std::array bindings = { uboLayoutBinding, samplerLayoutBinding };
-	VkDescriptorSetLayoutCreateInfo layoutInfo{};
-	layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-	layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
-	layoutInfo.pBindings = bindings.data();
-
-	if (vkCreateDescriptorSetLayout(context.vulkanContext.device, &layoutInfo, nullptr, &m_DescriptorSetLayout) != VK_SUCCESS)
-	{
-		throw std::runtime_error("failed to create descriptor set layout!");
-	}
+	const std::array bindings = { samplerLayoutBinding };
+	m_DescriptorSetLayout = real::DescriptorPoolManager::GetInstance().GetDescriptorSetLayout(bindings);
 }
 
-void GuiMaterial::CreateDescriptorSets(uint32_t reference, VkDescriptorSetLayout layout)
+void GuiMaterial::CreateDescriptorSets()
 {
 	const auto context = real::RealEngine::GetGameContext();
 	const auto texture = real::ContentManager::GetInstance().LoadTexture(context, "Resources/textures/gui_atlas.png");
 	//const auto texture = real::ContentManager::GetInstance().LoadTexture(context, "Resources/textures/crosshair.png");
 
-	for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
-	{
-		m_DescriptorSets[reference][i] = real::DescriptorPoolManager::GetInstance().AllocateDescriptorSet(m_DescriptorSetLayout);
-
-		VkDescriptorBufferInfo bufferInfo{};
-		bufferInfo.buffer = m_UniformBuffers[reference][i];
-		bufferInfo.offset = 0;
-		bufferInfo.range = sizeof(WorldMatrix);
-
-		VkDescriptorImageInfo imageInfo{};
-		imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-		imageInfo.imageView = texture->GetTextureImageView();
-		imageInfo.sampler = texture->GetTextureSampler();
-
-		std::vector<VkWriteDescriptorSet> descriptorWrites{};
-		{
-			VkWriteDescriptorSet descriptorWrite{};
-			descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-			descriptorWrite.dstSet = m_DescriptorSets[reference][i];
-			descriptorWrite.dstBinding = 0;
-			descriptorWrite.dstArrayElement = 0;
-			descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-			descriptorWrite.descriptorCount = 1;
-			descriptorWrite.pBufferInfo = &bufferInfo;
-
-			descriptorWrites.push_back(descriptorWrite);
-		}
-
-		{
-			VkWriteDescriptorSet descriptorWrite{};
-			descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-			descriptorWrite.dstSet = m_DescriptorSets[reference][i];
-			descriptorWrite.dstBinding = 1;
-			descriptorWrite.dstArrayElement = 0;
-			descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-			descriptorWrite.descriptorCount = 1;
-			descriptorWrite.pImageInfo = &imageInfo;
-
-			descriptorWrites.push_back(descriptorWrite);
-		}
-
-		if (descriptorWrites.empty())
-			return;
+	real::DescriptorResource resource{};
+	resource.binding = 0;
+	resource.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+	resource.imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	resource.imageInfo.imageView = texture->GetTextureImageView();
+	resource.imageInfo.sampler = texture->GetTextureSampler();
 
-		vkUpdateDescriptorSets(context.vulkanContext.device, static_cast<uint32_t>(descriptorWrites.size()),
-			descriptorWrites.data(), 0, nullptr);
-	}
+	// The texture never changes, every frame binds the same set
+	const std::array resources = { resource };
+	m_DescriptorSets.fill(real::DescriptorPoolManager::GetInstance().GetDescriptorSet(m_DescriptorSetLayout, resources));
 }
\ No newline at end of file
@@ -15,12 +15,13 @@ public:
 	GuiMaterial(GuiMaterial&&) = delete;
 	GuiMaterial& operator=(GuiMaterial&&) = delete;
 
-	void UpdateShaderVariables(const real::DrawableComponent* mesh, uint32_t reference) override;
+	const char* GetName() const override { return "GuiMaterial"; }
+	void UpdateShaderVariables(const real::DrawableComponent* mesh) override;
 
 protected:
 	void CreatePipeline() override;
 	void CreateDescriptorSetLayout() override;
-	void CreateDescriptorSets(uint32_t reference, VkDescriptorSetLayout layout) override;
+	void CreateDescriptorSets() override;
 };
 
 #endif // GUIMATERIAL_H
\ No newline at end of file
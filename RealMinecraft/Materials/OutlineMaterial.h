@@ -4,7 +4,7 @@
 #include "Material/Material.h"
 #include "Util/Structs.h"
 
-class OutlineMaterial final : public real::Material<real::UniformBufferObject>
+class OutlineMaterial final : public real::Material<real::ObjectConstants>
 {
 public:
 	explicit OutlineMaterial() = default;
@@ -15,12 +15,11 @@ public:
 	OutlineMaterial(OutlineMaterial&&) = delete;
 	OutlineMaterial& operator=(OutlineMaterial&&) = delete;
 
-	void UpdateShaderVariables(const real::DrawableComponent* mesh, uint32_t reference) override;
+	const char* GetName() const override { return "OutlineMaterial"; }
+	void UpdateShaderVariables(const real::DrawableComponent* mesh) override;
 
 protected:
 	void CreatePipeline() override;
-	void CreateDescriptorSetLayout() override;
-	void CreateDescriptorSets(uint32_t reference, VkDescriptorSetLayout layout) override;
 };
 
 #endif // OUTLINEMATERIAL_H
\ No newline at end of file
@@ -4,7 +4,7 @@
 #include "Material/Material.h"
 #include "Util/Structs.h"
 
-class TransparentMaterial final : public real::Material<real::UniformBufferObject>
+class TransparentMaterial final : public real::Material<real::ObjectConstants>
 {
 public:
 	explicit TransparentMaterial() = default;
@@ -15,12 +15,13 @@ public:
 	TransparentMaterial(TransparentMaterial&&) = delete;
 	TransparentMaterial& operator=(TransparentMaterial&&) = delete;
 
-	void UpdateShaderVariables(const real::DrawableComponent* mesh, uint32_t reference) override;
+	const char* GetName() const override { return "TransparentMaterial"; }
+	void UpdateShaderVariables(const real::DrawableComponent* mesh) override;
 
 protected:
 	void CreatePipeline() override;
 	void CreateDescriptorSetLayout() override;
-	void CreateDescriptorSets(uint32_t reference, VkDescriptorSetLayout layout) override;
+	void CreateDescriptorSets() override;
 };
 
 #endif // TRANSPARENTMATERIAL_H
\ No newline at end of file
@@ -4,7 +4,7 @@
 #include "Material/Material.h"
 #include "Util/Structs.h"
 
-class TranspriteMaterial final : public real::Material<real::UniformBufferObject>
+class TranspriteMaterial final : public real::Material<real::ObjectConstants>
 {
 public:
 	explicit TranspriteMaterial() = default;
@@ -15,12 +15,13 @@ public:
 	TranspriteMaterial(TranspriteMaterial&&) = delete;
 	TranspriteMaterial& operator=(TranspriteMaterial&&) = delete;
 
-	void UpdateShaderVariables(const real::DrawableComponent* mesh, uint32_t reference) override;
+	const char* GetName() const override { return "TranspriteMaterial"; }
+	void UpdateShaderVariables(const real::DrawableComponent* mesh) override;
 
 protected:
 	void CreatePipeline() override;
 	void CreateDescriptorSetLayout() override;
-	void CreateDescriptorSets(uint32_t reference, VkDescriptorSetLayout layout) override;
+	void CreateDescriptorSets() override;
 };
 
 #endif // TRANSPRITEMATERIAL_H
\ No newline at end of file
@@ -4,10 +4,10 @@
 #include "Material/Material.h"
 #include "Util/GameStructs.h"
 
-class WaterMaterial final : public real::Material<WVP_Time>
+class WaterMaterial final : public real::Material<ModelTime>
 {
 public:
-	explicit WaterMaterial();
+	explicit WaterMaterial() = default;
 	virtual ~WaterMaterial() override = default;
 
 	WaterMaterial(const WaterMaterial&) = delete;
@@ -15,16 +15,16 @@ public:
 	WaterMaterial(WaterMaterial&&) = delete;
 	WaterMaterial& operator=(WaterMaterial&&) = delete;
 
-	void UpdateShaderVariables(const real::DrawableComponent* mesh, uint32_t reference) override;
+	const char* GetName() const override { return "WaterMaterial"; }
+	void UpdateShaderVariables(const real::DrawableComponent* mesh) override;
 
 protected:
 	void CreatePipeline() override;
 	void CreateDescriptorSetLayout() override;
-	void CreateDescriptorSets(uint32_t reference, VkDescriptorSetLayout layout) override;
+	void CreateDescriptorSets() override;
 
 private:
 	float m_MaxTime{ 1.6f }, m_AmountOfSprites{ 32.f }, m_Interval{ 0.05f };
-	static inline uint32_t m_TimerId{ 0 };
 };
 
 #endif // WATERMATERIAL_H
\ No newline at end of file
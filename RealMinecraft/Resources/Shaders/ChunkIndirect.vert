@@ -0,0 +1,33 @@
+#version 450
+
+layout(set = 0, binding = 0) uniform CameraUbo
+{
+    mat4 view;
+    mat4 proj;
+} camera;
+
+// Indexed by the firstInstance of each indirect draw
+layout(std430, set = 1, binding = 1) readonly buffer TransformBuffer
+{
+    mat4 models[];
+} transforms;
+
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec2 inTexCoord;
+layout(location = 2) in vec3 inNormal;
+
+layout(location = 0) out vec2 fragTexCoord;
+layout(location = 1) out vec3 fragNormal;
+layout(location = 2) flat out float fragLayer;
+
+void main() 
+{
+    const mat4 model = transforms.models[gl_InstanceIndex];
+
+    gl_Position = camera.proj * camera.view * model * vec4(inPosition, 1.0);
+    vec4 tNormal = model * vec4(inNormal, 0);
+    fragNormal = normalize(tNormal.xyz);
+    // The layer of the block atlas is packed in u, see BlockParser::GetTexCoord
+    fragLayer = floor(inTexCoord.x * 0.5);
+    fragTexCoord = vec2(inTexCoord.x - fragLayer * 2.0, inTexCoord.y);
+}
\ No newline at end of file
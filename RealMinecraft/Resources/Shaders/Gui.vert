@@ -1,9 +1,9 @@
 #version 450
 
-layout(binding = 0) uniform UniformBufferObject 
+layout(push_constant) uniform ObjectConstants
 {
     mat4 model;
-} ubo;
+} object;
 
 layout(location = 0) in vec3 inPosition;
 layout(location = 1) in vec2 inTexCoord;
@@ -12,6 +12,6 @@ layout(location = 0) out vec2 fragTexCoord;
 
 void main() 
 {
-    gl_Position = ubo.model * vec4(inPosition, 1.0);
+    gl_Position = object.model * vec4(inPosition, 1.0);
     fragTexCoord = inTexCoord;
 }
\ No newline at end of file
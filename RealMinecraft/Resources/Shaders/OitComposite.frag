@@ -0,0 +1,24 @@
+#version 450
+
+layout(input_attachment_index = 0, binding = 0) uniform subpassInput accumulation;
+layout(input_attachment_index = 1, binding = 1) uniform subpassInput revealage;
+
+layout(location = 0) out vec4 outColor;
+
+void main()
+{
+    const float reveal = subpassLoad(revealage).r;
+
+    // Nothing transparent was drawn on this pixel
+    if (reveal >= 0.9999)
+        discard;
+
+    vec4 accum = subpassLoad(accumulation);
+
+    // Prevent overflow of the half precision accumulation
+    if (isinf(max(max(abs(accum.r), abs(accum.g)), abs(accum.b))))
+        accum.rgb = vec3(accum.a);
+
+    const vec3 averageColor = accum.rgb / max(accum.a, 0.00001);
+    outColor = vec4(averageColor, 1.0 - reveal);
+}
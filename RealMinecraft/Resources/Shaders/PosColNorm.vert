@@ -1,11 +1,15 @@
 #version 450
 
-layout(binding = 0) uniform UniformBufferObject 
+layout(set = 0, binding = 0) uniform CameraUbo
 {
-    mat4 model;
     mat4 view;
     mat4 proj;
-} ubo;
+} camera;
+
+layout(push_constant) uniform ObjectConstants
+{
+    mat4 model;
+} object;
 
 layout(location = 0) in vec3 inPosition;
 layout(location = 1) in vec3 inColor;
@@ -16,8 +20,8 @@ layout(location = 1) out vec3 fragNormal;
 
 void main()
 {
-    gl_Position = ubo.proj * ubo.view * ubo.model * vec4(inPosition, 1.0);
-    vec4 tNormal = ubo.model * vec4(inNormal, 0);
+    gl_Position = camera.proj * camera.view * object.model * vec4(inPosition, 1.0);
+    vec4 tNormal = object.model * vec4(inNormal, 0);
     fragNormal = normalize(tNormal.xyz);
     fragColor = inColor;
 }
\ No newline at end of file
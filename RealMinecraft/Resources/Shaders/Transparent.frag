@@ -2,10 +2,11 @@
 
 layout(location = 0) in vec2 fragTexCoord;
 layout(location = 1) in vec3 fragNormal;
+layout(location = 2) flat in float fragLayer;
 
 layout(location = 0) out vec4 outColor;
 
-layout(binding = 1) uniform sampler2D texSampler;
+layout(set = 1, binding = 0) uniform sampler2DArray texSampler;
 
 void main() 
 {
@@ -16,7 +17,7 @@ void main()
     float diffuseFactor = max(dot(fragNormal, lightDirection), 0.25);
 
     // Calculate the final color using the diffuse factor and the light and object colors
-    vec4 texColor = texture(texSampler, fragTexCoord);
+    vec4 texColor = texture(texSampler, vec3(fragTexCoord, fragLayer));
     vec3 diffuseColor = lightColor * vec3(texColor) * diffuseFactor;
 
     // Output the final color
@@ -1,11 +1,15 @@
 #version 450
 
-layout(binding = 0) uniform UniformBufferObject
+layout(set = 0, binding = 0) uniform CameraUbo
 {
-    mat4 model;
     mat4 view;
     mat4 proj;
-} ubo;
+} camera;
+
+layout(push_constant) uniform ObjectConstants
+{
+    mat4 model;
+} object;
 
 layout(location = 0) in vec3 inPosition;
 layout(location = 1) in vec2 inTexCoord;
@@ -13,10 +17,13 @@ layout(location = 2) in vec3 inNormal;
 
 layout(location = 0) out vec2 fragTexCoord;
 layout(location = 1) out vec3 fragNormal;
+layout(location = 2) flat out float fragLayer;
 
 void main() {
-    gl_Position = ubo.proj * ubo.view * ubo.model * vec4(inPosition, 1.0);
-    vec4 tNormal = ubo.model * vec4(inNormal, 0);
+    gl_Position = camera.proj * camera.view * object.model * vec4(inPosition, 1.0);
+    vec4 tNormal = object.model * vec4(inNormal, 0);
     fragNormal = normalize(tNormal.xyz);
-    fragTexCoord = inTexCoord;
+    // The layer of the block atlas is packed in u, see BlockParser::GetTexCoord
+    fragLayer = floor(inTexCoord.x * 0.5);
+    fragTexCoord = vec2(inTexCoord.x - fragLayer * 2.0, inTexCoord.y);
 }
\ No newline at end of file
@@ -0,0 +1,27 @@
+#version 450
+
+layout(location = 0) in vec2 fragTexCoord;
+layout(location = 1) in vec3 fragNormal;
+
+layout(location = 0) out vec4 outAccumulation;
+layout(location = 1) out float outRevealage;
+
+layout(set = 1, binding = 0) uniform sampler2D texSampler;
+
+void main() 
+{
+    const vec3 lightDirection = normalize(vec3(0.736, 0.626, -0.261));
+    const vec3 lightColor = vec3(1,1,1);
+
+    // Calculate the diffuse factor using Lambert's Law
+    float diffuseFactor = max(dot(fragNormal, lightDirection), 0.25);
+
+    vec3 diffuseColor = lightColor * vec3(texture(texSampler, fragTexCoord)) * diffuseFactor;
+    const float alpha = 0.95;
+
+    // Weighted blended OIT (McGuire & Bavoil), closer fragments get a larger weight
+    float weight = clamp(pow(min(1.0, alpha * 10.0) + 0.01, 3.0) * 1e8 * pow(1.0 - gl_FragCoord.z * 0.9, 3.0), 1e-2, 3e3);
+
+    outAccumulation = vec4(diffuseColor * alpha, alpha) * weight;
+    outRevealage = alpha;
+}
@@ -69,7 +69,7 @@ void TestScene::Load()
 		meshInfo.indexCapacity = static_cast<uint32_t>(indices.size());
 		meshInfo.vertexCapacity = static_cast<uint32_t>(vertices.size());
 		meshInfo.usesUbo = true;
-		const auto mesh = block.AddComponent<MeshIndexed<PosColNorm, UniformBufferObject>>(meshInfo);
+		const auto mesh = block.AddComponent<MeshIndexed<PosColNorm, ObjectConstants>>(meshInfo);
 
 		mesh->AddIndices(indices);
 		mesh->AddVertices(vertices);
@@ -89,6 +89,7 @@ void TestScene::Load()
 		meshInfo.indexCapacity = static_cast<uint32_t>(600);
 		meshInfo.vertexCapacity = static_cast<uint32_t>(400);
 		meshInfo.usesUbo = true;
+		meshInfo.renderPass = RenderPassType::overlay;
 		const auto mesh = gui.AddComponent<MeshIndexed<PosTex, WorldMatrix>>(meshInfo);
 		mesh->Init(context);
 		mesh->SetMaterial(MaterialManager::GetInstance().GetMaterial<GuiMaterial>());
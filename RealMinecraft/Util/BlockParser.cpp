@@ -208,17 +208,15 @@ std::vector<glm::vec3> BlockParser::GetVertexPositionsCross(const BlockElement&
 
 glm::vec2 BlockParser::GetTexCoord(int atlasId, int vertexId, EDirection dir, BlockModel model) const
 {
-    const float posX = static_cast<float>(atlasId * m_TextureSize % m_AtlasSizeX) / static_cast<float>(m_AtlasSizeX);
-    const float posY = static_cast<float>(atlasId / m_AmountOfTexY) / static_cast<float>(m_AmountOfTexY);
-
     const auto uv = model.elements.front().faces[dir].uv;
 
 	const auto v = std::vector({ glm::vec2{ uv.x,uv.w }, glm::vec2{ uv.z,uv.w }, glm::vec2{ uv.z,uv.y }, glm::vec2{ uv.x,uv.y } });
     auto texCoord = v[vertexId];
-    texCoord /= glm::vec2{ m_AmountOfTexX, m_AmountOfTexY };
     texCoord /= m_TextureSize;
 
-    return { posX + texCoord.x, posY + texCoord.y };
+    // The atlas is sampled as a texture array with a layer per tile, in the same order as the atlas ids.
+    // The layer is packed in u, the vertex shaders unpack it as layer = floor(u / 2) since the uv of the tile itself lies in [0, 1].
+    return { texCoord.x + static_cast<float>(atlasId * 2), texCoord.y };
 }
 
 void BlockParser::ParseBlock(EBlock block)
@@ -4,7 +4,7 @@
 #include <cstdint>
 #include <filesystem>
 
-#include <real_core/GameTime.h>
+#include <real_core/CpuProfiler.h>
 
 ChunkParser::~ChunkParser()
 {
@@ -33,7 +33,7 @@ void ChunkParser::Init(uint32_t seed)
 
 void ChunkParser::LoadChunk(const glm::ivec2& chunkPos, block_array& blocks, int& highestY, int& lowestY) const
 {
-    const auto id = real::GameTime::GetInstance().StartTimer();
+    REAL_PROFILE_ZONE("Load chunk");
 
 	const auto filePath = m_Path + CreateFileName(chunkPos);
     std::ifstream file(filePath, std::ios_base::in | std::ios_base::binary);
@@ -62,14 +62,11 @@ void ChunkParser::LoadChunk(const glm::ivec2& chunkPos, block_array& blocks, int
     }
 
     file.close();
-
-    const auto time = real::GameTime::GetInstance().EndTimer(id);
-    std::cout << "time to load chunk : " << std::to_string(time) << '\n';
 }
 
 void ChunkParser::SaveBlock(const glm::ivec2& chunkPos, const glm::ivec3& blockPos, EBlock block)
 {
-    const auto id = real::GameTime::GetInstance().StartTimer();
+    REAL_PROFILE_ZONE("Save block");
 
     if (m_OpenFile.first != chunkPos)
     {
@@ -94,9 +91,6 @@ void ChunkParser::SaveBlock(const glm::ivec2& chunkPos, const glm::ivec3& blockP
 
     m_OpenFile.second.write(reinterpret_cast<const char*>(&pos), sizeof(pos));
     m_OpenFile.second.write(reinterpret_cast<const char*>(&type), sizeof(type));
-
-    const auto time = real::GameTime::GetInstance().EndTimer<std::chrono::microseconds>(id);
-    std::cout << "time to save block to chunk file : " << std::to_string(time) << " microseconds\n";
 }
 
 bool ChunkParser::HasChunkData(const glm::ivec2& chunkPos) const
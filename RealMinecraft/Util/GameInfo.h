@@ -6,6 +6,7 @@
 struct Materials
 {
 	static inline uint8_t diffuseMaterial;
+	static inline uint8_t chunkMaterial;
 	static inline uint8_t waterMaterial;
 	static inline uint8_t transparentMaterial;
 	static inline uint8_t transpriteMaterial;
@@ -13,4 +14,11 @@ struct Materials
 	static inline uint8_t guiMaterial;
 };
 
+// Every tile of the block atlas is a layer of a texture array, see BlockParser::GetTexCoord
+struct Atlas
+{
+	static constexpr auto path = "Resources/textures/atlas.png";
+	static constexpr uint32_t tile_size = 16;
+};
+
 #endif // GAMEINFO_H
\ No newline at end of file
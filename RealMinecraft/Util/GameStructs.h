@@ -8,11 +8,9 @@
 #include <glm/vec3.hpp>
 #include <glm/vec2.hpp>
 
-struct WVP_Time
+struct ModelTime
 {
 	glm::mat4 model;
-	glm::mat4 view;
-	glm::mat4 proj;
 	int index;
 };
 
@@ -3,6 +3,9 @@
 
 #define CHUNK_SIZE 16
 #define CHUNK_HEIGHT 256
+// Chunks are split into cubes of this size for the visibility graph
+#define SECTION_SIZE 16
+#define SECTION_COUNT (CHUNK_HEIGHT / SECTION_SIZE)
 
 //#define WATER_LEVEL 66
 #define WATER_LEVEL 60
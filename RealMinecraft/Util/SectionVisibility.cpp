@@ -0,0 +1,112 @@
+#include "SectionVisibility.h"
+
+#include <vector>
+
+namespace
+{
+	uint8_t ToBit(EDirection direction)
+	{
+		return static_cast<uint8_t>(1 << static_cast<int>(direction));
+	}
+
+	// The faces of the section the block touches
+	uint8_t GetFaces(int x, int y, int z)
+	{
+		uint8_t faces = 0;
+		if (x == 0) faces |= ToBit(EDirection::west);
+		if (x == SECTION_SIZE - 1) faces |= ToBit(EDirection::east);
+		if (z == 0) faces |= ToBit(EDirection::north);
+		if (z == SECTION_SIZE - 1) faces |= ToBit(EDirection::south);
+		if (y == 0) faces |= ToBit(EDirection::down);
+		if (y == SECTION_SIZE - 1) faces |= ToBit(EDirection::up);
+		return faces;
+	}
+}
+
+void SectionVisibility::Calculate(const opaque_blocks& opaqueBlocks)
+{
+	m_Connections = 0;
+
+	// Every block that is not opaque is visited once, by the flood fill of the cave it is in
+	opaque_blocks visited = opaqueBlocks;
+	std::vector<int> stack;
+	stack.reserve(visited.size());
+
+	for (int start = 0; start < static_cast<int>(visited.size()); ++start)
+	{
+		if (visited[start])
+			continue;
+
+		uint8_t faces = 0;
+		visited[start] = true;
+		stack.push_back(start);
+
+		while (stack.empty() == false)
+		{
+			const int index = stack.back();
+			stack.pop_back();
+
+			const int x = index % SECTION_SIZE;
+			const int z = index / SECTION_SIZE % SECTION_SIZE;
+			const int y = index / (SECTION_SIZE * SECTION_SIZE);
+			faces |= GetFaces(x, y, z);
+
+			const auto visit = [&](int neighbourX, int neighbourY, int neighbourZ)
+				{
+					const int neighbour = GetBlockIndex(neighbourX, neighbourY, neighbourZ);
+					if (visited[neighbour])
+						return;
+
+					visited[neighbour] = true;
+					stack.push_back(neighbour);
+				};
+
+			if (x > 0) visit(x - 1, y, z);
+			if (x < SECTION_SIZE - 1) visit(x + 1, y, z);
+			if (y > 0) visit(x, y - 1, z);
+			if (y < SECTION_SIZE - 1) visit(x, y + 1, z);
+			if (z > 0) visit(x, y, z - 1);
+			if (z < SECTION_SIZE - 1) visit(x, y, z + 1);
+		}
+
+		Connect(faces);
+
+		// Nothing left to find
+		if (m_Connections == all_connected)
+			return;
+	}
+}
+
+bool SectionVisibility::IsConnected(EDirection from, EDirection to) const
+{
+	return (m_Connections >> (static_cast<int>(from) * direction_count + static_cast<int>(to))) & 1;
+}
+
+EDirection SectionVisibility::GetOpposite(EDirection direction)
+{
+	switch (direction)
+	{
+	case EDirection::north:	return EDirection::south;
+	case EDirection::east:	return EDirection::west;
+	case EDirection::south:	return EDirection::north;
+	case EDirection::west:	return EDirection::east;
+	case EDirection::up:	return EDirection::down;
+	case EDirection::down:	return EDirection::up;
+	default:				return direction;
+	}
+}
+
+void SectionVisibility::Connect(uint8_t faces)
+{
+	for (int from = 0; from < direction_count; ++from)
+	{
+		if ((faces >> from & 1) == 0)
+			continue;
+
+		for (int to = 0; to < direction_count; ++to)
+		{
+			if (faces >> to & 1)
+				m_Connections |= uint64_t{ 1 } << (from * direction_count + to);
+		}
+	}
+}
@@ -0,0 +1,36 @@
+#ifndef SECTIONVISIBILITY_H
+#define SECTIONVISIBILITY_H
+
+#include <bitset>
+#include <cstdint>
+
+#include "Enumerations.h"
+#include "Macros.h"
+
+// Which faces of a section can see each other through the blocks that are not opaque.
+// Filled in when the chunk is meshed, World::CullSections only walks from one face to another when they are connected.
+class SectionVisibility final
+{
+public:
+	using opaque_blocks = std::bitset<SECTION_SIZE * SECTION_SIZE * SECTION_SIZE>;
+
+	// Indexed with GetBlockIndex
+	void Calculate(const opaque_blocks& opaqueBlocks);
+	void ConnectAll() { m_Connections = all_connected; }
+
+	bool IsConnected(EDirection from, EDirection to) const;
+
+	static int GetBlockIndex(int x, int y, int z) { return (y * SECTION_SIZE + z) * SECTION_SIZE + x; }
+	static EDirection GetOpposite(EDirection direction);
+
+private:
+	static constexpr int direction_count = static_cast<int>(EDirection::amountOfDirections);
+	static constexpr uint64_t all_connected = (uint64_t{ 1 } << (direction_count * direction_count)) - 1;
+
+	// One bit for every pair of faces
+	uint64_t m_Connections{ all_connected };
+
+	void Connect(uint8_t faces);
+};
+
+#endif // SECTIONVISIBILITY_H
@@ -1,5 +1,10 @@
 #include <RealEngine.h>
 
+#include <algorithm>
+#include <cctype>
+#include <string>
+#include <thread>
+
 #define SDL_MAIN_HANDLED
 #include <SDL.h>
 
@@ -7,6 +12,7 @@
 
 #include <Material/MaterialManager.h>
 
+#include "Materials/ChunkMaterial.h"
 #include "Materials/DiffuseMaterial.h"
 #include "Materials/GuiMaterial.h"
 #include "Materials/OutlineMaterial.h"
@@ -27,6 +33,7 @@ void Load()
 
 	auto& materialManager = MaterialManager::GetInstance();
 	Materials::diffuseMaterial = materialManager.AddMaterial<DiffuseMaterial>(context).first;
+	Materials::chunkMaterial = materialManager.AddMaterial<ChunkMaterial>(context).first;
 	Materials::waterMaterial = materialManager.AddMaterial<WaterMaterial>(context).first;
 	Materials::transparentMaterial = materialManager.AddMaterial<TransparentMaterial>(context).first;
 	Materials::transpriteMaterial = materialManager.AddMaterial<TranspriteMaterial>(context).first;
@@ -39,12 +46,56 @@ void Load()
 	sceneManager.SetSceneActive("test scene");
 }
 
-int main(int, char* [])
+int main(int argc, char* argv[])
 {
+	// A headless run without a frame count would never end
+	constexpr uint32_t headless_frames = 1000;
+
+	real::GameContext context{};
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string arg = argv[i];
+		if (arg == "--oit")
+			context.weightedBlendedOit = true;
+		else if (arg == "--anisotropy")
+			context.anisotropicFiltering = true;
+		else if (arg == "--profile")
+			context.profiling = true;
+		else if (arg == "--occlusion")
+			context.occlusionCulling = true;
+		else if (arg == "--threads")
+		{
+			const auto isCount = [](const std::string& value)
+				{
+					return value.empty() == false && std::ranges::all_of(value, [](unsigned char c) { return std::isdigit(c) != 0; });
+				};
+
+			// Without a count every core gets a recording thread, the next argument might be another flag
+			const uint32_t threads = i + 1 < argc && isCount(argv[i + 1])
+				? static_cast<uint32_t>(std::stoul(argv[++i]))
+				: std::thread::hardware_concurrency();
+
+			// The core count can be unknown, the recorder needs at least one worker
+			context.recordingThreads = std::max(threads, 1u);
+		}
+		else if (arg == "--headless")
+			context.headless = true;
+		else if (arg == "--frames" && i + 1 < argc)
+			context.frameCount = static_cast<uint32_t>(std::stoul(argv[++i]));
+		else if (arg == "--record" && i + 1 < argc)
+			context.recordPath = argv[++i];
+		else if (arg == "--benchmark" && i + 1 < argc)
+			context.replayPath = argv[++i];
+	}
+
+	// A replay ends on its own
+	if (context.headless && context.frameCount == 0 && context.replayPath.empty())
+		context.frameCount = headless_frames;
+
 #ifdef NDEBUG
 	try
 	{
-		real::RealEngine app;
+		real::RealEngine app{ context };
 		app.Run(Load);
 	}
 	catch (const std::exception& e)
@@ -53,7 +104,7 @@ int main(int, char* [])
 		return EXIT_FAILURE;
 	}
 #else
-	real::RealEngine app;
+	real::RealEngine app{ context };
 	app.Run(Load);
 #endif // NDEBUG
 